@@ -61,6 +61,56 @@ std::vector<uint> &ProteinLoader::getAllNeighbors()
  * LOADING PROTEIN
  */
 SimpleProtein* ProteinLoader::loadProtein(std::string fileName, std::map<std::string, uint> atomSymbolsMap)
+{
+    return loadProteins(std::vector<std::string>(1, fileName), atomSymbolsMap).at(0);
+}
+
+std::vector<SimpleProtein*> ProteinLoader::loadProteins(std::vector<std::string> fileNames, std::map<std::string, uint> atomSymbolsMap)
+{
+    /*
+     * concatenate full paths, pdb files are collected
+     * to pull their topologies from mdtraj back to back
+     */
+    std::string subfolder = "/molecules/";
+    std::vector<std::string> filePaths;
+    std::vector<std::string> pdbFilePaths;
+    for (int i = 0; i < fileNames.size(); i++)
+    {
+        filePaths.push_back(RESOURCES_PATH + subfolder + fileNames.at(i));
+        if (!ProteinSnapshot::isSnapshotFilepath(filePaths.back()))
+        {
+            pdbFilePaths.push_back(filePaths.back());
+        }
+    }
+    std::vector<MdTrajWrapper::TopologyTable> tables = MdTrajWrapper::instance().loadTopologyTables(pdbFilePaths);
+
+
+
+    /*
+     * load proteins from snapshot or topology, in order of the file names
+     */
+    std::vector<SimpleProtein*> proteins;
+    int tableIdx = 0;
+    for (int i = 0; i < fileNames.size(); i++)
+    {
+        SimpleProtein* protein = new SimpleProtein;
+        protein->name = extractProteinName(fileNames.at(i));
+        if (ProteinSnapshot::isSnapshotFilepath(filePaths.at(i)))
+        {
+            loadSnapshot(filePaths.at(i), *protein, atomSymbolsMap, protein->bbMin, protein->bbMax);
+        }
+        else
+        {
+            loadTopology(tables.at(tableIdx++), *protein, atomSymbolsMap, protein->bbMin, protein->bbMax);
+        }
+        m_proteins.push_back(protein);
+        proteins.push_back(protein);
+    }
+
+    return proteins;
+}
+
+std::string ProteinLoader::extractProteinName(std::string fileName)
 {
     /*
      * extracting protein name from file name
@@ -74,29 +124,23 @@ SimpleProtein* ProteinLoader::loadProtein(std::string fileName, std::map<std::st
     if (lastDot >= 0) {
         proteinName = proteinName.substr(0, lastDot);
     }
+    return proteinName;
+}
 
-
-
-    /*
-     * concatenate full path
-     */
-    std::string subfolder = "/molecules/";
-    std::string filePath = RESOURCES_PATH + subfolder + fileName;
-
-
-
+void ProteinLoader::loadPDB(std::string filePath, SimpleProtein &protein, std::map<std::string, uint> atomSymbolsMap, glm::vec3 &minPosition, glm::vec3 &maxPosition)
+{
     /*
-     * load protein from pdb file
+     * pull topology of pdb file from the shared mdtraj wrapper
      */
-    SimpleProtein* protein = new SimpleProtein;
-    protein->name = proteinName;
-    loadPDB(filePath, *protein, atomSymbolsMap, protein->bbMin, protein->bbMax);
-    m_proteins.push_back(protein);
-
-    return m_proteins.at(m_proteins.size()-1);
+    MdTrajWrapper::TopologyTable table;
+    if (!MdTrajWrapper::instance().loadTopologyTable(filePath, table))
+    {
+        Logger::instance().print("Could not load pdb " + filePath, Logger::Mode::ERROR);
+    }
+    loadTopology(table, protein, atomSymbolsMap, minPosition, maxPosition);
 }
 
-void ProteinLoader::loadPDB(std::string filePath, SimpleProtein &protein, std::map<std::string, uint> atomSymbolsMap, glm::vec3 &minPosition, glm::vec3 &maxPosition)
+void ProteinLoader::loadTopology(const MdTrajWrapper::TopologyTable &table, SimpleProtein &protein, std::map<std::string, uint> atomSymbolsMap, glm::vec3 &minPosition, glm::vec3 &maxPosition)
 {
 
     /*
@@ -108,236 +152,172 @@ void ProteinLoader::loadPDB(std::string filePath, SimpleProtein &protein, std::m
     maxPosition = glm::vec3(min, min, min);
     float maxRadius = 0;
 
-    /*
-     * the informations we need to create our atoms
-     */
-    std::vector<std::string> residueNames;
-    std::vector<std::string> elementNames;
-    std::vector<std::string> elementIds;
-    std::vector<glm::vec3> positions;
-    std::vector<float> radii;
-    std::vector<std::string> bonds;
-    std::map<std::string, uint> elementOrderMap;
-    std::map<std::string, std::vector<std::string> > elementNeighborsMap;
-
 
     /*
-     * init mdtraj wrapper and load pdb file as pyobject
+     * collect bond partners of each atom from the index pairs,
+     * both directions are added since bonds have no direction
      */
-    MdTrajWrapper mdTrajWrapper;
-    PyObject* pdbFile = mdTrajWrapper.loadFilePDB(filePath);
-
-
-    /*
-     * Atom positions
-     */
-    PyObject* xyz_py = mdTrajWrapper.getXYZ(pdbFile);
-    PyObject* topo = mdTrajWrapper.getTopology(pdbFile);
-    Py_DECREF(pdbFile);
-    PyArrayObject* xyz_pyarray = reinterpret_cast<PyArrayObject*>(xyz_py);
-
-    //get number of frames, atoms and components
-    long long numAtom{ PyArray_SHAPE(xyz_pyarray)[1] };
-    long long numComponents{ PyArray_SHAPE(xyz_pyarray)[2] };
-    int numAtoms = (int)numAtom;
-
-    // cast the 3D numpy array to a 1D c array
-    float* xyz_carray;
-    xyz_carray = reinterpret_cast<float*>(PyArray_DATA(xyz_pyarray));
-
-    float positionX;
-    float positionY;
-    float positionZ;
-
-    std::vector<glm::vec3> frameHolder;
-    for (int a = 0; a < numAtoms; a++)
+    int numAtoms = table.frameCount > 0 ? (int)table.names.size() : 0;
+    std::vector<std::vector<uint> > atomNeighbors(numAtoms);
+    for (const auto &bond : table.bonds)
     {
-        int id = a * numComponents;
-        positionX = xyz_carray[id] * 10;
-        positionY = xyz_carray[id + 1] * 10;
-        positionZ = xyz_carray[id + 2] * 10;
-        glm::vec3 position(positionX, positionY, positionZ);
-        positions.push_back(position);
-
-        /*
-         * get min and max
-         */
-        minPosition.x = (positionX < minPosition.x) ? positionX : minPosition.x;
-        minPosition.y = (positionY < minPosition.y) ? positionY : minPosition.y;
-        minPosition.z = (positionZ < minPosition.z) ? positionZ : minPosition.z;
-
-        maxPosition.x = (positionX > maxPosition.x) ? positionX : maxPosition.x;
-        maxPosition.y = (positionY > maxPosition.y) ? positionY : maxPosition.y;
-        maxPosition.z = (positionZ > maxPosition.z) ? positionZ : maxPosition.z;
+        atomNeighbors.at(bond.first).push_back(bond.second);
+        atomNeighbors.at(bond.second).push_back(bond.first);
     }
-    Py_DECREF(xyz_py);
 
 
     /*
-     * Atom properties
+     * Create atoms from first frame and add them to the protein
+     * and to the allAtoms vector
      */
-    PyObject* atom_py = PyObject_GetAttrString(topo, "atoms");
-    PyObject* atom_iterator_py = PyObject_GetIter(atom_py);
-    Py_DECREF(atom_py);
-
-    PyObject* atom;
-    PyObject* residue_py;
-    PyObject* residue_name_py;
-    PyObject* element_py;
-    PyObject* element_name_py;
-    PyObject* element_specific_name_py;
-    PyObject* atom_radius_py;
-
-    atom = PyIter_Next(atom_iterator_py);
-    while ((atom != NULL))
+    uint atomsVectorStart = m_allAtoms.size();
+    for (int i = 0; i < numAtoms; i++)
     {
-        residue_py = PyObject_GetAttrString(atom, "residue");
-        residue_name_py = PyObject_Str(residue_py);
-        element_py = PyObject_GetAttrString(atom, "element");
-        element_name_py = PyObject_GetAttrString(element_py, "symbol");
-        element_specific_name_py = PyObject_GetAttrString(atom, "name");
-        atom_radius_py = PyObject_GetAttrString(element_py, "radius");
-
-        elementNames.push_back(PyUnicode_AsUTF8(element_name_py));
-        std::string residueName = PyUnicode_AsUTF8(residue_name_py);
-        std::string elementSpecificName = PyUnicode_AsUTF8(element_specific_name_py);
-        std::string elementId = residueName + "-" + elementSpecificName;
-        elementIds.push_back(elementId);
-        residueNames.push_back(residueName);
-        double radius = PyFloat_AsDouble(atom_radius_py) * 10;
-        radii.push_back(radius);
+        // check if element symbol is in map
+        std::string elementName = table.elementSymbols.at(i);
+        std::transform(elementName.begin(), elementName.end(), elementName.begin(), ::tolower); // turn element symbol to lowercase
+        if (atomSymbolsMap.find(elementName) == atomSymbolsMap.end())
+        {
+            Logger::instance().print("Could not found element " + elementName + " in map!", Logger::Mode::ERROR);
+        }
 
         /*
-         * find the atom with the biggest radius
+         * create atom
          */
-        maxRadius = std::max((float)radius, maxRadius);
+        SimpleAtom atom;
+        atom.pos = table.positions.at(i);
+        atom.radius = table.radii.at(i);
+        atom.charge = glm::vec4(0.0,0.0,0.0,0.0);
+        atom.atomSymbolIndex = atomSymbolsMap[elementName]+1;                   // +1 because the first atom should start with 1
+        atom.proteinID = m_currentProteinIdx;
 
         /*
-         * create map between element id and element position
+         * get all neighbors
+         * atomsVectorStart is necessary if this is not the first protein that is
+         * going to be importet, so that the right atom positions within the
+         * allAtoms vector are referenced.
          */
-        elementOrderMap[elementId] = elementIds.size()-1;
+        atom.bondNeighborsStart = m_allNeighbors.size();
+        atom.bondNeighborsSize = atomNeighbors.at(i).size();
+        for (int j = 0; j < atomNeighbors.at(i).size(); j++)
+        {
+            m_allNeighbors.push_back(atomsVectorStart + atomNeighbors.at(i).at(j));
+        }
+        if (atomNeighbors.at(i).empty())
+        {
+            Logger::instance().print(table.distinctResidueNames.at(i) + "-" + table.names.at(i) + " has no bonds!");
+        }
 
-        Py_DECREF(residue_name_py);
-        Py_DECREF(element_py);
-        Py_DECREF(element_name_py);
-        Py_DECREF(element_specific_name_py);
-        Py_DECREF(atom_radius_py);
+        /*
+         * add atom to both protein and all atoms
+         */
+        protein.atoms.push_back(atom);
+        m_allAtoms.push_back(atom);
 
-        atom = PyIter_Next(atom_iterator_py);
+        /*
+         * get min and max
+         */
+        minPosition = glm::min(minPosition, atom.pos);
+        maxPosition = glm::max(maxPosition, atom.pos);
+        maxRadius = std::max(atom.radius, maxRadius);
     }
-    Py_DECREF(atom_iterator_py);
 
 
     /*
-     * atom bonds
+     * extent the bounding box by the radius of the biggest atom
      */
-    PyObject* bonds_py = PyObject_GetAttrString(topo, "bonds");
-    Py_DECREF(topo);
-    PyObject* bonds_iterator_py = PyObject_GetIter(bonds_py);
+    minPosition -= maxRadius;
+    maxPosition += maxRadius;
 
-    PyObject* bond;
 
-    bond = PyIter_Next(bonds_iterator_py);
-    while ((bond != NULL))
+    /*
+     * increment protein idx
+     */
+    m_currentProteinIdx++;
+}
+
+void ProteinLoader::loadSnapshot(std::string filePath, SimpleProtein &protein, std::map<std::string, uint> atomSymbolsMap, glm::vec3 &minPosition, glm::vec3 &maxPosition)
+{
+    /*
+     * read snapshot, nothing is parsed
+     */
+    std::unique_ptr<Protein> upSnapshotProtein = ProteinSnapshot::read(filePath);
+    if (!upSnapshotProtein || upSnapshotProtein->getTrajectory()->getFrameCount() == 0)
     {
-        PyObject* bondfi = PyObject_Str(bond);
-        bonds.push_back(PyUnicode_AsUTF8(bondfi));
-        Py_DECREF(bondfi);
-        bond = PyIter_Next(bonds_iterator_py);
+        Logger::instance().print("Could not read snapshot " + filePath, Logger::Mode::ERROR);
+        return;
+    }
 
-        /*
-         * insert Bond into map
-         * both combinations need to be added
-         * since bonds have no direction
-         */
-        std::vector<std::string> tokens;
-        tokenize(tokens, bonds.at(bonds.size()-1), "\\(|\\)|,\\s");
-        if (elementNeighborsMap.find(tokens.at(1)) == elementNeighborsMap.end()) {
-            elementNeighborsMap[tokens.at(1)] = std::vector<std::string>();
-        }
-        elementNeighborsMap.at(tokens.at(1)).push_back(tokens.at(2));
-        if (elementNeighborsMap.find(tokens.at(2)) == elementNeighborsMap.end()) {
-            elementNeighborsMap[tokens.at(2)] = std::vector<std::string>();
-        }
-        elementNeighborsMap.at(tokens.at(2)).push_back(tokens.at(1));
+
+    /*
+     * snapshot holds element names, map them back to lower case symbols
+     * (deuterium is skipped, it shares its name with hydrogen)
+     */
+    std::map<std::string, std::string> elementSymbols;
+    for (const auto &symbolAndName : AtomLUT::element_names)
+    {
+        if (symbolAndName.first == "D") continue;
+        std::string symbol = symbolAndName.first;
+        std::transform(symbol.begin(), symbol.end(), symbol.begin(), ::tolower);
+        elementSymbols[symbolAndName.second] = symbol;
     }
-    Py_DECREF(bonds_iterator_py);
 
 
     /*
-     * extent the bounding box by the radius of the biggest atom
+     * set start values of min and max position
      */
-    minPosition -= maxRadius;
-    maxPosition += maxRadius;
+    double min = std::numeric_limits<double>::min();
+    double max = std::numeric_limits<double>::max();
+    minPosition = glm::vec3(max, max, max);
+    maxPosition = glm::vec3(min, min, min);
+    float maxRadius = 0;
 
 
     /*
-     * Create atoms and add them to the protein
-     * and to the allAtoms vector
+     * Create atoms from first frame and add them to the protein
+     * and to the allAtoms vector, bonds are taken from the bond graph
      */
-    if ((positions.size() == residueNames.size()) && (positions.size() == elementNames.size()) && (positions.size() == radii.size()))
+    Trajectory::FrameSpan positions = upSnapshotProtein->getTrajectory()->getFrame(0);
+    uint atomsVectorStart = m_allAtoms.size();
+    for (int i = 0; i < positions.size(); i++)
     {
-        uint atomsVectorStart = m_allAtoms.size();
-        for (int i = 0; i < residueNames.size(); i++)
+        std::string elementName = elementSymbols[upSnapshotProtein->getAtomAt(i)->getElement()];
+        if (atomSymbolsMap.find(elementName) == atomSymbolsMap.end())
         {
-            std::string elementName = elementNames.at(i);
-            glm::vec3 position = positions.at(i);
-            float radius = radii.at(i);
-
-            // check if residueName is in map
-            std::transform(elementName.begin(), elementName.end(), elementName.begin(), ::tolower); // turn element residueName to lowercase
-            if (atomSymbolsMap.find(elementName) == atomSymbolsMap.end())
-            {
-                Logger::instance().print("Could not found element " + elementName + " in map!", Logger::Mode::ERROR);
-            }
-
-            /*
-             * create atom
-             */
-            SimpleAtom atom;
-            atom.pos = position;
-            atom.radius = radius;
-            atom.charge = glm::vec4(0.0,0.0,0.0,0.0);
-            atom.atomSymbolIndex = atomSymbolsMap[elementName]+1;                   // +1 because the first atom should start with 1
-            atom.proteinID = m_currentProteinIdx;
-            //std::cout << elementName << ": " << atom.atomSymbolIndex << std::endl;
-
-            /*
-             * get all neighbors
-             */
-            std::string elementId = elementIds.at(i);
-            atom.bondNeighborsStart = m_allNeighbors.size();
-            if (elementNeighborsMap.find(elementId) != elementNeighborsMap.end())
-            {
-                std::vector<std::string> neighborIds = elementNeighborsMap.at(elementId);
-                atom.bondNeighborsSize = neighborIds.size();
-                for (int i = 0; i < neighborIds.size(); i++)
-                {
-                    /*
-                     * atomsVectorStart is necessary if this is not the first protein that is
-                     * going to be importet, so that the right atom positions within the
-                     * allAtoms vector are referenced.
-                     */
-                    m_allNeighbors.push_back(atomsVectorStart + elementOrderMap.at(neighborIds.at(i)));
-                }
-            }
-            else
-            {
-                atom.bondNeighborsSize = 0;
-                Logger::instance().print(elementId + " has no bonds!");
-            }
-
-            /*
-             * add atom to both protein and all atoms
-             */
-            protein.atoms.push_back(atom);
-            m_allAtoms.push_back(atom);
+            Logger::instance().print("Could not found element " + elementName + " in map!", Logger::Mode::ERROR);
         }
-    } else {
-        std::cerr << "Size of atom positions " << positions.size() << " and properties " << residueNames.size() << ", " << elementNames.size() << ", " << radii.size() << " dont match" << std::endl;
+
+        SimpleAtom atom;
+        atom.pos = positions[i];
+        atom.radius = upSnapshotProtein->getRadiusAt(i);
+        atom.charge = glm::vec4(0.0,0.0,0.0,0.0);
+        atom.atomSymbolIndex = atomSymbolsMap[elementName]+1;                   // +1 because the first atom should start with 1
+        atom.proteinID = m_currentProteinIdx;
+        atom.bondNeighborsStart = m_allNeighbors.size();
+        atom.bondNeighborsSize = upSnapshotProtein->getBondPartnerCount(i);
+        for (int j = 0; j < upSnapshotProtein->getBondPartnerCount(i); j++)
+        {
+            m_allNeighbors.push_back(atomsVectorStart + upSnapshotProtein->getBondPartnerAt(i, j));
+        }
+        protein.atoms.push_back(atom);
+        m_allAtoms.push_back(atom);
+
+        /*
+         * get min and max
+         */
+        minPosition = glm::min(minPosition, atom.pos);
+        maxPosition = glm::max(maxPosition, atom.pos);
+        maxRadius = std::max(atom.radius, maxRadius);
     }
 
 
+    /*
+     * extent the bounding box by the radius of the biggest atom
+     */
+    minPosition -= maxRadius;
+    maxPosition += maxRadius;
+
+
     /*
      * increment protein idx
      */
@@ -16,6 +16,8 @@
 
 // framework includes
 #include "Molecule/MDtrajLoader/MdTraj/MdTrajWrapper.h"
+#include "Molecule/NativeLoader/ProteinSnapshot.h"
+#include "Molecule/MDtrajLoader/Data/AtomLUT.h"
 #include "Utils/Logger.h"
 
 // project specific includes
@@ -46,8 +48,13 @@ public:
     //             METHODS                 //
     //_____________________________________//
     SimpleProtein* loadProtein(std::string fileName, std::map<std::string, uint> atomSymbolsMap);
+    std::vector<SimpleProtein*> loadProteins(std::vector<std::string> fileNames, std::map<std::string, uint> atomSymbolsMap);
     void loadPDB(std::string filePath, SimpleProtein &protein, std::map<std::string, uint> atomSymbolsMap, glm::vec3 &minPosition, glm::vec3 &maxPosition);
+    void loadSnapshot(std::string filePath, SimpleProtein &protein, std::map<std::string, uint> atomSymbolsMap, glm::vec3 &minPosition, glm::vec3 &maxPosition);
 private:
+    std::string extractProteinName(std::string fileName);
+    void loadTopology(const MdTrajWrapper::TopologyTable &table, SimpleProtein &protein, std::map<std::string, uint> atomSymbolsMap, glm::vec3 &minPosition, glm::vec3 &maxPosition);
+
     std::vector<SimpleProtein*> m_proteins;
     std::vector<SimpleAtom> m_allAtoms;
     std::vector<uint> m_allNeighbors;
@@ -1112,11 +1112,12 @@ int main()
     }
 
     /*
-     * load proteins
+     * load proteins back to back
      */
-    SimpleProtein* proteinA = m_proteinLoader.loadProtein("PDB/3ah8 protein.pdb", amberForceFieldParameter.getAtomSymbolsMap());
+    std::vector<SimpleProtein*> proteins = m_proteinLoader.loadProteins({"PDB/3ah8 protein.pdb", "PDB/3ah8 ligand.pdb"}, amberForceFieldParameter.getAtomSymbolsMap());
+    SimpleProtein* proteinA = proteins.at(0);
     m_proteinColors.push_back(glm::vec4(0.8, 0.0, 0.4, 1.0));
-    SimpleProtein* proteinB = m_proteinLoader.loadProtein("PDB/3ah8 ligand.pdb", amberForceFieldParameter.getAtomSymbolsMap());
+    SimpleProtein* proteinB = proteins.at(1);
     m_proteinColors.push_back(glm::vec4(0.0, 0.2, 8.0, 1.0));
 
     proteinA->center();
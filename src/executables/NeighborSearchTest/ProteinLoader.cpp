@@ -56,6 +56,50 @@ int ProteinLoader::getNumberOfAllAtoms()
  * LOADING PROTEIN
  */
 SimpleProtein* ProteinLoader::loadProtein(std::string fileName)
+{
+    return loadProteins(std::vector<std::string>(1, fileName)).at(0);
+}
+
+std::vector<SimpleProtein*> ProteinLoader::loadProteins(std::vector<std::string> fileNames)
+{
+    /*
+     * concatenate full paths, pdb files are collected
+     * to pull their topologies from mdtraj back to back
+     */
+    std::string subfolder = "/molecules/";
+    std::vector<std::string> filePaths;
+    std::vector<std::string> pdbFilePaths;
+    for (int i = 0; i < fileNames.size(); i++) {
+        filePaths.push_back(RESOURCES_PATH + subfolder + fileNames.at(i));
+        if (!ProteinSnapshot::isSnapshotFilepath(filePaths.back())) {
+            pdbFilePaths.push_back(filePaths.back());
+        }
+    }
+    std::vector<MdTrajWrapper::TopologyTable> tables = MdTrajWrapper::instance().loadTopologyTables(pdbFilePaths);
+
+
+
+    /*
+     * load proteins from snapshot or topology, in order of the file names
+     */
+    std::vector<SimpleProtein*> proteins;
+    int tableIdx = 0;
+    for (int i = 0; i < fileNames.size(); i++) {
+        SimpleProtein* protein = new SimpleProtein;
+        protein->name = extractProteinName(fileNames.at(i));
+        if (ProteinSnapshot::isSnapshotFilepath(filePaths.at(i))) {
+            loadSnapshot(filePaths.at(i), *protein, protein->bbMin, protein->bbMax);
+        } else {
+            loadTopology(tables.at(tableIdx++), *protein, protein->bbMin, protein->bbMax);
+        }
+        m_proteins.push_back(protein);
+        proteins.push_back(protein);
+    }
+
+    return proteins;
+}
+
+std::string ProteinLoader::extractProteinName(std::string fileName)
 {
     /*
      * extracting protein name from file name
@@ -69,29 +113,22 @@ SimpleProtein* ProteinLoader::loadProtein(std::string fileName)
     if (lastDot >= 0) {
         proteinName = proteinName.substr(0, lastDot);
     }
+    return proteinName;
+}
 
-
-
-    /*
-     * concatenate full path
-     */
-    std::string subfolder = "/molecules/";
-    std::string filePath = RESOURCES_PATH + subfolder + fileName;
-
-
-
+void ProteinLoader::loadPDB(std::string filePath, SimpleProtein &protein, glm::vec3 &minPosition, glm::vec3 &maxPosition)
+{
     /*
-     * load protein from pdb file
+     * pull topology of pdb file from the shared mdtraj wrapper
      */
-    SimpleProtein* protein = new SimpleProtein;
-    protein->name = proteinName;
-    loadPDB(filePath, *protein, protein->bbMin, protein->bbMax);
-    m_proteins.push_back(protein);
-
-    return m_proteins.at(m_proteins.size()-1);
+    MdTrajWrapper::TopologyTable table;
+    if (!MdTrajWrapper::instance().loadTopologyTable(filePath, table)) {
+        Logger::instance().print("Could not load pdb " + filePath, Logger::Mode::ERROR);
+    }
+    loadTopology(table, protein, minPosition, maxPosition);
 }
 
-void ProteinLoader::loadPDB(std::string filePath, SimpleProtein &protein, glm::vec3 &minPosition, glm::vec3 &maxPosition)
+void ProteinLoader::loadTopology(const MdTrajWrapper::TopologyTable &table, SimpleProtein &protein, glm::vec3 &minPosition, glm::vec3 &maxPosition)
 {
 
     /*
@@ -103,105 +140,84 @@ void ProteinLoader::loadPDB(std::string filePath, SimpleProtein &protein, glm::v
     maxPosition = glm::vec3(min, min, min);
     float maxRadius = 0;
 
+
     /*
-     * the informations we need to create our atoms
+     * Create atoms from first frame and add them to the protein
+     * and to the allAtoms vector
      */
-    std::vector<std::string> names;
-    std::vector<std::string> elementNames;
-    std::vector<glm::vec3> positions;
-    std::vector<float> radii;
+    int numAtoms = table.frameCount > 0 ? (int)table.names.size() : 0;
+    for (int i = 0; i < numAtoms; i++) {
+        SimpleAtom atom;
+        atom.pos = table.positions.at(i);
+        atom.radius = table.radii.at(i);
+        atom.proteinID = glm::vec4(m_currentProteinIdx, m_currentProteinIdx, m_currentProteinIdx, m_currentProteinIdx);
+        protein.atoms.push_back(atom);
+        m_allAtoms.push_back(atom);
+
+        /*
+         * get min and max
+         */
+        minPosition = glm::min(minPosition, atom.pos);
+        maxPosition = glm::max(maxPosition, atom.pos);
+        maxRadius = std::max(atom.radius, maxRadius);
+    }
 
 
     /*
-     * init mdtraj wrapper and load pdb file as pyobject
+     * extent the bounding box by the radius of the biggest atom
      */
-    MdTrajWrapper mdTrajWrapper;
-    PyObject* pdbFile = mdTrajWrapper.loadFilePDB(filePath);
+    minPosition -= maxRadius;
+    maxPosition += maxRadius;
 
 
     /*
-     * Atom positions
+     * increment protein idx
      */
-    PyObject* xyz_py = mdTrajWrapper.getXYZ(pdbFile);
-    PyObject* topo = mdTrajWrapper.getTopology(pdbFile);
-    Py_DECREF(pdbFile);
-    PyArrayObject* xyz_pyarray = reinterpret_cast<PyArrayObject*>(xyz_py);
-
-    //get number of frames, atoms and components
-    long long numAtom{ PyArray_SHAPE(xyz_pyarray)[1] };
-    long long numComponents{ PyArray_SHAPE(xyz_pyarray)[2] };
-    int numAtoms = (int)numAtom;
-
-    // cast the 3D numpy array to a 1D c array
-    float* xyz_carray;
-    xyz_carray = reinterpret_cast<float*>(PyArray_DATA(xyz_pyarray));
-
-    float positionX;
-    float positionY;
-    float positionZ;
-
-    std::vector<glm::vec3> frameHolder;
-    for (int a = 0; a < numAtoms; a++)
-    {
-        int id = a * numComponents;
-        positionX = xyz_carray[id] * 10;
-        positionY = xyz_carray[id + 1] * 10;
-        positionZ = xyz_carray[id + 2] * 10;
-        glm::vec3 position(positionX, positionY, positionZ);
-        positions.push_back(position);
-
-        /*
-         * get min and max
-         */
-        minPosition.x = (positionX < minPosition.x) ? positionX : minPosition.x;
-        minPosition.y = (positionY < minPosition.y) ? positionY : minPosition.y;
-        minPosition.z = (positionZ < minPosition.z) ? positionZ : minPosition.z;
+    m_currentProteinIdx++;
+}
 
-        maxPosition.x = (positionX > maxPosition.x) ? positionX : maxPosition.x;
-        maxPosition.y = (positionY > maxPosition.y) ? positionY : maxPosition.y;
-        maxPosition.z = (positionZ > maxPosition.z) ? positionZ : maxPosition.z;
+void ProteinLoader::loadSnapshot(std::string filePath, SimpleProtein &protein, glm::vec3 &minPosition, glm::vec3 &maxPosition)
+{
+    /*
+     * read snapshot, nothing is parsed
+     */
+    std::unique_ptr<Protein> upSnapshotProtein = ProteinSnapshot::read(filePath);
+    if (!upSnapshotProtein || upSnapshotProtein->getTrajectory()->getFrameCount() == 0) {
+        Logger::instance().print("Could not read snapshot " + filePath, Logger::Mode::ERROR);
+        return;
     }
-    Py_DECREF(xyz_py);
 
 
     /*
-     * Atom properties
+     * set start values of min and max position
      */
-    PyObject* atom_py = PyObject_GetAttrString(topo, "atoms");
-    PyObject* atom_iterator_py = PyObject_GetIter(atom_py);
-    Py_DECREF(atom_py);
-
-    PyObject* atom;
-    PyObject* name_py;
-    PyObject* element_py;
-    PyObject* element_name_py;
-    PyObject* atom_radius_py;
-
-    atom = PyIter_Next(atom_iterator_py);
-    while ((atom != NULL)) {
-        name_py = PyObject_GetAttrString(atom, "name");
-        element_py = PyObject_GetAttrString(atom, "element");
-        element_name_py = PyObject_GetAttrString(element_py, "name");
-        atom_radius_py = PyObject_GetAttrString(element_py, "radius");
-
-        names.push_back(PyUnicode_AsUTF8(name_py));
-        elementNames.push_back(PyUnicode_AsUTF8(element_name_py));
-        double radius = PyFloat_AsDouble(atom_radius_py) * 10;
-        radii.push_back(radius);
+    double min = std::numeric_limits<double>::min();
+    double max = std::numeric_limits<double>::max();
+    minPosition = glm::vec3(max, max, max);
+    maxPosition = glm::vec3(min, min, min);
+    float maxRadius = 0;
 
-        /*
-         * find the atom with the biggest radius
-         */
-        maxRadius = std::max((float)radius, maxRadius);
 
-        Py_DECREF(name_py);
-        Py_DECREF(element_py);
-        Py_DECREF(element_name_py);
-        Py_DECREF(atom_radius_py);
+    /*
+     * Create atoms from first frame and add them to the protein
+     * and to the allAtoms vector
+     */
+    Trajectory::FrameSpan positions = upSnapshotProtein->getTrajectory()->getFrame(0);
+    for (int i = 0; i < positions.size(); i++) {
+        SimpleAtom atom;
+        atom.pos = positions[i];
+        atom.radius = upSnapshotProtein->getRadiusAt(i);
+        atom.proteinID = glm::vec4(m_currentProteinIdx, m_currentProteinIdx, m_currentProteinIdx, m_currentProteinIdx);
+        protein.atoms.push_back(atom);
+        m_allAtoms.push_back(atom);
 
-        atom = PyIter_Next(atom_iterator_py);
+        /*
+         * get min and max
+         */
+        minPosition = glm::min(minPosition, atom.pos);
+        maxPosition = glm::max(maxPosition, atom.pos);
+        maxRadius = std::max(atom.radius, maxRadius);
     }
-    Py_DECREF(atom_iterator_py);
 
 
     /*
@@ -211,36 +227,6 @@ void ProteinLoader::loadPDB(std::string filePath, SimpleProtein &protein, glm::v
     maxPosition += maxRadius;
 
 
-    /*
-     * Create atoms and add them to the protein
-     * and to the allAtoms vector
-     */
-    if ((positions.size() == names.size()) && (positions.size() == elementNames.size()) && (positions.size() == radii.size())) {
-        for (int i = 0; i < names.size(); i++) {
-            std::string name = names.at(i);
-            std::string elementName = elementNames.at(i);
-            glm::vec3 position = positions.at(i);
-            float radius = radii.at(i);
-
-            /*
-             * create atom
-             */
-            SimpleAtom atom;
-            atom.pos = position;
-            atom.radius = radius;
-            atom.proteinID = glm::vec4(m_currentProteinIdx, m_currentProteinIdx, m_currentProteinIdx, m_currentProteinIdx);
-
-            /*
-             * add atom to both protein and all atoms
-             */
-            protein.atoms.push_back(atom);
-            m_allAtoms.push_back(atom);
-        }
-    } else {
-        std::cerr << "Size of atom positions " << positions.size() << " and properties " << names.size() << ", " << elementNames.size() << ", " << radii.size() << " dont match" << std::endl;
-    }
-
-
     /*
      * increment protein idx
      */
@@ -13,6 +13,7 @@
 
 // framework includes
 #include "Molecule/MDtrajLoader/MdTraj/MdTrajWrapper.h"
+#include "Molecule/NativeLoader/ProteinSnapshot.h"
 #include "Utils/Logger.h"
 
 // project specific includes
@@ -42,8 +43,13 @@ public:
     //             METHODS                 //
     //_____________________________________//
     SimpleProtein* loadProtein(std::string fileName);
+    std::vector<SimpleProtein*> loadProteins(std::vector<std::string> fileNames);
     void loadPDB(std::string filePath, SimpleProtein &protein, glm::vec3 &minPosition, glm::vec3 &maxPosition);
+    void loadSnapshot(std::string filePath, SimpleProtein &protein, glm::vec3 &minPosition, glm::vec3 &maxPosition);
 private:
+    std::string extractProteinName(std::string fileName);
+    void loadTopology(const MdTrajWrapper::TopologyTable &table, SimpleProtein &protein, glm::vec3 &minPosition, glm::vec3 &maxPosition);
+
     std::vector<SimpleProtein*> m_proteins;
     std::vector<SimpleAtom> m_allAtoms;
     float m_currentProteinIdx;
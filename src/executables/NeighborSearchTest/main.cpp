@@ -20,6 +20,8 @@
 #include "ProteinLoader.h"
 #include "Utils/OrbitCamera.h"
 #include "NeighborSearch/NeighborhoodSearch.h"
+#include "NeighborSearch/HashedNeighborhoodSearch.h"
+#include "NeighborSearch/VerletList.h"
 
 
 
@@ -31,6 +33,7 @@
  */
 #define WIDTH 1280
 #define HEIGHT 720
+#define VERLET_SKIN 0.5f
 
 
 
@@ -93,10 +96,24 @@ GLuint m_atomsSSBO;
 GLuint* m_positionsSSBO;
 GLuint* m_searchResultsSSBO;
 
+// sparse hashed grid on the cpu for comparison
+HashedNeighborhoodSearch m_hashedSearch;
+static bool         m_runHashedSearch = false;
+int                 m_hashedSelectedNeighbors = 0;
+
+// verlet lists over the dense grid on the cpu, checked against the gpu
+VerletList          m_verletList;
+static bool         m_runVerletList = false;
+int                 m_verletSelectedNeighbors = 0;
+int                 m_gpuSelectedNeighbors = 0;
+int                 m_verletMismatches = 0;
+
 
 // time
 Timer m_runTimer;
 Timer m_applicationTimer;
+Timer m_hashedTimer;
+Timer m_verletTimer;
 
 
 // for debug
@@ -132,6 +149,7 @@ void drawSearchRadius(ShaderProgram searchRadiusProgram);
 void findNeighbors(Neighborhood& neighborhood);
 void findSelectedAtomsNeighbors(Neighborhood& neighborhood, int selectedAtomIdx);
 void colorAtomsInRadius(Neighborhood& neighborhood);
+void compareVerletListWithGPU();
 
 void fillPickingTexture(ShaderProgram pickingProgram);
 void updateGUI();
@@ -427,6 +445,8 @@ void initNeighborhoodSearch(glm::vec3 gridResolution, float searchRadius)
     m_proteinLoader.getCenteredBoundingBoxAroundProteins(min, max);
 
     m_search.init(m_proteinLoader.getNumberOfAllAtoms(), min, max, gridResolution, searchRadius);
+    m_hashedSearch.init(m_proteinLoader.getNumberOfAllAtoms(), searchRadius);
+    m_verletList.init(m_proteinLoader.getNumberOfAllAtoms(), min, max, gridResolution, searchRadius, VERLET_SKIN);
 }
 
 
@@ -546,10 +566,33 @@ void run()
             m_proteinLoader.getCenteredBoundingBoxAroundProteins(min, max);
 
             m_search.update(m_proteinLoader.getNumberOfAllAtoms(), min, max, m_gridRes, m_searchRadius);
+            m_hashedSearch.update(m_proteinLoader.getNumberOfAllAtoms(), m_searchRadius);
+            m_verletList.update(m_proteinLoader.getNumberOfAllAtoms(), min, max, m_gridRes, m_searchRadius, VERLET_SKIN);
 
             setupLinesBuffer();
         }
 
+        /*
+         * sparse hashed grid on the cpu, only storing occupied cells
+         */
+        if (m_runHashedSearch) {
+            std::vector<SimpleAtom> atoms = m_proteinLoader.getAllAtoms();
+            std::vector<glm::vec3> positions(atoms.size());
+            for (int i = 0; i < atoms.size(); i++) {
+                positions[i] = atoms[i].pos;
+            }
+            CPUNeighborhood hashedNeighborhood;
+            m_hashedTimer.start();
+            m_hashedSearch.run(positions.data(), hashedNeighborhood);
+            m_hashedTimer.stop();
+
+            std::vector<uint> neighbors;
+            if (m_selectedAtom >= 0) {
+                m_hashedSearch.findNeighbors(m_selectedAtom, neighbors);
+            }
+            m_hashedSelectedNeighbors = (int)neighbors.size();
+        }
+
         /*
          * setup neighborhood search
          */
@@ -564,6 +607,13 @@ void run()
         findNeighbors(neighborhood);
         m_applicationTimer.stop();
 
+        /*
+         * verlet lists on the cpu, compared with the neighbors found on the gpu
+         */
+        if (m_runVerletList) {
+            compareVerletListWithGPU();
+        }
+
         /*
          * draw proteins as impostor
          */
@@ -848,6 +898,54 @@ void colorAtomsInRadius(Neighborhood& neighborhood)
 
 
 
+void compareVerletListWithGPU()
+{
+    std::vector<SimpleAtom> atoms = m_proteinLoader.getAllAtoms();
+    std::vector<glm::vec3> positions(atoms.size());
+    for (int i = 0; i < atoms.size(); i++) {
+        positions[i] = atoms[i].pos;
+    }
+    m_verletTimer.start();
+    m_verletList.run(positions.data());
+    m_verletTimer.stop();
+
+    /*
+     * the gpu only reports the neighbors of the selected atom
+     */
+    m_verletSelectedNeighbors = 0;
+    m_gpuSelectedNeighbors = 0;
+    m_verletMismatches = 0;
+    if (!m_findOnlySelectedAtomsNeighbors || m_selectedAtom < 0) return;
+
+    /*
+     * candidates of the list within the cutoff, with the same comparison as the gpu
+     */
+    std::vector<bool> isVerletNeighbor(atoms.size(), false);
+    const uint* neighbors = m_verletList.getNeighbors(m_selectedAtom);
+    float radius2 = m_verletList.getCutoff() * m_verletList.getCutoff();
+    for (uint n = 0; n < m_verletList.getNumberOfNeighbors(m_selectedAtom); n++) {
+        uint j = neighbors[n];
+        glm::vec3 d = positions[j] - positions[m_selectedAtom];
+        if (d.x*d.x + d.y*d.y + d.z*d.z < radius2) {
+            isVerletNeighbor[j] = true;
+            m_verletSelectedNeighbors++;
+        }
+    }
+
+    /*
+     * the gpu marks neighbors of other proteins with 1 and of the same protein with 4
+     */
+    int* searchResults = GPUHandler::getDataFromSSBO<int>(m_searchResultsSSBO, atoms.size());
+    for (int i = 0; i < atoms.size(); i++) {
+        bool isGPUNeighbor = searchResults[i] == 1 || searchResults[i] == 4;
+        if (isGPUNeighbor) m_gpuSelectedNeighbors++;
+        if (isGPUNeighbor != isVerletNeighbor[i]) m_verletMismatches++;
+    }
+    delete[] searchResults;
+}
+
+
+
 void fillPickingTexture(ShaderProgram pickingProgram)
 {
     m_pickingTexture.EnableWriting();
@@ -1006,6 +1104,36 @@ void updateGUI()
             ImGui::Text(setupTimeText.c_str());
             ImGui::Text(searchTimeText.c_str());
             ImGui::Checkbox("Find only neighbors of selected atom", &m_findOnlySelectedAtomsNeighbors);
+            ImGui::Separator();
+            ImGui::Checkbox("Run sparse hashed grid on CPU", &m_runHashedSearch);
+            if (m_runHashedSearch) {
+                std::string hashedCellsText = "Occupied cells: " + std::to_string(m_hashedSearch.getNumberOfOccupiedCells())
+                                              + " (dense grid: " + std::to_string(m_search.getTotalGridNum()) + ")";
+                std::string hashedCellSizeText = "Cellsize: " + std::to_string(m_hashedSearch.getCellSize());
+                std::string hashedTimeText = "Setup time: " + std::to_string(m_hashedTimer.getDuration()/1000.0) + " ms";
+                std::string hashedNeighborsText = "Neighbors of selected atom: " + std::to_string(m_hashedSelectedNeighbors);
+                ImGui::Text(hashedCellsText.c_str());
+                ImGui::Text(hashedCellSizeText.c_str());
+                ImGui::Text(hashedTimeText.c_str());
+                ImGui::Text(hashedNeighborsText.c_str());
+            }
+            ImGui::Separator();
+            ImGui::Checkbox("Run verlet list on CPU", &m_runVerletList);
+            if (m_runVerletList) {
+                std::string verletBuildsText = "Builds: " + std::to_string(m_verletList.getNumberOfBuilds());
+                std::string verletTimeText = "Update time: " + std::to_string(m_verletTimer.getDuration()/1000.0) + " ms";
+                ImGui::Text(verletBuildsText.c_str());
+                ImGui::Text(verletTimeText.c_str());
+                if (m_findOnlySelectedAtomsNeighbors && m_selectedAtom >= 0) {
+                    std::string verletNeighborsText = "Neighbors of selected atom: " + std::to_string(m_verletSelectedNeighbors)
+                                                      + " (GPU: " + std::to_string(m_gpuSelectedNeighbors) + ")";
+                    std::string verletMismatchesText = "Mismatches with GPU: " + std::to_string(m_verletMismatches);
+                    ImGui::Text(verletNeighborsText.c_str());
+                    ImGui::Text(verletMismatchesText.c_str());
+                } else {
+                    ImGui::Text("Select an atom and find only its neighbors to compare with GPU");
+                }
+            }
 
             ImGui::EndMenu();
         }
@@ -1049,10 +1177,11 @@ int main()
     retrieveGPUInfos();
 
     /*
-     * load proteins
+     * load proteins back to back
      */
-    SimpleProtein* proteinA = m_proteinLoader.loadProtein("PDB/1a19.pdb");
-    SimpleProtein* proteinB = m_proteinLoader.loadProtein("PDB/5bs0.pdb");
+    std::vector<SimpleProtein*> proteins = m_proteinLoader.loadProteins({"PDB/1a19.pdb", "PDB/5bs0.pdb"});
+    SimpleProtein* proteinA = proteins.at(0);
+    SimpleProtein* proteinB = proteins.at(1);
     proteinA->center();
     proteinB->center();
     proteinB->move(glm::vec3(proteinA->extent().x/2 + proteinB->extent().x/2, 0, 0));
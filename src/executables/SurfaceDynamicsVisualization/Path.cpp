@@ -38,53 +38,73 @@ void Path::update(
     const std::set<GLuint>& atomIndices,
     int smoothFrameRadius)
 {
-    // Clear accumulated length
-    mAccLengths.clear();
-    mAccLengths.reserve(pGPUProtein->getFrameCount() - 1); // distance between path vertices
-
-    // Go over frames and calculate average position of all used atoms
-    std::vector<glm::vec3> path; // global position
-    path.reserve(pGPUProtein->getFrameCount());
-    std::vector<glm::vec3> localPath; // local position
-    localPath.reserve(pGPUProtein->getFrameCount());
-    bool first = true;
-    for(int frame = 0; frame < pGPUProtein->getFrameCount(); frame++)
-    {
-        // Go over analysed atoms and accumulate position in frame
-        glm::vec3 accPosition(0,0,0);
-        for(int atomIndex : atomIndices)
-        {
-            accPosition += pGPUProtein->getTrajectory()->at(frame).at(atomIndex);
-        }
-
-        // Calculate average
-        glm::vec3 avgPosition = accPosition / atomIndices.size();
+    update(pGPUProtein, std::vector<GLuint>(atomIndices.begin(), atomIndices.end()), smoothFrameRadius);
+}
 
-        // Calculate local average position
-        glm::vec3 localAvgPosition = avgPosition - pGPUProtein->getCenterOfMass(frame);
+void Path::update(
+    GPUProtein const * pGPUProtein,
+    const std::vector<GLuint>& rAtomIndices,
+    int smoothFrameRadius)
+{
+    update(pGPUProtein, std::vector<std::vector<GLuint> >(1, rAtomIndices), smoothFrameRadius, std::vector<Path*>(1, this));
+}
 
-        // Caluclate and accumulate distance
-        if(!first)
+void Path::update(
+    GPUProtein const * pGPUProtein,
+    const std::vector<std::vector<GLuint> >& rAtomGroups,
+    int smoothFrameRadius,
+    const std::vector<Path*>& rPaths)
+{
+    // Go over frames and calculate average position of all groups, so trajectory is traversed only once
+    int frameCount = pGPUProtein->getFrameCount();
+    int groupCount = (int)rAtomGroups.size();
+    std::vector<std::vector<glm::vec3> > paths(groupCount); // global positions
+    for(auto& rPath : paths) { rPath.reserve(frameCount); }
+    for(int frame = 0; frame < frameCount; frame++)
+    {
+        Trajectory::FrameSpan positions = pGPUProtein->getFrame(frame); // streamed frames are read ahead by cache
+        for(int group = 0; group < groupCount; group++)
         {
-            // Save length
-            double length = (double)glm::distance(avgPosition, path.back());
-            double localLength = (double)glm::distance(localAvgPosition, localPath.back());
-            if(mAccLengths.empty())
-            {
-                mAccLengths.push_back(std::make_pair(length, localLength));
-            }
-            else
+            // Go over analysed atoms and accumulate position in frame
+            const std::vector<GLuint>& rAtomIndices = rAtomGroups.at(group);
+            glm::vec3 accPosition(0,0,0);
+            for(GLuint atomIndex : rAtomIndices)
             {
-                mAccLengths.push_back(std::make_pair(
-                    mAccLengths.back().first + length,
-                    mAccLengths.back().second + localLength));
+                accPosition += positions[atomIndex];
             }
+
+            // Calculate average
+            paths.at(group).push_back(accPosition / (float)rAtomIndices.size());
         }
+    }
 
-        // Push new average position value to vector after calculating distance
-        path.push_back(avgPosition);
-        localPath.push_back(localAvgPosition);
-        first = false;
+    // Give average positions to paths
+    for(int group = 0; group < groupCount; group++)
+    {
+        rPaths.at(group)->setPath(pGPUProtein, paths.at(group), smoothFrameRadius);
+    }
+}
+
+void Path::setPath(
+    GPUProtein const * pGPUProtein,
+    const std::vector<glm::vec3>& rPath,
+    int smoothFrameRadius)
+{
+    // Clear accumulated length
+    int pathVertexCount = (int)rPath.size();
+    mAccLengths.clear();
+    mAccLengths.reserve(glm::max(0, pathVertexCount - 1)); // distance between path vertices
+
+    // Caluclate and accumulate distance between global and local positions
+    std::pair<double, double> accLength(0.0, 0.0);
+    for(int frame = 1; frame < pathVertexCount; frame++)
+    {
+        // Local position is relative to center of mass in that frame
+        glm::vec3 localPosition = rPath.at(frame) - pGPUProtein->getCenterOfMass(frame);
+        glm::vec3 previousLocalPosition = rPath.at(frame - 1) - pGPUProtein->getCenterOfMass(frame - 1);
+        accLength.first += (double)glm::distance(rPath.at(frame), rPath.at(frame - 1));
+        accLength.second += (double)glm::distance(localPosition, previousLocalPosition);
+        mAccLengths.push_back(accLength);
     }
 
     // Create VBO which is filled within next if clause
@@ -93,40 +113,31 @@ void Path::update(
     // If necessary, smooth those calculated positions over time
     if(smoothFrameRadius > 0)
     {
-        // Create vector for smoothed path
-        std::vector<glm::vec3> smoothedPath;
-        smoothedPath.reserve(pGPUProtein->getFrameCount());
-
-        // Go over all positions
-        int pathVertexCount = path.size();
+        // Prefix sums of positions, so each smoothed position is the difference of two sums
+        std::vector<glm::dvec3> prefixSums(pathVertexCount + 1, glm::dvec3(0,0,0));
         for(int i = 0; i < pathVertexCount; i++)
         {
-            // Do accumulation for each frame
-            glm::vec3 accPosition(0,0,0);
+            prefixSums[i + 1] = prefixSums[i] + glm::dvec3(rPath[i]);
+        }
 
-            // Get all position within radius
+        // Average all positions within radius
+        std::vector<glm::vec3> smoothedPath(pathVertexCount);
+        for(int i = 0; i < pathVertexCount; i++)
+        {
             int startFrame = glm::max(0, i - smoothFrameRadius);
             int endFrame = glm::min(pathVertexCount-1, i + smoothFrameRadius);
-            for(int j = startFrame; j <= endFrame; j++)
-            {
-                accPosition += path.at(j); // use global position for rendering
-            }
-            accPosition /= ((endFrame - startFrame) + 1);
-
-            // Push it back to smoothed path vector
-            smoothedPath.push_back(accPosition);
+            smoothedPath[i] = glm::vec3((prefixSums[endFrame + 1] - prefixSums[startFrame]) / (double)((endFrame - startFrame) + 1)); // use global position for rendering
         }
 
         // Fill smoothed path to vertex buffer
         glBufferData(GL_ARRAY_BUFFER, smoothedPath.size() * sizeof(glm::vec3), smoothedPath.data(), GL_DYNAMIC_DRAW);
-        mVertexCount = smoothedPath.size(); // should be the same as path.size(), but ok...
     }
     else
     {
         // Fill unsmoothed path to vertex buffer
-        glBufferData(GL_ARRAY_BUFFER, path.size() * sizeof(glm::vec3), path.data(), GL_DYNAMIC_DRAW);
-        mVertexCount = path.size();
+        glBufferData(GL_ARRAY_BUFFER, rPath.size() * sizeof(glm::vec3), rPath.data(), GL_DYNAMIC_DRAW);
     }
+    mVertexCount = pathVertexCount;
 
     // Unbind buffer
     glBindBuffer(GL_ARRAY_BUFFER, 0);
@@ -30,6 +30,19 @@ public:
         const std::set<GLuint>& atomIndices,
         int smoothFrameRadius);
 
+    // Update path with contiguous array of atom indices
+    void update(
+        GPUProtein const * pGPUProtein,
+        const std::vector<GLuint>& rAtomIndices,
+        int smoothFrameRadius);
+
+    // Update paths of multiple atom groups in one pass over the trajectory. Count of paths and groups must match
+    static void update(
+        GPUProtein const * pGPUProtein,
+        const std::vector<std::vector<GLuint> >& rAtomGroups,
+        int smoothFrameRadius,
+        const std::vector<Path*>& rPaths);
+
     // Draw path
     void draw(
         int frame,
@@ -57,6 +70,12 @@ public:
 
 private:
 
+    // Compute accumulated lengths and fill vertex buffer with (smoothed) path
+    void setPath(
+        GPUProtein const * pGPUProtein,
+        const std::vector<glm::vec3>& rPath,
+        int smoothFrameRadius);
+
     // Members
     float mlength = 0;
     GLuint mVBO = 0;
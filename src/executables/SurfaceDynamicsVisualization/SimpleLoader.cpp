@@ -52,15 +52,16 @@ std::unique_ptr<GPUProtein> parseSimplePDB(std::string filepath, glm::vec3& rMin
 
         // Some values for iteration
         std::string lineDelimiter = "\n";
+        size_t lineStart = 0;
         size_t linePos = 0;
         std::string line;
 
-        // Iterate through lines
-        while ((linePos = content.find(lineDelimiter)) != std::string::npos)
+        // Iterate through lines (content is not erased, which would copy the remaining file per line)
+        while ((linePos = content.find(lineDelimiter, lineStart)) != std::string::npos)
         {
             // Extract line
-            line = content.substr(0, linePos);
-            content.erase(0, linePos + lineDelimiter.length());
+            line = content.substr(lineStart, linePos - lineStart);
+            lineStart = linePos + lineDelimiter.length();
 
             // Check for empty line
             if(line.empty())
@@ -6,6 +6,9 @@
 #include "Utils/OrbitCamera.h"
 #include "ShaderTools/Renderer.h"
 #include "Molecule/MDtrajLoader/MdTraj/MdTrajWrapper.h"
+#include "Molecule/NativeLoader/TrajectoryFile.h"
+#include "Molecule/NativeLoader/CompressedTrajectory.h"
+#include "Molecule/NativeLoader/ProteinSnapshot.h"
 #include "Molecule/MDtrajLoader/Data/Protein.h"
 #include "SimpleLoader.h"
 #include "imgui/imgui.h"
@@ -14,6 +17,7 @@
 #include <glm/gtx/component_wise.hpp>
 #include <sstream>
 #include <iomanip>
+#include <cstdlib>
 
 // stb_image wants those defines
 #define STB_IMAGE_IMPLEMENTATION
@@ -24,7 +28,13 @@ namespace csv = ::text::csv;
 
 // ### Class implementation ###
 
-SurfaceDynamicsVisualization::SurfaceDynamicsVisualization(std::string filepathPDB, std::string filepathXTC)
+SurfaceDynamicsVisualization::SurfaceDynamicsVisualization(
+    std::string filepathPDB,
+    std::string filepathXTC,
+    float compressionPrecision,
+    int startFrame,
+    int stopFrame,
+    int frameStride)
 {
     Logger::instance().print("Welcome to Surface Dynamics Visualization!");
 
@@ -36,6 +46,10 @@ SurfaceDynamicsVisualization::SurfaceDynamicsVisualization(std::string filepathP
     mWindowHeight = mInitialWindowHeight;
     mPDBFilepath = filepathPDB;
     mXTCFilepath = filepathXTC;
+    mCompressionPrecision = compressionPrecision;
+    mLoadStartFrame = glm::max(0, startFrame);
+    mLoadStopFrame = stopFrame;
+    mLoadFrameStride = glm::max(1, frameStride);
 
     // # Setup paths
     resetPath(mGlobalAnalysisFilePath, "/GlobalAnalysis.csv");
@@ -114,12 +128,130 @@ SurfaceDynamicsVisualization::SurfaceDynamicsVisualization(std::string filepathP
 
     // Loading molecule
     Logger::instance().print("Import molecule..");
-    MdTrajWrapper mdwrap;
     std::vector<std::string> paths;
     paths.push_back(mPDBFilepath);
-    if(!mXTCFilepath.empty()) { paths.push_back(mXTCFilepath); }
-    std::unique_ptr<Protein> upProtein = std::move(mdwrap.load(paths));
-    mupGPUProtein = std::unique_ptr<GPUProtein>(new GPUProtein(upProtein.get()));
+
+    // Atoms and frames which are not loaded at all. Models of ensembles become frames when there is no trajectory
+    LoadOptions loadOptions;
+    loadOptions.startFrame = mLoadStartFrame;
+    loadOptions.stopFrame = mLoadStopFrame;
+    loadOptions.frameStride = mLoadFrameStride;
+    loadOptions.stripWater = mStripWater;
+    loadOptions.stripIons = mStripIons;
+    loadOptions.readAllModels = mXTCFilepath.empty();
+
+    // Trajectories which should be compressed or do not fit into memory are streamed. Others are held in memory,
+    // either loaded together with structure or progressively after first frame is shown
+    std::shared_ptr<TrajectoryFile> spTrajectoryFile;
+    bool loadProgressively = false;
+    if(!mXTCFilepath.empty())
+    {
+        spTrajectoryFile = TrajectoryFile::open(mXTCFilepath);
+        if(!spTrajectoryFile)
+        {
+            Logger::instance().print("Unsupported trajectory file: " + mXTCFilepath, Logger::Mode::ERROR);
+            exit(-1);
+        }
+        spTrajectoryFile->select(loadOptions);
+        unsigned long long trajectoryBytes =
+            (unsigned long long)spTrajectoryFile->getAtomCount() * (unsigned long long)spTrajectoryFile->getFrameCount() * sizeof(glm::vec3);
+        if(!spTrajectoryFile->isOpen() || (mCompressionPrecision <= 0.f && trajectoryBytes <= mMaxTrajectoryBytesInMemory))
+        {
+            paths.push_back(mXTCFilepath);
+            loadProgressively = mProgressiveLoading && spTrajectoryFile->isOpen();
+            if(!loadProgressively) { spTrajectoryFile.reset(); }
+        }
+    }
+
+    // Snapshot is opened directly. Otherwise, snapshot cached from earlier session is used if files did not change
+    std::vector<int> atomIndices;
+    std::unique_ptr<Protein> upProtein;
+    if(ProteinSnapshot::isSnapshotFilepath(mPDBFilepath))
+    {
+        upProtein = ProteinSnapshot::read(mPDBFilepath, 0, &atomIndices);
+        if(!upProtein)
+        {
+            Logger::instance().print("Could not read snapshot: " + mPDBFilepath, Logger::Mode::ERROR);
+            exit(-1);
+        }
+    }
+    else
+    {
+        uint64_t sourceKey = ProteinSnapshot::computeSourceKey(paths, loadOptions);
+        std::string snapshotFilepath = ProteinSnapshot::getCacheFilepath(paths.back());
+        upProtein = ProteinSnapshot::read(snapshotFilepath, sourceKey, &atomIndices);
+        if(upProtein)
+        {
+            // Complete trajectory is cached, so nothing is left to load in background
+            loadProgressively = false;
+            spTrajectoryFile.reset();
+        }
+        else if(loadProgressively)
+        {
+            // Only structure is loaded now, frames of trajectory follow in background. Snapshot of complete trajectory
+            // is written once they are loaded
+            mLoadingSnapshotFilepath = snapshotFilepath;
+            mLoadingSourceKey = sourceKey;
+            paths.pop_back();
+            sourceKey = ProteinSnapshot::computeSourceKey(paths, loadOptions);
+            snapshotFilepath = ProteinSnapshot::getCacheFilepath(paths.back());
+            upProtein = ProteinSnapshot::read(snapshotFilepath, sourceKey, &atomIndices);
+        }
+        if(upProtein)
+        {
+            Logger::instance().print("Molecule is read from snapshot " + snapshotFilepath);
+        }
+        else
+        {
+            upProtein.reset(MdTrajWrapper::instance().load(paths, loadOptions, &atomIndices).release());
+            ProteinSnapshot::write(snapshotFilepath, upProtein.get(), atomIndices, sourceKey);
+        }
+    }
+
+    // Streamed trajectory provides same atoms as protein
+    if(spTrajectoryFile && (!spTrajectoryFile->select(loadOptions, atomIndices) || spTrajectoryFile->getAtomCount() != (int)upProtein->getAtoms()->size()))
+    {
+        Logger::instance().print("Trajectory does not fit to protein: " + mXTCFilepath, Logger::Mode::ERROR);
+        spTrajectoryFile.reset();
+    }
+
+    // Atoms close in space are kept close in memory on GPU, which helps kernels going over neighbors
+    GPUProtein::AtomOrder atomOrder = mSpatialAtomOrder ? GPUProtein::AtomOrder::SPATIAL : GPUProtein::AtomOrder::ORIGINAL;
+    if(spTrajectoryFile && mCompressionPrecision > 0.f)
+    {
+        // Compress frame after frame, so complete trajectory is never decompressed in memory
+        std::shared_ptr<CompressedTrajectory> spCompressedTrajectory(
+            new CompressedTrajectory(spTrajectoryFile->getAtomCount(), mCompressionPrecision, mCompressionKeyframeInterval));
+        std::vector<glm::vec3> positions(spTrajectoryFile->getAtomCount());
+        for(int i = 0; i < spTrajectoryFile->getFrameCount(); i++)
+        {
+            if(!spTrajectoryFile->readFrame(i, positions.data())) { break; }
+            spCompressedTrajectory->addFrame(positions.data());
+        }
+        Logger::instance().print("Trajectory is compressed to " + std::to_string(spCompressedTrajectory->getByteCount() / (1024 * 1024)) + " MB");
+        mupGPUProtein = std::unique_ptr<GPUProtein>(
+            new GPUProtein(upProtein.get(), spCompressedTrajectory, mStreamedCachedFrameCount, mStreamedWindowFrameCount, atomOrder));
+    }
+    else if(spTrajectoryFile && loadProgressively)
+    {
+        Logger::instance().print("Trajectory is loaded in background");
+        mupGPUProtein = std::unique_ptr<GPUProtein>(new GPUProtein(upProtein.get(), spTrajectoryFile, atomOrder));
+        if(!mLoadingSnapshotFilepath.empty())
+        {
+            mupLoadingProtein = std::move(upProtein);
+            mLoadingAtomIndices = atomIndices;
+        }
+    }
+    else if(spTrajectoryFile)
+    {
+        Logger::instance().print("Trajectory is streamed from disk");
+        mupGPUProtein = std::unique_ptr<GPUProtein>(
+            new GPUProtein(upProtein.get(), spTrajectoryFile, mStreamedCachedFrameCount, mStreamedWindowFrameCount, atomOrder));
+    }
+    else
+    {
+        mupGPUProtein = std::unique_ptr<GPUProtein>(new GPUProtein(upProtein.get(), atomOrder));
+    }
     Logger::instance().print("..done");
 
     // # Prepare framebuffers for rendering
@@ -215,6 +347,9 @@ SurfaceDynamicsVisualization::SurfaceDynamicsVisualization(std::string filepathP
     // Hull samples
     mupHullSamples = std::unique_ptr<GPUHullSamples>(new GPUHullSamples());
 
+    // Group analysis, which is reset after hull samples are computed
+    mupGroupAnalysis = std::unique_ptr<GroupAnalysis>(new GroupAnalysis());
+
     // Create empty outline atoms indices after OpenGL initialization
     mupOutlineAtomIndices = std::unique_ptr<GPUTextureBuffer>(new GPUTextureBuffer(0)); // create empty outline atom indices buffer
     Logger::instance().print("..done");
@@ -224,6 +359,7 @@ SurfaceDynamicsVisualization::SurfaceDynamicsVisualization(std::string filepathP
 
     // Ascension
     mupAscension = std::unique_ptr<GPUBuffer<GLfloat> >(new GPUBuffer<GLfloat>);
+    mupAscensionComputation = std::unique_ptr<Ascension>(new Ascension(mupGPUProtein->getAtomCount()));
     Logger::instance().print("..done");
 
     // # Validation
@@ -501,6 +637,18 @@ void SurfaceDynamicsVisualization::renderLoop()
         }
         if(mFrameLogging) { Logger::instance().print("..done"); }
 
+        // ### TRAJECTORY WINDOW ###################################################################################
+
+        // Frames used for smoothed animation must be on GPU (changes only anything when trajectory is streamed)
+        mTrajectoryWindowStart = mupGPUProtein->updateWindow(mFrame - mSmoothAnimationRadius, mFrame + mSmoothAnimationRadius);
+
+        // Frames of progressively loaded trajectory become available in timeline once uploaded by the window update
+        mEndFrame = mupGPUProtein->getFrameCount() - 1;
+        if(mupLoadingProtein && !mupGPUProtein->isLoading())
+        {
+            writeLoadedSnapshot();
+        }
+
         // ### OVERLAY RENDERING ###################################################################################
         if(mFrameLogging) { Logger::instance().print("Render overlay.."); }
 
@@ -538,6 +686,7 @@ void SurfaceDynamicsVisualization::renderLoop()
                 outlineProgram.update("view", mupCamera->getViewMatrix());
                 outlineProgram.update("projection", mupCamera->getProjectionMatrix());
                 outlineProgram.update("frame", mFrame);
+                outlineProgram.update("trajectoryWindowStart", mTrajectoryWindowStart);
                 outlineProgram.update("atomCount", mupGPUProtein->getAtomCount());
                 outlineProgram.update("smoothAnimationRadius", mSmoothAnimationRadius);
                 outlineProgram.update("smoothAnimationMaxDeviation", mSmoothAnimationMaxDeviation);
@@ -584,6 +733,7 @@ void SurfaceDynamicsVisualization::renderLoop()
                 surfaceMarksProgram.update("projection", mupCamera->getProjectionMatrix());
                 surfaceMarksProgram.update("clippingPlane", mClippingPlane);
                 surfaceMarksProgram.update("frame", mFrame);
+                surfaceMarksProgram.update("trajectoryWindowStart", mTrajectoryWindowStart);
                 surfaceMarksProgram.update("atomCount", mupGPUProtein->getAtomCount());
                 surfaceMarksProgram.update("smoothAnimationRadius", mSmoothAnimationRadius);
                 surfaceMarksProgram.update("smoothAnimationMaxDeviation", mSmoothAnimationMaxDeviation);
@@ -616,6 +766,20 @@ void SurfaceDynamicsVisualization::renderLoop()
                     mPastPathColor,
                     mFuturePathColor,
                     mPathPointSize);
+                if(mShowResiduePaths)
+                {
+                    for(const auto& rupResiduePath : mResiduePaths)
+                    {
+                        rupResiduePath->draw(
+                            mFrame,
+                            mPathFrameRadius,
+                            mupCamera->getViewMatrix(),
+                            mupCamera->getProjectionMatrix(),
+                            mPastPathColor,
+                            mFuturePathColor,
+                            mPathPointSize);
+                    }
+                }
             }
         }
 
@@ -738,6 +902,7 @@ void SurfaceDynamicsVisualization::renderLoop()
                 hullProgram.update("selectedIndex", selectedAtom);
                 hullProgram.update("clippingPlane", mClippingPlane);
                 hullProgram.update("frame", mFrame);
+                hullProgram.update("trajectoryWindowStart", mTrajectoryWindowStart);
                 hullProgram.update("atomCount", mupGPUProtein->getAtomCount());
                 hullProgram.update("smoothAnimationRadius", mSmoothAnimationRadius);
                 hullProgram.update("smoothAnimationMaxDeviation", mSmoothAnimationMaxDeviation);
@@ -783,6 +948,7 @@ void SurfaceDynamicsVisualization::renderLoop()
                 ascensionProgram.update("selectedIndex", selectedAtom);
                 ascensionProgram.update("clippingPlane", mClippingPlane);
                 ascensionProgram.update("frame", mFrame);
+                ascensionProgram.update("trajectoryWindowStart", mTrajectoryWindowStart);
                 ascensionProgram.update("atomCount", mupGPUProtein->getAtomCount());
                 ascensionProgram.update("smoothAnimationRadius", mSmoothAnimationRadius);
                 ascensionProgram.update("smoothAnimationMaxDeviation", mSmoothAnimationMaxDeviation);
@@ -816,6 +982,7 @@ void SurfaceDynamicsVisualization::renderLoop()
                 coloringProgram.update("selectedIndex", selectedAtom);
                 coloringProgram.update("clippingPlane", mClippingPlane);
                 coloringProgram.update("frame", mFrame);
+                coloringProgram.update("trajectoryWindowStart", mTrajectoryWindowStart);
                 coloringProgram.update("atomCount", mupGPUProtein->getAtomCount());
                 coloringProgram.update("smoothAnimationRadius", mSmoothAnimationRadius);
                 coloringProgram.update("smoothAnimationMaxDeviation", mSmoothAnimationMaxDeviation);
@@ -862,6 +1029,7 @@ void SurfaceDynamicsVisualization::renderLoop()
                 coloringProgram.update("selectedIndex", selectedAtom);
                 coloringProgram.update("clippingPlane", mClippingPlane);
                 coloringProgram.update("frame", mFrame);
+                coloringProgram.update("trajectoryWindowStart", mTrajectoryWindowStart);
                 coloringProgram.update("atomCount", mupGPUProtein->getAtomCount());
                 coloringProgram.update("smoothAnimationRadius", mSmoothAnimationRadius);
                 coloringProgram.update("smoothAnimationMaxDeviation", mSmoothAnimationMaxDeviation);
@@ -908,6 +1076,7 @@ void SurfaceDynamicsVisualization::renderLoop()
                 analysisProgram.update("selectedIndex", selectedAtom);
                 analysisProgram.update("clippingPlane", mClippingPlane);
                 analysisProgram.update("frame", mFrame);
+                analysisProgram.update("trajectoryWindowStart", mTrajectoryWindowStart);
                 analysisProgram.update("atomCount", mupGPUProtein->getAtomCount());
                 analysisProgram.update("smoothAnimationRadius", mSmoothAnimationRadius);
                 analysisProgram.update("smoothAnimationMaxDeviation", mSmoothAnimationMaxDeviation);
@@ -941,6 +1110,7 @@ void SurfaceDynamicsVisualization::renderLoop()
                     hullProgram.update("selectedIndex", selectedAtom);
                     hullProgram.update("clippingPlane", mClippingPlane);
                     hullProgram.update("frame", mFrame);
+                    hullProgram.update("trajectoryWindowStart", mTrajectoryWindowStart);
                     hullProgram.update("atomCount", mupGPUProtein->getAtomCount());
                     hullProgram.update("smoothAnimationRadius", mSmoothAnimationRadius);
                     hullProgram.update("smoothAnimationMaxDeviation", mSmoothAnimationMaxDeviation);
@@ -988,6 +1158,7 @@ void SurfaceDynamicsVisualization::renderLoop()
                 residueRSPPeelProgram.update("selectedIndex", selectedAtom);
                 residueRSPPeelProgram.update("clippingPlane", mClippingPlane);
                 residueRSPPeelProgram.update("frame", mFrame);
+                residueRSPPeelProgram.update("trajectoryWindowStart", mTrajectoryWindowStart);
                 residueRSPPeelProgram.update("atomCount", mupGPUProtein->getAtomCount());
                 residueRSPPeelProgram.update("smoothAnimationRadius", mSmoothAnimationRadius);
                 residueRSPPeelProgram.update("smoothAnimationMaxDeviation", mSmoothAnimationMaxDeviation);
@@ -1051,6 +1222,7 @@ void SurfaceDynamicsVisualization::renderLoop()
             fallbackProgram.update("selectedIndex", selectedAtom);
             fallbackProgram.update("clippingPlane", mClippingPlane);
             fallbackProgram.update("frame", mFrame);
+            fallbackProgram.update("trajectoryWindowStart", mTrajectoryWindowStart);
             fallbackProgram.update("atomCount", mupGPUProtein->getAtomCount());
             fallbackProgram.update("smoothAnimationRadius", mSmoothAnimationRadius);
             fallbackProgram.update("smoothAnimationMaxDeviation", mSmoothAnimationMaxDeviation);
@@ -1102,6 +1274,7 @@ void SurfaceDynamicsVisualization::renderLoop()
             selectionProgram.update("lightDir", mLightDirection);
             selectionProgram.update("clippingPlane", mClippingPlane);
             selectionProgram.update("frame", mFrame);
+            selectionProgram.update("trajectoryWindowStart", mTrajectoryWindowStart);
             selectionProgram.update("atomCount", mupGPUProtein->getAtomCount());
             selectionProgram.update("smoothAnimationRadius", mSmoothAnimationRadius);
             selectionProgram.update("smoothAnimationMaxDeviation", mSmoothAnimationMaxDeviation);
@@ -1289,7 +1462,7 @@ void SurfaceDynamicsVisualization::mouseButtonCallback(int button, int action, i
         {
             int atomIndex = getAtomBeneathCursor();
             mSelectedAtom = atomIndex >= 0 ? atomIndex : mSelectedAtom;
-            mNextAnalyseAtomIndex = mSelectedAtom;
+            mNextAnalyseAtomIndex = mupGPUProtein->getOriginalIndex(mSelectedAtom);
         }
     }
 }
@@ -1606,9 +1779,10 @@ void SurfaceDynamicsVisualization::renderGUI()
                 {
                     // Average centers of atoms in analysis group
                     glm::vec3 avgCenter(0,0,0);
+                    Trajectory::FrameSpan positions = mupGPUProtein->getFrame(mFrame);
                     for(GLuint atomIndex : mAnalyseGroup)
                     {
-                        avgCenter += mupGPUProtein->getTrajectory()->at(mFrame).at(atomIndex);
+                        avgCenter += positions.at(atomIndex);
                     }
 
                     // Applied for next frame
@@ -1854,6 +2028,11 @@ void SurfaceDynamicsVisualization::renderGUI()
 
             // Frame count
             ImGui::Text(std::string("Frame Count: " + std::to_string(mupGPUProtein->getFrameCount())).c_str());
+            if(mupGPUProtein->isLoading())
+            {
+                ImGui::SameLine();
+                ImGui::Text(std::string("(loading " + std::to_string(mupGPUProtein->getTotalFrameCount()) + ")").c_str());
+            }
         }
 
         // ### Computation infos ###
@@ -1870,10 +2049,12 @@ void SurfaceDynamicsVisualization::renderGUI()
         // ### Selection infos ###
         if (ImGui::CollapsingHeader("Selection", "Selection##Information", true, true))
         {
-            ImGui::InputInt("Index", &mSelectedAtom, 1);
+            int selectedAtomIndex = mupGPUProtein->getOriginalIndex(mSelectedAtom); // index as in file
+            ImGui::InputInt("Index", &selectedAtomIndex, 1);
             if(ImGui::IsItemHovered() && mShowTooltips) { ImGui::SetTooltip("Index of selected atom."); }
-            mSelectedAtom = glm::clamp(mSelectedAtom, 0, mupGPUProtein->getAtomCount() - 1);
-            ImGui::Text(std::string("Index: " + std::to_string(mSelectedAtom)).c_str());
+            selectedAtomIndex = glm::clamp(selectedAtomIndex, 0, mupGPUProtein->getAtomCount() - 1);
+            mSelectedAtom = mupGPUProtein->getInternalIndex(selectedAtomIndex);
+            ImGui::Text(std::string("Index: " + std::to_string(selectedAtomIndex)).c_str());
             ImGui::Text(std::string("Element: " + mupGPUProtein->getElementName(mSelectedAtom)).c_str());
             ImGui::Text(std::string("AminoAcid: " + mupGPUProtein->getAminoAcidName(mSelectedAtom)).c_str());
             if(frameComputed())
@@ -1932,6 +2113,7 @@ void SurfaceDynamicsVisualization::renderGUI()
         {
             if(ImGui::Button("Validate Surface"))
             {
+                std::vector<GLuint> maybeIncorrectSurfaceAtomIndices;
                 mupSurfaceValidation->validate(
                     mupGPUProtein.get(),
                     mGPUSurfaces.at(mFrame - mComputedStartFrame).get(),
@@ -1941,7 +2123,7 @@ void SurfaceDynamicsVisualization::renderGUI()
                     mSurfaceValidationSeed,
                     mSurfaceValidationAtomSampleCount,
                     mValidationInformation,
-                    std::vector<GLuint>());
+                    maybeIncorrectSurfaceAtomIndices);
             }
         }
         else
@@ -2024,11 +2206,11 @@ void SurfaceDynamicsVisualization::renderGUI()
                     std::ofstream fs(mSurfaceIndicesFilePath, std::ios_base::out); // overwrite existing
                     csv::csv_ostream csvs(fs);
 
-                    // Fill data
+                    // Fill data with indices of atoms as in file
                     auto indices = mGPUSurfaces.at(mFrame - mComputedStartFrame)->getSurfaceIndices(0);
                     for(const int index : indices)
                     {
-                        csvs << std::to_string(index);
+                        csvs << std::to_string(mupGPUProtein->getOriginalIndex(index));
                     }
 
                     // Tell user
@@ -2109,10 +2291,10 @@ void SurfaceDynamicsVisualization::renderGUI()
                             csvs << rAnalysis.name;
 
                             // Start index
-                            csvs << std::to_string(rAnalysis.startIndex);
+                            csvs << std::to_string(mupGPUProtein->getOriginalIndex(rAnalysis.startIndex));
 
                             // End index
-                            csvs << std::to_string(rAnalysis.endIndex);
+                            csvs << std::to_string(mupGPUProtein->getOriginalIndex(rAnalysis.endIndex));
 
                             // Average layers delta accumulation
                             csvs << std::to_string(rAnalysis.averageLayersDeltaAccumulation);
@@ -2290,8 +2472,8 @@ void SurfaceDynamicsVisualization::renderGUI()
                         ImGui::SameLine();
                     }
 
-                    // Index of atom
-                    ImGui::Text("%05d", atomIndex);
+                    // Index of atom as in file
+                    ImGui::Text("%05d", mupGPUProtein->getOriginalIndex(atomIndex));
                     ImGui::SameLine();
 
                     // Element of atom
@@ -2320,18 +2502,24 @@ void SurfaceDynamicsVisualization::renderGUI()
                 }
 
                 // Remove atoms from analysis
-                for(int atomIndex : toBeRemoved) { mAnalyseGroup.erase(atomIndex); }
+                for(int atomIndex : toBeRemoved)
+                {
+                    mAnalyseGroup.erase(atomIndex);
+                    mupGroupAnalysis->remove(atomIndex);
+                }
                 ImGui::EndChild();
 
                 // Add new atoms to analyse
                 ImGui::InputInt("##nextanalysisatom", &mNextAnalyseAtomIndex);
                 if(ImGui::IsItemHovered() && mShowTooltips) { ImGui::SetTooltip("Index of atom."); }
-                mNextAnalyseAtomIndex = glm::clamp(mNextAnalyseAtomIndex, 0, mupGPUProtein->getAtomCount());
+                mNextAnalyseAtomIndex = glm::clamp(mNextAnalyseAtomIndex, 0, mupGPUProtein->getAtomCount() - 1);
                 ImGui::SameLine();
                 if(ImGui::Button("Add Atom"))
                 {
                     // Add atom to list of analyse atoms
-                    mAnalyseGroup.insert((GLuint)mNextAnalyseAtomIndex);
+                    GLuint atomIndex = (GLuint)mupGPUProtein->getInternalIndex(mNextAnalyseAtomIndex);
+                    mAnalyseGroup.insert(atomIndex);
+                    mupGroupAnalysis->add(atomIndex);
                     analysisAtomsChanged = true;
                 }
 
@@ -2344,10 +2532,12 @@ void SurfaceDynamicsVisualization::renderGUI()
                 if(ImGui::IsItemHovered() && mShowTooltips) { ImGui::SetTooltip("Set end index of atoms which shall be added to group."); }
                 if(ImGui::Button("Add Atom Range"))
                 {
-                    // Add atoms to list of analyse atoms
+                    // Add atoms to list of analyse atoms, range is given in indices of file
                     for(int i = mNewGroupAtomsStartIndex; i <= mNewGroupAtomsEndIndex; i++)
                     {
-                        mAnalyseGroup.insert((GLuint)i);
+                        GLuint atomIndex = (GLuint)mupGPUProtein->getInternalIndex(i);
+                        mAnalyseGroup.insert(atomIndex);
+                        mupGroupAnalysis->add(atomIndex);
                     }
                     analysisAtomsChanged = true;
 
@@ -2359,6 +2549,7 @@ void SurfaceDynamicsVisualization::renderGUI()
                 if(ImGui::Button("Clear Group"))
                 {
                     mAnalyseGroup.clear();
+                    mupGroupAnalysis->clear();
                     analysisAtomsChanged = true;
                 }
                 if(ImGui::IsItemHovered() && mShowTooltips) { ImGui::SetTooltip("Remove all atoms from analysis group."); }
@@ -2374,7 +2565,7 @@ void SurfaceDynamicsVisualization::renderGUI()
                     // Path
                     doUpdatePath = true;
 
-                    // Group analysis update
+                    // Group analysis update (running sums are already updated by the edits above)
                     updateGroupAnalysis();
 
                     // Indicators for highlighting
@@ -2481,6 +2672,10 @@ void SurfaceDynamicsVisualization::renderGUI()
                     // Radius of frames in path visualization
                     ImGui::SliderInt("Path Display Radius", &mPathFrameRadius, 1, 1000);
 
+                    // Paths of residues are computed together with path of group
+                    ImGui::Checkbox("Show Residue Paths", &mShowResiduePaths);
+                    if(ImGui::IsItemHovered() && mShowTooltips) { ImGui::SetTooltip("Show path of each residue with atoms in group."); }
+
                     // Length of displayed path
                     int startFrame = glm::max(0, mFrame - mPathFrameRadius);
                     int endFrame = glm::min(mupPath->getVertexCount()-1, mFrame + mPathFrameRadius);
@@ -2570,10 +2765,10 @@ void SurfaceDynamicsVisualization::renderGUI()
                 }
             }
 
-            // Update path if necessary
+            // Update paths if necessary
             if(doUpdatePath)
             {
-                mupPath->update(mupGPUProtein.get(), mAnalyseGroup, mPathSmoothRadius);
+                updatePaths();
             }
         }
         else
@@ -2691,11 +2886,31 @@ bool SurfaceDynamicsVisualization::setFrame(int frame)
 
 void SurfaceDynamicsVisualization::computeLayers(bool useGPU)
 {
+    // Only frames which are already loaded can be computed
+    mComputationEndFrame = glm::min(mComputationEndFrame, mupGPUProtein->getFrameCount() - 1);
+    mComputationStartFrame = glm::min(mComputationStartFrame, mComputationEndFrame);
+
     // # Surface calculation
 
     // Reset surfaces
     mGPUSurfaces.clear();
 
+    // Reset ascension, which is appended frame by frame
+    mupAscensionComputation->clear();
+    mupAscensionComputation->setFrameCounts(
+        mAscensionUpToHotFrameCount,
+        mAscensionDownToHotFrameCount,
+        mAscensionUpToColdFrameCount,
+        mAscensionDownToColdFrameCount);
+
+    // Reset layers of atoms and amino acids analysis, which are filled frame by frame
+    mLayersOfAtoms.clear();
+    mLayerCounts.clear();
+    resetAminoAcidsAnalysis(
+        mupGPUProtein->getAminoAcids(),
+        mComputationEndFrame - mComputationStartFrame + 1,
+        mAminoAcidAnalysis);
+
     // Do it for all animation frames
     float computationTime = 0;
     for(int i = mComputationStartFrame; i <= mComputationEndFrame; i++)
@@ -2711,6 +2926,19 @@ void SurfaceDynamicsVisualization::computeLayers(bool useGPU)
         }
         computationTime += mGPUSurfaces.back()->getComputationTime();
 
+        // Append frame to ascension
+        mupAscensionComputation->appendFrame(mGPUSurfaces.back().get());
+
+        // Read layers of all atoms once and accumulate them per amino acid. Layers stay empty when not extracted
+        mLayersOfAtoms.push_back(std::vector<int>());
+        mLayerCounts.push_back(0);
+        if(mGPUSurfaces.back()->layersExtracted())
+        {
+            mLayersOfAtoms.back() = mGPUSurfaces.back()->getLayersOfAtoms();
+            mLayerCounts.back() = mGPUSurfaces.back()->getLayerCount();
+            accumulateAminoAcidsLayers(mLayersOfAtoms.back(), mLayerCounts.back(), i - mComputationStartFrame, mAminoAcidAnalysis);
+        }
+
         // Show progress
         float progress = (float)(i- mComputationStartFrame + 1) / (float)(mComputationEndFrame - mComputationStartFrame + 1);
         setProgressDisplay("Surface", progress);
@@ -2730,8 +2958,8 @@ void SurfaceDynamicsVisualization::computeLayers(bool useGPU)
     // Hull sample computation
     computeHullSamples();
 
-    // Ascension computation
-    computeAscension();
+    // Fill ascension to buffer
+    mupAscension->fill(mupAscensionComputation->getValues(), GL_DYNAMIC_DRAW);
 
     // Update amino acids analysis
     updateAminoAcidsAnaylsis();
@@ -2755,6 +2983,10 @@ void SurfaceDynamicsVisualization::computeHullSamples()
             this->setProgressDisplay("Hull Samples", progress);
         });
 
+    // Rebuild running sums of group analysis for new hull samples
+    mupGroupAnalysis->reset(&mLayersOfAtoms, mupHullSamples.get(), mupGPUProtein->getRadii(), mComputedProbeRadius);
+    for(GLuint atomIndex : mAnalyseGroup) { mupGroupAnalysis->add(atomIndex); }
+
     // Update analysis which depends on hull samples
     updateGlobalAnalysis();
     updateGroupAnalysis();
@@ -2762,108 +2994,16 @@ void SurfaceDynamicsVisualization::computeHullSamples()
 
 void SurfaceDynamicsVisualization::computeAscension()
 {
-    // Calculate ascension for visualization
-    int atomCount = mupGPUProtein->getAtomCount();
-    std::vector<float> ascension; // linear accumulation of ascension for all computed frames and all atoms
-    ascension.reserve(atomCount * (int)mGPUSurfaces.size());
-    GLuint frame = 0; // ascension frame, incremented in outer for loop
-    float pi = glm::pi<float>();
-    float upToHot = pi / mAscensionUpToHotFrameCount;
-    float downToHot = pi / mAscensionDownToHotFrameCount;
-    float upToCold = pi / mAscensionUpToColdFrameCount;
-    float downToCold = pi / mAscensionDownToColdFrameCount;
-
-    // Go over frames for which surface exist
-    for(const auto& rupGPUSurface : mGPUSurfaces)
-    {
-        // Get surface indices of layer zero for that frame
-        std::vector<GLuint> surfaceIndices = rupGPUSurface->getSurfaceIndices(0);
-
-        // Go over atoms
-        for(int a = 0; a < atomCount; a++)
-        {
-            bool surface = false;
-
-            // Go over surface indices
-            for(GLuint s : surfaceIndices)
-            {
-                // Check whether current atom is on surface
-                if(a == s)
-                {
-                    surface = true;
-                    break;
-                }
-            }
-
-            // Value which will be filled and pushed back
-            float value = 0;
-
-            // Check for first frame
-            if(frame == 0)
-            {
-                // Push back value for first frame of ascension (either at surface or not)
-                value = surface ? pi : 0.f;
-            }
-            else
-            {
-                // Fetch value of previous frame for this atom
-                float previousValue = ascension.at(((frame - 1) * atomCount + a));
-
-                // Decide what to happen with ascension value
-                if(surface) // surface
-                {
-                    // Decide whether increase or decrease
-                    if(previousValue == pi)
-                    {
-                        // Already hot, stay that way
-                        value = pi;
-                    }
-                    else if(previousValue < pi)
-                    {
-                        // Getting hotter, coming from cold
-                        value = glm::min(pi, previousValue + upToHot);
-                    }
-                    else
-                    {
-                        // Getting hotter again, was already on its way to becoming cold
-                        value = glm::max(pi, previousValue - downToHot);
-                    }
-                }
-                else // internal
-                {
-                    // Decide whether increase or decrease
-                    if(previousValue == 0)
-                    {
-                        // Already cold, stay that way
-                        value = 0.f;
-                    }
-                    else if(previousValue < pi)
-                    {
-                        // A throwback on the way of getting hot
-                        value = glm::max(0.f, previousValue - downToCold);
-                    }
-                    else
-                    {
-                        // Was hot and getting cold again
-                        value = glm::mod(
-                                    glm::min(
-                                        2.f * pi,
-                                        previousValue + upToCold),
-                                    2.f * pi);
-                    }
-                }
-            }
-
-            // Push back calculated value for that atom on that frame
-            ascension.push_back(value);
-        }
-
-        // Increment counter of frames
-        frame++;
-    }
-
-    // Fill ascension to texture buffer
-    mupAscension->fill(ascension, GL_DYNAMIC_DRAW);
+    // Recompute ascension from surface bitsets with current frame counts
+    mupAscensionComputation->setFrameCounts(
+        mAscensionUpToHotFrameCount,
+        mAscensionDownToHotFrameCount,
+        mAscensionUpToColdFrameCount,
+        mAscensionDownToColdFrameCount);
+    mupAscensionComputation->recompute();
+
+    // Fill ascension to buffer
+    mupAscension->fill(mupAscensionComputation->getValues(), GL_DYNAMIC_DRAW);
 }
 
 int SurfaceDynamicsVisualization::getAtomBeneathCursor() const
@@ -2946,194 +3086,21 @@ void SurfaceDynamicsVisualization::updateGlobalAnalysis()
 
 void SurfaceDynamicsVisualization::updateGroupAnalysis()
 {
-    // Go over frames and extract layer of group
-    mAnalysisGroupMinLayers = std::vector<float>(mGPUSurfaces.size(), -1); // minus one means no data
-    mAnalysisGroupAvgLayers = std::vector<float>(mGPUSurfaces.size(), -1); // minus one means no data
-    for(int frame = mComputedStartFrame; frame <= mComputedEndFrame; frame++)
-    {
-        // Relative frame
-        int relativeFrame = frame - mComputedStartFrame;
-
-        // Do it only when layers were extracted for this frame
-        if(mGPUSurfaces.at(relativeFrame)->layersExtracted())
-        {
-            // Calculate layer of group for that frame
-            int minLayer = std::numeric_limits<int>::max();
-            float avgLayer = 0;
-            for(GLuint atomIndex : mAnalyseGroup)
-            {
-                // Get layer of that atom
-                int layer = mGPUSurfaces.at(relativeFrame)->getLayerOfAtom(atomIndex);
-
-                // Extract min layer (which mean the one closest or at surface)
-                minLayer = minLayer > layer ? layer : minLayer;
-
-                // Accumulate for average layer calculation
-                avgLayer += (float)layer;
-            }
-            mAnalysisGroupMinLayers.at(relativeFrame) = (float)minLayer;
-            mAnalysisGroupAvgLayers.at(relativeFrame) = avgLayer / (float)mAnalyseGroup.size();
-        }
-    }
-
-    // Go over frames and calculate surface amount and area of group atoms
-    mAnalysisGroupSurfaceAmount = std::vector<float>(mGPUSurfaces.size(), -1); // minus one means no data
-    mAnalysisGroupSurfaceArea = std::vector<float>(mGPUSurfaces.size(), -1); // minus one means no data
-    for(int frame = mComputedStartFrame; frame <= mComputedEndFrame; frame++)
-    {
-        // Relative frame
-        int relativeFrame = frame - mComputedStartFrame;
-
-        // Accumulate sample count
-        float surfaceSampleCount = 0;
-        for(GLuint atomIndex : mAnalyseGroup)
-        {
-            // Surface amount for group in that frame for that atom
-            surfaceSampleCount += (float)mupHullSamples->getSurfaceSampleCount(frame, atomIndex);
-        }
-
-        // Save surface amount of group for that frame
-        mAnalysisGroupSurfaceAmount.at(relativeFrame) = surfaceSampleCount / (float)mupHullSamples->getSampleCount(mAnalyseGroup.size());
-
-        // Save surface area
-        mAnalysisGroupSurfaceArea.at(relativeFrame) = approximateSurfaceArea(std::vector<GLuint>(mAnalyseGroup.begin(), mAnalyseGroup.end()), frame);
-    }
+    // Fetch values from running sums of group analysis
+    mAnalysisGroupMinLayers = mupGroupAnalysis->getMinLayers();
+    mAnalysisGroupAvgLayers = mupGroupAnalysis->getAvgLayers();
+    mAnalysisGroupSurfaceAmount = mupGroupAnalysis->getSurfaceAmount();
+    mAnalysisGroupSurfaceArea = mupGroupAnalysis->getSurfaceArea();
 
     // Average layers delta accumulation
-    mAvgLayersDeltaAcc = 0.f;
-    for(int i = 0; i < mAnalysisGroupAvgLayers.size() - 1; i++)
-    {
-        float delta = mAnalysisGroupAvgLayers.at(i + 1) - mAnalysisGroupAvgLayers.at(i);
-        delta = delta < 0 ? -delta : delta;
-        mAvgLayersDeltaAcc += delta;
-    }
+    mAvgLayersDeltaAcc = mupGroupAnalysis->getAvgLayersDeltaAccumulation();
 }
 
-// TODO check for CORRECTNESS!!! AND OPTIMIZE! (especially .size stuff)
 void SurfaceDynamicsVisualization::updateAminoAcidsAnaylsis()
 {
-    // Clear result vector
-    mAminoAcidAnalysis.clear();
-
-    // Get amino acids out of protein
-    std::vector<GPUProtein::AminoAcid> aminoAcids = mupGPUProtein->getAminoAcids();
-    for(const GPUProtein::AminoAcid& rAminoAcid : aminoAcids)
-    {
-        // Do calculations for each amino acid
-        AminoAcidAnalysis current;
-        current.name = rAminoAcid.name;
-        current.startIndex = rAminoAcid.startIndex;
-        current.endIndex = rAminoAcid.endIndex;
-
-        // Go over frames and extract average layer of atoms
-        current.averageLayers = std::vector<float>(mGPUSurfaces.size(), -1.f); // minus one means no data
-        current.inverseAverageLayers = std::vector<float>(mGPUSurfaces.size(), -1.f); // minus one means no data
-
-        for(int frame = mComputedStartFrame; frame <= mComputedEndFrame; frame++)
-        {
-            // Relative frame
-            int relativeFrame = frame - mComputedStartFrame;
-
-            // Do it only when layers were extracted for this frame
-            if(mGPUSurfaces.at(relativeFrame)->layersExtracted())
-            {
-                // Calculate layer of atoms in rage for that frame
-                float avgLayer = 0;
-                float invAvgLayer = 0;
-                for(int atomIndex = current.startIndex; atomIndex <= current.endIndex; atomIndex++)
-                {
-                    // Get layer of that atom
-                    int layer = mGPUSurfaces.at(relativeFrame)->getLayerOfAtom(atomIndex);
-                    int invLayer = (mGPUSurfaces.at(relativeFrame)->getLayerCount() - 1) - layer;
-
-                    // Accumulate for average layer calculation
-                    avgLayer += (float)layer;
-                    invAvgLayer += (float)invLayer;
-                }
-                current.averageLayers.at(relativeFrame) = avgLayer / (float)((current.endIndex - current.startIndex) + 1); // divide through count of atoms
-                current.inverseAverageLayers.at(relativeFrame) = invAvgLayer / (float)((current.endIndex - current.startIndex) + 1); // divide through count of atoms
-            }
-        }
-
-        // Store deltas to vectors
-        current.averageLayersDelta = std::vector<float>(current.averageLayers.size() - 1, -1.f); // minus one means no data
-        current.inverseAverageLayersDelta = std::vector<float>(current.inverseAverageLayers.size() - 1, -1.f); // minus one means no data
-
-        // Average layers delta accumulation
-        current.averageLayersDeltaAccumulation = 0.f;
-        for(int i = 0; i < current.averageLayers.size() - 1; i++)
-        {
-            // Continue if any avg is not ok
-            if(current.averageLayers.at(i) < 0 || current.averageLayers.at(i+1) < 0)
-            {
-                mAminoAcidAnalysis.push_back(AminoAcidAnalysis());
-                continue;
-            }
-
-            float delta = current.averageLayers.at(i + 1) - current.averageLayers.at(i);
-            delta = delta < 0 ? -delta : delta;
-            current.averageLayersDelta.at(i) = delta;
-            current.averageLayersDeltaAccumulation += delta;
-        }
-
-        // Inverse average delta accumulation
-        current.inverseAverageLayersDeltaAccumulation = 0.f;
-        for(int i = 0; i < current.inverseAverageLayers.size() - 1; i++)
-        {
-            // Continue if any invAvg is not ok
-            if(current.inverseAverageLayers.at(i) < 0 || current.inverseAverageLayers.at(i+1) < 0)
-            {
-                mAminoAcidAnalysis.push_back(AminoAcidAnalysis());
-                continue;
-            }
-
-            float delta = current.inverseAverageLayers.at(i + 1) - current.inverseAverageLayers.at(i);
-            delta = delta < 0 ? -delta : delta;
-            current.inverseAverageLayersDelta.at(i) = delta;
-            current.inverseAverageLayersDeltaAccumulation += delta;
-        }
-
-        // Push back result
-        mAminoAcidAnalysis.push_back(current);
-    }
-
-    // Fill buffer for residue surface proximity rendering with smoothed delta values
-    int aminoAcidCount = aminoAcids.size();
-    int localFrameCount = (mComputedEndFrame - mComputedStartFrame + 1);
+    // Finish analysis of layers accumulated per amino acid and get smoothed delta values for residue surface proximity rendering
     std::vector<GLfloat> smoothLayerDelta;
-    smoothLayerDelta.resize(aminoAcidCount * localFrameCount, 0.f); // amino acid count times count of computed frames
-
-    // Gaussian kernel
-    const GLfloat gaussian[] = { 0.06136f, 0.24477f, 0.38774f, 0.24477f, 0.06136f };
-
-    // Do it for each amino acid
-    for(int i = 0; i < aminoAcidCount; i++)
-    {
-        // Count of indices
-        int count = mAminoAcidAnalysis.at(i).averageLayersDelta.size();
-
-        // Go over frames for each amino acid
-        for(int j = 0; j < count; j++)
-        {
-            // Smooth delta (hardcoded for given gaussian kernel)
-            float value = 0;
-            for(int k = -2; k <= 2; k++)
-            {
-                // Check ranges
-                int index = j + k;
-                if(index < 0 || index >= count)
-                {
-                    continue;
-                }
-
-                // Add up value
-                value += mAminoAcidAnalysis.at(i).averageLayersDelta.at(index) * gaussian[k + 2];
-            }
-
-            // Push back value to smoothed vector
-            smoothLayerDelta.at((i * localFrameCount) + j + 1) = value; // add one because at first frame no delta available but it is much easier to have local frame count many entries
-        }
-    }
+    finishAminoAcidsAnalysis(mAminoAcidAnalysis, smoothLayerDelta);
 
     // Fill values into GPUBuffer
     mupLayersDeltaBuffer->fill(smoothLayerDelta, GL_DYNAMIC_DRAW);
@@ -3199,6 +3166,68 @@ GLuint SurfaceDynamicsVisualization::createCubemapTexture(
     return texture;
 }
 
+void SurfaceDynamicsVisualization::writeLoadedSnapshot()
+{
+    // Snapshot would miss frames which could not be loaded
+    if(mupGPUProtein->getFrameCount() == mupGPUProtein->getTotalFrameCount())
+    {
+        // Trajectory of protein is shared with GPU protein as long as order of atoms is kept. Otherwise, loaded frames
+        // are gathered back into order of files
+        std::shared_ptr<Trajectory> spTrajectory = mupLoadingProtein->getTrajectory();
+        int atomCount = spTrajectory->getAtomCount();
+        for(int frame = spTrajectory->getFrameCount(); frame < mupGPUProtein->getFrameCount(); frame++)
+        {
+            Trajectory::FrameSpan positions = mupGPUProtein->getFrame(frame);
+            glm::vec3* pPositions = spTrajectory->addFrames(1);
+            for(int i = 0; i < atomCount; i++)
+            {
+                pPositions[mupGPUProtein->getOriginalIndex(i)] = positions[i];
+            }
+        }
+
+        // Write snapshot
+        Logger::instance().print("Write snapshot of loaded trajectory..");
+        ProteinSnapshot::write(mLoadingSnapshotFilepath, mupLoadingProtein.get(), mLoadingAtomIndices, mLoadingSourceKey);
+        Logger::instance().print("..done");
+    }
+
+    // Protein is not needed anymore
+    mupLoadingProtein.reset();
+    mLoadingAtomIndices.clear();
+}
+
+void SurfaceDynamicsVisualization::updatePaths()
+{
+    // Path of group as a whole
+    std::vector<std::vector<GLuint> > atomGroups;
+    std::vector<Path*> paths;
+    atomGroups.push_back(std::vector<GLuint>(mAnalyseGroup.begin(), mAnalyseGroup.end()));
+    paths.push_back(mupPath.get());
+
+    // Path of each residue with atoms in group. Atoms of residue form a range of indices
+    int residueCount = 0;
+    for(const auto& rAminoAcid : mupGPUProtein->getAminoAcids())
+    {
+        std::vector<GLuint> atomIndices;
+        for(auto it = mAnalyseGroup.lower_bound((GLuint)rAminoAcid.startIndex); it != mAnalyseGroup.end() && (int)*it <= rAminoAcid.endIndex; it++)
+        {
+            atomIndices.push_back(*it);
+        }
+        if(atomIndices.empty()) { continue; }
+        if(residueCount == (int)mResiduePaths.size())
+        {
+            mResiduePaths.push_back(std::unique_ptr<Path>(new Path()));
+        }
+        atomGroups.push_back(atomIndices);
+        paths.push_back(mResiduePaths.at(residueCount).get());
+        residueCount++;
+    }
+    mResiduePaths.resize(residueCount);
+
+    // Compute all paths in one pass over trajectory
+    Path::update(mupGPUProtein.get(), atomGroups, mPathSmoothRadius, paths);
+}
+
 void SurfaceDynamicsVisualization::resetPath(std::string& rPath, std::string appendage) const
 {
     // Fetch directory for saving bookmarks etc.
@@ -3216,7 +3245,7 @@ int main(int argc, char* argv[])
 {
     if(argc < 2)
     {
-        Logger::instance().print("Please give PDB and optional XTC file as argument");
+        Logger::instance().print("Please give PDB, mmCIF or GRO and optional XTC, TRR or DCD file as argument, optionally followed by precision of compressed trajectory in angstrom and start frame, stop frame and stride of loaded frames");
     }
     else
     {
@@ -3227,9 +3256,31 @@ int main(int argc, char* argv[])
         {
             filepathXTC = argv[2];
         }
+        float compressionPrecision = 0.f;
+        if(argc >= 4)
+        {
+            compressionPrecision = (float)std::atof(argv[3]);
+        }
+
+        // Extract range of frames to load
+        int startFrame = 0;
+        int stopFrame = -1;
+        int frameStride = 1;
+        if(argc >= 5)
+        {
+            startFrame = std::atoi(argv[4]);
+        }
+        if(argc >= 6)
+        {
+            stopFrame = std::atoi(argv[5]);
+        }
+        if(argc >= 7)
+        {
+            frameStride = std::atoi(argv[6]);
+        }
 
         // Create application and enter loop
-        SurfaceDynamicsVisualization detection(filepathPDB, filepathXTC);
+        SurfaceDynamicsVisualization detection(filepathPDB, filepathXTC, compressionPrecision, startFrame, stopFrame, frameStride);
         detection.renderLoop();
     }
 
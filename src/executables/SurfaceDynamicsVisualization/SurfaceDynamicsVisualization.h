@@ -18,6 +18,9 @@
 #include "Framebuffer.h"
 #include "Path.h"
 #include "SurfaceExtraction/GPUHullSamples.h"
+#include "SurfaceExtraction/Ascension.h"
+#include "SurfaceExtraction/AminoAcidsAnalysis.h"
+#include "SurfaceExtraction/GroupAnalysis.h"
 #include "Utils/Logger.h"
 #include "SurfaceExtraction/GPURenderTexture.h"
 
@@ -39,8 +42,15 @@ class SurfaceDynamicsVisualization
 {
 public:
 
-    // Constructor
-    SurfaceDynamicsVisualization(std::string filepathPDB, std::string filepathXTC = "");
+    // Constructor. With compression precision above zero, trajectory is held compressed in memory.
+    // Only every stride-th frame of trajectory from start frame to stop frame (exclusive, negative means end) is loaded
+    SurfaceDynamicsVisualization(
+        std::string filepathPDB,
+        std::string filepathXTC = "",
+        float compressionPrecision = 0.f,
+        int startFrame = 0,
+        int stopFrame = -1,
+        int frameStride = 1);
 
     // Destructor
     virtual ~SurfaceDynamicsVisualization();
@@ -101,12 +111,18 @@ private:
     // Update global analysis
     void updateGlobalAnalysis();
 
-    // Update group analysis
+    // Update group analysis from running sums of group analysis
     void updateGroupAnalysis();
 
-    // Update amino acids analysis
+    // Update amino acids analysis from layers accumulated during computation
     void updateAminoAcidsAnaylsis();
 
+    // Update path of analysed group and paths of its residues in one pass over trajectory
+    void updatePaths();
+
+    // Write snapshot of complete trajectory after progressive loading is done, so next session does not load it again
+    void writeLoadedSnapshot();
+
     // Get whether frame was computed (otherwise prohibit doing thing which would go wrong)
     bool frameComputed() const { return (mFrame >= mComputedStartFrame) && (mFrame <= mComputedEndFrame); }
 
@@ -154,6 +170,14 @@ private:
     const bool mFrameLogging = false;
     const std::string mNoComputedFrameMessage = "Frame was not computed.";
     const GLuint mKBufferLayerCount = 32; // remember to adapt value in shaders as well
+    const unsigned long long mMaxTrajectoryBytesInMemory = 2ull << 30; // larger trajectories are streamed from disk
+    const bool mProgressiveLoading = true; // trajectory in memory is loaded in background while first frame is shown
+    const bool mSpatialAtomOrder = true; // atoms are sorted along Z-order curve on GPU, indices shown and saved are those of file
+    const int mStreamedCachedFrameCount = 256; // frames of streamed trajectory held in memory
+    const int mStreamedWindowFrameCount = 64; // frames of streamed trajectory held on GPU
+    const int mCompressionKeyframeInterval = 10; // frames from one keyframe to the next in compressed trajectory
+    const bool mStripWater = true; // water is not loaded, since it is not part of the molecule surface
+    const bool mStripIons = true; // ions are not loaded, since they are not part of the molecule surface
 
     // Colors for rendering layers (outer to inner, repeating if too many)
     const std::vector<glm::vec3> mLayerColors =
@@ -203,6 +227,7 @@ private:
     float mDepthDarkeningEnd = 500.f;
     bool mShowAnalysisWindow = true;
     bool mShowPath = true;
+    bool mShowResiduePaths = false; // show paths of residues in group in addition to path of group
     int mPathFrameRadius = 5; // radius of frames which are visualized
     int mPathSmoothRadius = 0; // radius of frames which are used for smoothing the path
     Rendering mRendering = HULL;
@@ -234,6 +259,10 @@ private:
 
     // Molecule and surface
     std::unique_ptr<GPUProtein> mupGPUProtein; // protein on GPU
+    std::unique_ptr<Protein> mupLoadingProtein; // protein while its trajectory is loaded progressively, empty otherwise
+    std::vector<int> mLoadingAtomIndices; // indices of atoms of loading protein in source files
+    std::string mLoadingSnapshotFilepath; // path of snapshot with complete trajectory
+    uint64_t mLoadingSourceKey = 0; // key of structure and trajectory file
     std::unique_ptr<GPUSurfaceExtraction> mupGPUSurfaceExtraction;  // factory for GPUSurfaces
                                                                     // (unique pointer because has to be constructed after OpenGL initialization)
     std::vector<std::unique_ptr<GPUSurface> > mGPUSurfaces; // vector with surfaces
@@ -249,7 +278,12 @@ private:
     // State
     std::string mPDBFilepath = "";
     std::string mXTCFilepath = "";
+    float mCompressionPrecision = 0.f; // zero means no compression
+    int mLoadStartFrame = 0; // first frame of trajectory file which is loaded
+    int mLoadStopFrame = -1; // frame of trajectory file where loading stops, negative means end of file
+    int mLoadFrameStride = 1; // only every stride-th frame of trajectory file is loaded
     int mFrame = 0; // do not set it directly, let it be done by setFrame() method!
+    int mTrajectoryWindowStart = 0; // first frame of trajectory on GPU, given to shaders
     int mLayer = 0;
     float mFramePlayTime = 0; // time of displaying a molecule state at playing the animation
     int mComputedStartFrame = -1;
@@ -264,6 +298,7 @@ private:
 
     // Ascension
     std::unique_ptr<GPUBuffer<GLfloat> > mupAscension; // values have range [0..2Pi]
+    std::unique_ptr<Ascension> mupAscensionComputation; // keeps surface bitsets of computed frames
 
     // Cubemaps
     GLuint mScientificCubemapTexture;
@@ -280,6 +315,9 @@ private:
     // Analysis
     std::unique_ptr<GPUHullSamples> mupHullSamples;
     std::set<GLuint> mAnalyseGroup;
+    std::unique_ptr<GroupAnalysis> mupGroupAnalysis; // running sums, edited together with analyse group
+    std::vector<std::vector<int> > mLayersOfAtoms; // layers of all atoms for each computed frame
+    std::vector<int> mLayerCounts; // count of layers for each computed frame
     std::unique_ptr<GPUBuffer<GLfloat> > mupGroupIndicators; // zero for atoms which are not in group
     int mNextAnalyseAtomIndex = 0;
     std::vector<float> mAnalysisSurfaceAmount;
@@ -289,6 +327,7 @@ private:
     std::vector<float> mAnalysisGroupSurfaceAmount;
     std::vector<float> mAnalysisGroupSurfaceArea;
     std::unique_ptr<Path> mupPath;
+    std::vector<std::unique_ptr<Path> > mResiduePaths; // paths of residues with atoms in analysed group
     std::string mSurfaceIndicesFilePath = "";
     std::string mGlobalAnalysisFilePath = "";
     std::string mGroupAnalysisFilePath = "";
@@ -317,18 +356,6 @@ private:
     int mAscensionHelperHeight = 0;
 
     // Amino acid calculations
-    struct AminoAcidAnalysis
-    {
-        std::string name = "";
-        int startIndex = -1;
-        int endIndex = -1;
-        float averageLayersDeltaAccumulation = -1;
-        float inverseAverageLayersDeltaAccumulation = -1;
-        std::vector<float> averageLayers;
-        std::vector<float> inverseAverageLayers;
-        std::vector<float> averageLayersDelta;
-        std::vector<float> inverseAverageLayersDelta;
-    };
     std::vector<AminoAcidAnalysis> mAminoAcidAnalysis;
 
 };
@@ -0,0 +1,225 @@
+//============================================================================
+// Distributed under the MIT License. Author: Raphael Menges
+//============================================================================
+
+// Headless comparison of surface extraction engines against sample based
+// ground truth. Writes one CSV row per molecule, probe radius and engine.
+
+#include "ShaderTools/Renderer.h"
+#include "SurfaceExtraction/GPUProtein.h"
+#include "SurfaceExtraction/GPUSurface.h"
+#include "SurfaceExtraction/GPUSurfaceExtraction.h"
+#include "SurfaceExtraction/SurfaceValidation.h"
+#include "Molecule/MDtrajLoader/MdTraj/MdTrajWrapper.h"
+#include "Molecule/MDtrajLoader/Data/Protein.h"
+#include "Utils/Logger.h"
+#include "text-csv/include/text/csv/ostream.hpp"
+#include <GLFW/glfw3.h>
+#include <dirent.h>
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <thread>
+
+// Namespace for text-csv
+namespace csv = ::text::csv;
+
+// Engine which is benchmarked
+struct Engine
+{
+    std::string name;
+    bool useCPU;
+    int CPUThreadCount;
+};
+
+// Settings of benchmark
+const std::vector<float> probeRadii = { 0.f, 1.4f, 3.f };
+const int frame = 0;
+const int repetitionCount = 3;
+const unsigned int sampleSeed = 0;
+const int samplesPerAtomCount = 50;
+
+// Collect all PDB files in given directory
+std::vector<std::string> collectPDBFiles(std::string directory)
+{
+    std::vector<std::string> filepaths;
+    DIR* pDirectory = opendir(directory.c_str());
+    if(pDirectory == NULL)
+    {
+        Logger::instance().print("Could not open directory: " + directory, Logger::Mode::ERROR);
+        return filepaths;
+    }
+    struct dirent* pEntry;
+    while((pEntry = readdir(pDirectory)) != NULL)
+    {
+        std::string filename(pEntry->d_name);
+        if(filename.size() > 4 && filename.substr(filename.size() - 4) == ".pdb")
+        {
+            filepaths.push_back(directory + "/" + filename);
+        }
+    }
+    closedir(pDirectory);
+
+    // Keep order independent from file system
+    std::sort(filepaths.begin(), filepaths.end());
+    return filepaths;
+}
+
+// Count atoms which are classified as surface by only one of both surfaces
+int countDisagreements(int atomCount, const std::vector<GLuint>& rSurfaceIndices, const std::vector<GLuint>& rOtherSurfaceIndices)
+{
+    std::vector<int> classification(atomCount, 0);
+    for(GLuint index : rSurfaceIndices) { classification.at(index) += 1; }
+    for(GLuint index : rOtherSurfaceIndices) { classification.at(index) += 2; }
+    int disagreements = 0;
+    for(int value : classification)
+    {
+        if(value == 1 || value == 2) { disagreements++; }
+    }
+    return disagreements;
+}
+
+int main(int argc, char* argv[])
+{
+    // Output file and molecules. Without home directory, output is written to working directory
+    const char* pHome = getenv("HOME");
+    std::string outputFilepath = "SurfaceExtractionBenchmark.csv";
+    if(pHome != NULL) { outputFilepath = std::string(pHome) + "/" + outputFilepath; }
+    std::vector<std::string> filepaths;
+    if(argc >= 2)
+    {
+        outputFilepath = argv[1];
+    }
+    if(argc >= 3)
+    {
+        for(int i = 2; i < argc; i++) { filepaths.push_back(argv[i]); }
+    }
+    else
+    {
+        filepaths = collectPDBFiles(std::string(RESOURCES_PATH) + "/molecules/PDB");
+    }
+
+    // Create invisible window since GPU engine needs OpenGL context
+    Logger::instance().print("Create hidden window..");
+    glfwInit();
+    glfwWindowHint(GLFW_VISIBLE, GL_FALSE);
+    GLFWwindow* pWindow = generateWindow("Surface Extraction Benchmark", 64, 64);
+    Logger::instance().print("..done");
+
+    // Engines to compare. First one is used as reference
+    std::vector<Engine> engines;
+    engines.push_back({"GPU", false, 1});
+    engines.push_back({"CPU-1", true, 1});
+    int hardwareThreadCount = (int)std::thread::hardware_concurrency();
+    if(hardwareThreadCount > 1)
+    {
+        engines.push_back({"CPU-" + std::to_string(hardwareThreadCount), true, hardwareThreadCount});
+    }
+
+    // Prepare output
+    std::ofstream fs(outputFilepath, std::ios_base::out); // overwrite existing
+    csv::csv_ostream csvs(fs);
+    csvs << "Molecule" << "AtomCount" << "ProbeRadius" << "Engine" << "AverageTime" << "InternalAtoms" << "SurfaceAtoms"
+        << "DisagreementsWithReference" << "UnclassifiedAtom" << "InternalSampleFailures" << "MaybeIncorrectSurfaceAtoms";
+    csvs << csv::endl;
+
+    // Extraction object
+    GPUSurfaceExtraction extraction;
+
+    // Python interpreter is shared by all molecules and started on first use
+    MdTrajWrapper& mdwrap = MdTrajWrapper::instance();
+
+    // Go over molecules
+    for(const std::string& rFilepath : filepaths)
+    {
+        Logger::instance().print("Benchmark molecule: " + rFilepath);
+        Logger::instance().tabIn();
+
+        // Load molecule
+        std::vector<std::string> paths;
+        paths.push_back(rFilepath);
+        std::unique_ptr<Protein> upProtein = std::move(mdwrap.load(paths));
+        std::unique_ptr<GPUProtein> upGPUProtein = std::unique_ptr<GPUProtein>(new GPUProtein(upProtein.get()));
+        int atomCount = upGPUProtein->getAtomCount();
+
+        // Go over probe radii
+        for(float probeRadius : probeRadii)
+        {
+            Logger::instance().print("Probe radius: " + std::to_string(probeRadius));
+            std::vector<GLuint> referenceSurfaceIndices;
+
+            // Go over engines
+            for(int engineIndex = 0; engineIndex < (int)engines.size(); engineIndex++)
+            {
+                const Engine& rEngine = engines.at(engineIndex);
+
+                // Execute engine multiple times and keep last surface
+                std::unique_ptr<GPUSurface> upGPUSurface;
+                float accTime = 0;
+                for(int i = 0; i < repetitionCount; i++)
+                {
+                    upGPUSurface = extraction.calculateSurface(
+                        upGPUProtein.get(),
+                        frame,
+                        probeRadius,
+                        false,
+                        rEngine.useCPU,
+                        rEngine.CPUThreadCount);
+                    accTime += upGPUSurface->getComputationTime();
+                }
+
+                // Compare with reference engine
+                std::vector<GLuint> surfaceIndices = upGPUSurface->getSurfaceIndices(0);
+                if(engineIndex == 0) { referenceSurfaceIndices = surfaceIndices; }
+                int disagreements = countDisagreements(atomCount, referenceSurfaceIndices, surfaceIndices);
+
+                // Compare with sample based ground truth
+                int internalSampleFailures = 0;
+                std::vector<GLuint> maybeIncorrectSurfaceAtomIndices;
+                int unclassifiedAtom = SurfaceValidation::validateClassification(
+                    *(upGPUProtein->getRadii()),
+                    upGPUProtein->getFrame(frame),
+                    upGPUSurface->getInputIndices(0),
+                    upGPUSurface->getInternalIndices(0),
+                    surfaceIndices,
+                    probeRadius,
+                    sampleSeed,
+                    samplesPerAtomCount,
+                    internalSampleFailures,
+                    maybeIncorrectSurfaceAtomIndices);
+
+                // Tell user
+                Logger::instance().print(
+                    rEngine.name + ": "
+                    + std::to_string(accTime / repetitionCount) + "ms, "
+                    + std::to_string(disagreements) + " disagreements");
+
+                // Write row
+                csvs << rFilepath;
+                csvs << std::to_string(atomCount);
+                csvs << std::to_string(probeRadius);
+                csvs << rEngine.name;
+                csvs << std::to_string(accTime / repetitionCount);
+                csvs << std::to_string(upGPUSurface->getCountOfInternalAtoms(0));
+                csvs << std::to_string(upGPUSurface->getCountOfSurfaceAtoms(0));
+                csvs << std::to_string(disagreements);
+                csvs << std::to_string(unclassifiedAtom);
+                csvs << std::to_string(internalSampleFailures);
+                csvs << std::to_string(maybeIncorrectSurfaceAtomIndices.size());
+                csvs << csv::endl;
+            }
+        }
+
+        Logger::instance().tabOut();
+    }
+
+    // Tell user
+    Logger::instance().print("Saved file: " + outputFilepath);
+
+    // Clean up
+    glfwDestroyWindow(pWindow);
+    glfwTerminate();
+
+    // Exit
+    return 0;
+}
@@ -1,11 +1,12 @@
 // Fill out your copyright notice in the Description page of Project Settings.
 
 #include "Atom.h"
+#include "Protein.h"
+#include "Trajectory.h"
 
-Atom::Atom(std::string name, std::string element, int index, glm::vec3 position, std::string aminoDistinctAcid, std::string amino, Protein* parent) :
-name_(name), element_(element), index_(index), aminoDistinctAcid_(aminoDistinctAcid), amino_(amino), pParent_(parent)
+Atom::Atom(int tableIndex, Protein* parent) :
+tableIndex_(tableIndex), pParent_(parent)
 {
-    positions_.push_back(position);
 }
 
 Atom::~Atom()
@@ -13,100 +14,102 @@ Atom::~Atom()
 }
 
 int Atom::getIndex() {
-    return index_;
+    return pParent_->getAtomTable()->at(tableIndex_).index;
 }
 
 std::string Atom::getName() {
-    return name_;
+    return pParent_->getStrings()->get(pParent_->getAtomTable()->at(tableIndex_).name);
 }
 
 std::string Atom::getElement() const
 {
-    return element_;
+    return pParent_->getStrings()->get(pParent_->getAtomTable()->at(tableIndex_).element);
+}
+
+int Atom::getTableIndex() const
+{
+    return tableIndex_;
 }
 
 std::string Atom::getAmino() {
-    return amino_;
+    return pParent_->getStrings()->get(pParent_->getAtomTable()->at(tableIndex_).amino);
 }
 
 std::string Atom::getDistinctResidue() {
-    return aminoDistinctAcid_;
+    return pParent_->getStrings()->get(pParent_->getAtomTable()->at(tableIndex_).distinctResidue);
 }
 
 glm::vec3 Atom::getPosition() const{
-    return positions_.at(0);
+    return pParent_->getTrajectory()->getFrameData(0)[tableIndex_];
 }
 
 glm::vec3 Atom::getPositionAtFrame(int i) {
-    return positions_.at(i);
+    return pParent_->getTrajectory()->getFrameData(i)[tableIndex_];
 }
 
 float Atom::getX() {
-    return positions_.at(0).x;
+    return pParent_->getTrajectory()->getFrameData(0)[tableIndex_].x;
 }
 
 float Atom::getY() {
-    return positions_.at(0).y;
+    return pParent_->getTrajectory()->getFrameData(0)[tableIndex_].y;
 }
 
 float Atom::getZ() {
-    return positions_.at(0).z;
+    return pParent_->getTrajectory()->getFrameData(0)[tableIndex_].z;
 }
 
 float Atom::getXAtFrame(int i) {
-    return positions_.at(i).x;
+    return pParent_->getTrajectory()->getFrameData(i)[tableIndex_].x;
 }
 
 float Atom::getYAtFrame(int i) {
-    return positions_.at(i).y;
+    return pParent_->getTrajectory()->getFrameData(i)[tableIndex_].y;
 }
 
 float Atom::getZAtFrame(int i) {
-    return positions_.at(i).z;
-}
-
-void Atom::setNextPosition(glm::vec3 pos) {
-    positions_.push_back(pos);
-}
-
-void Atom::addBondPartner(Atom* partner)
-{
-    bonds_.push_back(partner);
+    return pParent_->getTrajectory()->getFrameData(i)[tableIndex_].z;
 }
 
 std::vector<Atom*> Atom::getBondPartners()
 {
-    return bonds_;
+    std::vector<Atom*> partners;
+    int count = pParent_->getBondPartnerCount(tableIndex_);
+    partners.reserve(count);
+    for (int i = 0; i < count; i++) {
+        partners.push_back(pParent_->getAtomAt(pParent_->getBondPartnerAt(tableIndex_, i)));
+    }
+    return partners;
 }
 
 int Atom::getCountOfFrames() const
 {
-    return positions_.size();
+    return pParent_->getTrajectory()->getFrameCount();
 }
 
 void Atom::setX(float x)
 {
-    positions_.at(0).x = x;
+    pParent_->getTrajectory()->getFrameData(0)[tableIndex_].x = x;
 }
 
 void Atom::setY(float y)
 {
-    positions_.at(0).y = y;
+    pParent_->getTrajectory()->getFrameData(0)[tableIndex_].y = y;
 }
 
 void Atom::setZ(float z)
 {
-    positions_.at(0).z = z;
+    pParent_->getTrajectory()->getFrameData(0)[tableIndex_].z = z;
 }
 
 void Atom::setXYZ(glm::vec3 xyz)
 {
-    positions_.at(0) = xyz;
+    pParent_->getTrajectory()->getFrameData(0)[tableIndex_] = xyz;
 }
 
 void Atom::setXYZat(int frame, glm::vec3 xyz)
 {
-    positions_.at(frame) = xyz;
+    pParent_->getTrajectory()->getFrameData(frame)[tableIndex_] = xyz;
 }
 
 Protein* Atom::getProteinParent() {
@@ -10,7 +10,10 @@ class Protein;
 class Atom
 {
 public:
-    Atom(std::string name, std::string element, int index, glm::vec3 position, std::string aminoDistinctAcid, std::string amino, Protein* parent);
+    /**
+    @brief atom is a view on row of atom table and trajectory of parent, it holds no data itself
+    */
+    Atom(int tableIndex, Protein* parent);
     ~Atom();
 
     /**
@@ -31,6 +34,12 @@ public:
     */
     std::string getElement() const;
 
+    /**
+    @brief returns index of this Atom in atom table and trajectory of parent
+    @param [out] int index in tables of parent
+    */
+    int getTableIndex() const;
+
     /**
     @brief returns just the aminoacid e.g. MET
     @param [out] string aminoacid the Atom belongs to
@@ -93,7 +102,7 @@ public:
     glm::vec3 getPositionAtFrame(int i);
 
     /**
-    @brief returns list of all Atom ptrs to which current Atom is bounded
+    @brief returns list of all Atom ptrs to which current Atom is bounded, looked up in bond graph of parent
     @param [out] vector<Atom*> all Atoms to which current Atom is bounded
     */
     std::vector<Atom*> getBondPartners();
@@ -104,12 +113,8 @@ public:
     void setXYZ(glm::vec3 xyz);
     void setXYZat(int frame, glm::vec3 xyz);
 
-    void setNextPosition(glm::vec3 pos);
-
     //void setActor(AAtom_Actor* a);
 
-    void addBondPartner(Atom*);
-
     /**
     @brief returns the count of frames
     @param [out] int count of positions in animation for this Atom
@@ -118,16 +123,8 @@ public:
 
 
 private:
-    int index_;
-
-    std::string name_; //the letter e.g. N
-    std::string element_; //the whole name e.g. Nitrogen
-    std::string amino_; //the amino where it belongs to e.g. MET
-    std::string aminoDistinctAcid_; // the disting amino where it belongs to e.g. MET1
-
-    std::vector<glm::vec3> positions_; //every position per frame, [0] is pdb and [1] starts first frame
+    int tableIndex_; //index of row in atom table and of positions in trajectory of parent
 
-    std::vector<Atom*> bonds_; //all bonded partners
     //AAtom_Actor* pActor_;
     Protein* pParent_;
 };
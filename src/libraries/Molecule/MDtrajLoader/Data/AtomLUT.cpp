@@ -17,6 +17,25 @@ AtomLUT::radiiMap AtomLUT::vdW_radii_picometer = {
     {"xenon",216 }, {"zinc",139 }
 };
 
+AtomLUT::nameMap AtomLUT::element_names = {
+    {"H", "hydrogen"}, {"D", "hydrogen"}, {"HE", "helium"}, {"LI", "lithium"},
+    {"BE", "beryllium"}, {"B", "boron"}, {"C", "carbon"}, {"N", "nitrogen"},
+    {"O", "oxygen"}, {"F", "fluorine"}, {"NE", "neon"}, {"NA", "sodium"},
+    {"MG", "magnesium"}, {"AL", "aluminium"}, {"SI", "silicon"}, {"P", "phosphorus"},
+    {"S", "sulfur"}, {"CL", "chlorine"}, {"AR", "argon"}, {"K", "potassium"},
+    {"CA", "calcium"}, {"SC", "scandium"}, {"TI", "titanium"}, {"V", "vanadium"},
+    {"CR", "chromium"}, {"MN", "manganese"}, {"FE", "iron"}, {"CO", "cobalt"},
+    {"NI", "nickel"}, {"CU", "copper"}, {"ZN", "zinc"}, {"GA", "gallium"},
+    {"GE", "germanium"}, {"AS", "arsenic"}, {"SE", "selenium"}, {"BR", "bromine"},
+    {"KR", "krypton"}, {"RB", "rubidium"}, {"SR", "strontium"}, {"MO", "molybdenum"},
+    {"PD", "palladium"}, {"AG", "silver"}, {"CD", "cadmium"}, {"IN", "indium"},
+    {"SN", "tin"}, {"SB", "antimony"}, {"TE", "tellurium"}, {"I", "iodine"},
+    {"XE", "xenon"}, {"CS", "caesium"}, {"BA", "barium"}, {"PT", "platinum"},
+    {"AU", "gold"}, {"HG", "mercury"}, {"TL", "thallium"}, {"PB", "lead"},
+    {"BI", "bismuth"}, {"PO", "polonium"}, {"AT", "astatine"}, {"RN", "radon"},
+    {"FR", "francium"}, {"RA", "radium"}, {"U", "uranium"}
+};
+
 AtomLUT::colorMap AtomLUT::cpk_colorcode = {
     {"hydrogen", AtomLUT::color{1.f, 1.f, 1.f}}, {"carbon", AtomLUT::color{200.f/255.f, 200.f/255.f, 200.f/255.f}},
     {"nitrogen", AtomLUT::color{143.f/255.f, 143.f/255.f, 1.f}}, {"oxygen", AtomLUT::color{240.f/255.f, 0.f, 0.f}},
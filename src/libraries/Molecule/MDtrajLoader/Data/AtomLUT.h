@@ -2,6 +2,7 @@
 #define ATOMLUT_H
 
 #include <map>
+#include <string>
 
 /**
  * @brief The AtomLUT class
@@ -19,9 +20,11 @@ public:
 
     typedef std::map< std::string, int> radiiMap;
     typedef std::map< std::string, color> colorMap;
+    typedef std::map< std::string, std::string> nameMap;
     static radiiMap vdW_radii_picometer;
     static colorMap cpk_colorcode;
     static colorMap amino_colorcode;
+    static nameMap element_names; // upper case symbol to element name
 
     static color fetchAminoColor(std::string name);
 };
@@ -5,10 +5,15 @@
 
 Protein::Protein(std::vector<std::string> &names,
                  std::vector<std::string> &elementNames, std::vector<std::string> &residueNames,
-                 std::vector<int> &indices, std::vector<std::string> &bonds, std::vector<std::vector<glm::vec3>> &positions,
+                 std::vector<int> &indices, std::vector<std::string> &bonds, std::shared_ptr<Trajectory> trajectory,
                  std::string name, int numAtoms, std::vector<std::string> &distinctResidueNames, std::vector<float> &radii)
 {
+    name_ = name;
     radii_ = radii;
+    trajectory_ = trajectory; //positions are not copied, atoms read them from the trajectory
+    strings_ = std::shared_ptr<StringTable>(new StringTable);
+    atomTable_.reserve(names.size());
+    atoms_.reserve(names.size());
     std::string old = distinctResidueNames.at(0);
     std::string newer = distinctResidueNames.at(0);
     std::vector<Atom*> atomVector;
@@ -29,10 +34,26 @@ Protein::Protein(std::vector<std::string> &names,
 
 
     for (int i = 0; i < names.size(); i++) {
-        distinctResidueNames.at(i);
-        std::string tmpstr = distinctResidueNames.at(i);
-        std::string amino = tmpstr.substr(0, 3);
-        Atom* a = new Atom(names.at(i), elementNames.at(i), indices.at(i), positions[0][i], distinctResidueNames.at(i), amino, this);
+        //strings are interned, the atom table only holds their ids
+        const std::string& tmpstr = distinctResidueNames.at(i);
+        AtomRecord record;
+        record.index = indices.at(i);
+        record.name = strings_->intern(names.at(i));
+        record.element = strings_->intern(elementNames.at(i));
+        record.amino = strings_->intern(tmpstr.substr(0, 3));
+        record.distinctResidue = strings_->intern(tmpstr);
+        atomTable_.push_back(record);
+        Atom* a = new Atom(i, this);
+
+        //consecutive atoms of same distinct residue form a range
+        if (residueRanges_.empty() || residueRanges_.back().distinctResidue != record.distinctResidue) {
+            ResidueRange range;
+            range.firstAtom = i;
+            range.atomCount = 0;
+            range.distinctResidue = record.distinctResidue;
+            residueRanges_.push_back(range);
+        }
+        residueRanges_.back().atomCount++;
 
         Protein::atoms_.push_back(a);
         newer = distinctResidueNames.at(i);
@@ -53,16 +74,44 @@ Protein::Protein(std::vector<std::string> &names,
         aminoAcids.insert(residueNames.at(i));
     }
 
-    // positions per frame
-    for (int i = 0; i < positions[0].size(); i++) {
-        for (int j = 1; j < positions.size();j++) {
-            atoms_[i]->setNextPosition(positions[j][i]);
-        }
-    }
-
     diffAminos_.assign(aminoAcids.begin(), aminoAcids.end());
 
-    //setBonds(bonds); //slow
+    setBonds(bonds);
+}
+
+Protein::Protein(std::shared_ptr<StringTable> strings, std::vector<AtomRecord> &atomTable,
+                 std::vector<ResidueRange> &residueRanges, std::vector<std::string> &diffAminos,
+                 std::vector<int> &bondOffsets, std::vector<int> &bondPartners,
+                 std::shared_ptr<Trajectory> trajectory, std::string name, std::vector<float> &radii)
+{
+    //topology is taken over as it is
+    name_ = name;
+    strings_ = strings;
+    trajectory_ = trajectory;
+    atomTable_.swap(atomTable);
+    residueRanges_.swap(residueRanges);
+    diffAminos_.swap(diffAminos);
+    bondOffsets_.swap(bondOffsets);
+    bondPartners_.swap(bondPartners);
+    radii_.swap(radii);
+    numAtoms_ = atomTable_.size();
+
+    minMax();
+
+    //atoms only refer to their row of the atom table
+    atoms_.reserve(numAtoms_);
+    for (int i = 0; i < numAtoms_; i++) {
+        atoms_.push_back(new Atom(i, this));
+    }
+
+    //sequence and atoms of residues from their ranges
+    aminoNames_.reserve(residueRanges_.size());
+    for (const ResidueRange &range : residueRanges_) {
+        const std::string &distinctResidue = strings_->get(range.distinctResidue);
+        aminoNames_.push_back(distinctResidue);
+        std::vector<Atom*> &residueAtoms = aminoAndItsAtoms_[distinctResidue];
+        residueAtoms.insert(residueAtoms.end(), atoms_.begin() + range.firstAtom, atoms_.begin() + range.firstAtom + range.atomCount);
+    }
 }
 
 Protein::~Protein()
@@ -79,6 +128,38 @@ std::string Protein::getName() {
     return name_;
 }
 
+std::shared_ptr<Trajectory> Protein::getTrajectory() {
+    return trajectory_;
+}
+
+const std::vector<Protein::AtomRecord>* Protein::getAtomTable() const {
+    return &atomTable_;
+}
+
+const std::vector<Protein::ResidueRange>* Protein::getResidueRanges() const {
+    return &residueRanges_;
+}
+
+std::shared_ptr<const StringTable> Protein::getStrings() const {
+    return strings_;
+}
+
+int Protein::getBondPartnerCount(int i) {
+    return bondOffsets_.at(i + 1) - bondOffsets_.at(i);
+}
+
+int Protein::getBondPartnerAt(int i, int j) {
+    return bondPartners_.at(bondOffsets_.at(i) + j);
+}
+
+std::vector<int>* Protein::getBondOffsets() {
+    return &bondOffsets_;
+}
+
+std::vector<int>* Protein::getBondPartners() {
+    return &bondPartners_;
+}
+
 Atom* Protein::getAtomAt(int i) {
     return atoms_.at(i);
 }
@@ -148,66 +229,51 @@ float Protein::getRadiusAt(int i)
 
 //---------------------------------------------private
 
-void Protein::setBonds(std::vector<std::string> bonds) {
-
-    for (int b = 0; b < bonds.size(); b++) {
-        //bonds cutting the atom names and amino names
-        std::string bond = bonds[b];
-        //get both bond partners
-        int posKomma = bond.find(",");
-        std::string bond1 = bond.substr(1, posKomma - 1);
-        std::string bond2 = bond.substr(posKomma + 2);
-        //get amino name and atom name from both partners
-        int posStrich = bond1.find("-");
-        std::string bond1Amino = bond1.substr(0, posStrich);
-        std::string bond1Atom = bond1.erase(0, posStrich + 1);
-
-        posStrich = bond2.find("-");
-        std::string bond2Amino = bond2.substr(0, posStrich);
-        //FString happyStringBond2Amino = bond2Amino.c_str();
-        bond2.erase(0, posStrich + 1);
-        int posKlammer = bond2.find(")");
-        std::string bond2Atom = bond2.substr(0, posKlammer);
-
-
-        //search for the two appropriate atoms with distinct aminos from the bond
-        //find all atoms_, that have distinct amino from bond 1 and 2
-        std::vector<Atom*> atomsBond1Amino;
-        for (int i = 0; i < atoms_.size(); i++) {
-            if (atoms_[i]->getDistinctResidue() == bond1Amino) {
-                atomsBond1Amino.push_back(atoms_[i]);
-            }
-        }
-        std::vector<Atom*> atomsBond2Amino;
-        for (int i = 0; i < atoms_.size(); i++) {
-            if (atoms_[i]->getDistinctResidue() == bond2Amino) {
-                atomsBond2Amino.push_back(atoms_[i]);
-            }
-        }
+void Protein::setBonds(const std::vector<std::string> &bonds) {
 
-        //find the specific atom with atom name from bond 1 and 2
-        Atom* atomBond1 = NULL;
-        for (int i = 0; i < atomsBond1Amino.size(); i++) {
-            if (atomsBond1Amino[i]->getName() == bond1Atom) {
-                atomBond1 = atomsBond1Amino[i];
-            }
-        }
-        Atom* atomBond2 = NULL;
-        for (int i = 0; i < atomsBond2Amino.size(); i++) {
-            if (atomsBond2Amino[i]->getName() == bond2Atom) {
-                atomBond2 = atomsBond2Amino[i];
-            }
-        }
+    //index atoms by "distinctResidue-name", which is the format of both bond partners e.g. "(MET1-N, MET1-CA)"
+    std::unordered_map<std::string, int> atomIndices;
+    atomIndices.reserve(atoms_.size());
+    for (int i = 0; i < (int)atomTable_.size(); i++) {
+        const AtomRecord& record = atomTable_[i];
+        atomIndices[strings_->get(record.distinctResidue) + "-" + strings_->get(record.name)] = i; //last atom wins, like before
+    }
 
-        //add each other to the bond list of the other
-        if (atomBond1 != NULL && atomBond2 != NULL) {
-            atomBond1->addBondPartner(atomBond2);
-            atomBond2->addBondPartner(atomBond1);
+    //look up both partners of each bond
+    std::vector<std::pair<int, int> > bondPairs;
+    bondPairs.reserve(bonds.size());
+    std::string key;
+    for (const std::string& bond : bonds) {
+        size_t posKomma = bond.find(",");
+        size_t posKlammer = bond.rfind(")");
+        if (posKomma == std::string::npos || posKlammer == std::string::npos || posKlammer < posKomma + 2) {
+            continue;
         }
-        else {
-            //UE_LOG(LogTemp, Error, TEXT("Toll gemacht, bond wurde verkackt!"));
+        key.assign(bond, 1, posKomma - 1);
+        auto it1 = atomIndices.find(key);
+        key.assign(bond, posKomma + 2, posKlammer - posKomma - 2);
+        auto it2 = atomIndices.find(key);
+        if (it1 != atomIndices.end() && it2 != atomIndices.end()) {
+            bondPairs.push_back(std::make_pair(it1->second, it2->second));
         }
+    }
+
+    //count partners per atom and sum up to offsets
+    bondOffsets_.assign(atoms_.size() + 1, 0);
+    for (const auto& pair : bondPairs) {
+        bondOffsets_[pair.first + 1]++;
+        bondOffsets_[pair.second + 1]++;
+    }
+    for (int i = 0; i < (int)atoms_.size(); i++) {
+        bondOffsets_[i + 1] += bondOffsets_[i];
+    }
 
+    //each atom gets the other one as partner
+    bondPartners_.resize(bondOffsets_.back());
+    std::vector<int> fill(bondOffsets_.begin(), bondOffsets_.end() - 1);
+    for (const auto& pair : bondPairs) {
+        bondPartners_[fill[pair.first]++] = pair.second;
+        bondPartners_[fill[pair.second]++] = pair.first;
     }
 
     numAtoms_ = atoms_.size();
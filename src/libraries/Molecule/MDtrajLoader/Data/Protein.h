@@ -3,11 +3,14 @@
 #pragma once
 
 #include "Atom.h"
+#include "Trajectory.h"
+#include "StringTable.h"
 #include <unordered_map>
 #include <vector>
 #include <string>
 #include <limits>
 #include <set>
+#include <memory>
 #include <glm/ext.hpp>
 
 /**
@@ -20,8 +23,19 @@ class Protein
 public:
     Protein(std::vector<std::string> &names,
         std::vector<std::string> &elementNames, std::vector<std::string> &residueNames,
-        std::vector<int> &indices, std::vector<std::string> &bonds, std::vector<std::vector<glm::vec3> > &positions,
+        std::vector<int> &indices, std::vector<std::string> &bonds, std::shared_ptr<Trajectory> trajectory,
         std::string name, int numAtoms, std::vector<std::string> &distinctResidue, std::vector<float> &radii);
+
+	struct AtomRecord;
+	struct ResidueRange;
+
+	/**
+	@brief constructor from compact topology, e.g. of a snapshot. Nothing is parsed, vectors are taken over
+	*/
+	Protein(std::shared_ptr<StringTable> strings, std::vector<AtomRecord> &atomTable,
+		std::vector<ResidueRange> &residueRanges, std::vector<std::string> &diffAminos,
+		std::vector<int> &bondOffsets, std::vector<int> &bondPartners,
+		std::shared_ptr<Trajectory> trajectory, std::string name, std::vector<float> &radii);
 	~Protein();
 
 	/**
@@ -36,9 +50,74 @@ public:
 	*/
 	Atom* getAtomAt(int i);
 
+	/**
+	@brief positions of all atoms for all frames, [0] is pdb and [1] starts first frame
+	@param [out] shared trajectory, which is not copied by consumers
+	*/
+	std::shared_ptr<Trajectory> getTrajectory();
+
+	/**
+	@brief row of atom table, strings are ids in string table of protein
+	*/
+	struct AtomRecord
+	{
+		int32_t index; //index from file
+		StringTable::Id name; //e.g. N
+		StringTable::Id element; //e.g. nitrogen
+		StringTable::Id amino; //e.g. MET
+		StringTable::Id distinctResidue; //e.g. MET1
+	};
+
+	/**
+	@brief topology of all atoms, row i belongs to the ith Atom
+	@param [out] vector of rows
+	*/
+	const std::vector<AtomRecord>* getAtomTable() const;
+
+	/**
+	@brief consecutive atoms of one distinct residue
+	*/
+	struct ResidueRange
+	{
+		int32_t firstAtom; //index of first Atom
+		int32_t atomCount; //count of Atoms
+		StringTable::Id distinctResidue; //e.g. MET1
+	};
+
+	/**
+	@brief ranges of all residues in order of the atoms
+	@param [out] vector of ranges
+	*/
+	const std::vector<ResidueRange>* getResidueRanges() const;
+
+	/**
+	@brief strings referred to by atom table
+	@param [out] shared string table
+	*/
+	std::shared_ptr<const StringTable> getStrings() const;
+
 	std::vector<Atom*>* getAtoms();
 	std::vector<Atom*>* getAtomsFromAmino(std::string name);    
 
+	/**
+	@brief count of atoms bonded to the ith Atom
+	@param [out] int count of bond partners
+	*/
+	int getBondPartnerCount(int i);
+
+	/**
+	@brief index of jth Atom bonded to the ith Atom
+	@param [out] int index of bond partner
+	*/
+	int getBondPartnerAt(int i, int j);
+
+	/**
+	@brief bond graph in compressed sparse row layout, partners of Atom i are
+	bondPartners[bondOffsets[i]] until bondPartners[bondOffsets[i + 1]] (exclusive)
+	*/
+	std::vector<int>* getBondOffsets();
+	std::vector<int>* getBondPartners();
+
 	std::vector<std::string>* getAminoNames();
 	std::vector<std::string>* getDiffAminos();
 
@@ -106,6 +185,12 @@ protected:
 
     std::vector<Atom*> atoms_; //list of all atoms
     std::vector<float> radii_; // list of all atom radii
+    std::shared_ptr<Trajectory> trajectory_; // positions of all atoms for all frames
+    std::vector<AtomRecord> atomTable_; // topology of all atoms
+    std::vector<ResidueRange> residueRanges_; // atoms of each residue
+    std::shared_ptr<StringTable> strings_; // strings of topology
+    std::vector<int> bondOffsets_; // offset of partners of each atom in bondPartners_, one more entry than atoms
+    std::vector<int> bondPartners_; // indices of bonded atoms, grouped by atom
 
 private:
 
@@ -119,6 +204,6 @@ private:
 	//key "distinctResidue", value "vector of its Atoms"
 	std::unordered_map<std::string, std::vector<Atom*>> aminoAndItsAtoms_;
 
-	void setBonds(std::vector<std::string> bonds);
+	void setBonds(const std::vector<std::string> &bonds);
 
 };
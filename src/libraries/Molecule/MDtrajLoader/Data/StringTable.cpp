@@ -0,0 +1,15 @@
+//============================================================================
+// Distributed under the MIT License. Author: Raphael Menges
+//============================================================================
+
+#include "StringTable.h"
+
+StringTable::Id StringTable::intern(const std::string& rString)
+{
+    auto it = mIds.find(rString);
+    if(it != mIds.end()) { return it->second; }
+    Id id = (Id)mStrings.size();
+    mStrings.push_back(rString);
+    mIds.emplace(rString, id);
+    return id;
+}
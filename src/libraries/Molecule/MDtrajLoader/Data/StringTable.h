@@ -0,0 +1,42 @@
+//============================================================================
+// Distributed under the MIT License. Author: Raphael Menges
+//============================================================================
+
+// Table of interned strings. Each distinct string is stored once and referred
+// to by a small integer id, so per atom data only holds ids. Lookups which
+// depend on the string are done once per id and then by array indexing.
+
+#ifndef STRING_TABLE_H
+#define STRING_TABLE_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+
+class StringTable
+{
+public:
+
+    // Id of strings
+    typedef uint32_t Id;
+
+    // Get id of string, adds string if not yet contained
+    Id intern(const std::string& rString);
+
+    // Get string of id
+    const std::string& get(Id id) const { return mStrings.at(id); }
+
+    // Get count of distinct strings, ids are in [0, size[
+    int size() const { return (int)mStrings.size(); }
+
+private:
+
+    // Strings indexed by id
+    std::vector<std::string> mStrings;
+
+    // Map from string to id
+    std::unordered_map<std::string, Id> mIds;
+};
+
+#endif // STRING_TABLE_H
@@ -0,0 +1,111 @@
+//============================================================================
+// Distributed under the MIT License. Author: Raphael Menges
+//============================================================================
+
+#include "Trajectory.h"
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <new>
+#include <string>
+
+static_assert(sizeof(glm::vec3) == 3 * sizeof(float), "Positions must be packed floats");
+
+const glm::vec3& Trajectory::FrameSpan::at(int i) const
+{
+    if(i < 0 || i >= mSize)
+    {
+        throw std::out_of_range("Atom index " + std::to_string(i) + " out of frame with " + std::to_string(mSize) + " atoms");
+    }
+    return mpData[i];
+}
+
+Trajectory::Trajectory(int atomCount)
+{
+    mAtomCount = atomCount;
+}
+
+Trajectory::~Trajectory()
+{
+    release();
+}
+
+bool Trajectory::setAtomCount(int atomCount)
+{
+    if(mFrameCount > 0 && atomCount != mAtomCount) { return false; }
+    if(atomCount != mAtomCount)
+    {
+        // Capacity was computed for other count of atoms
+        release();
+        mAtomCount = atomCount;
+    }
+    return true;
+}
+
+void Trajectory::reserve(int frameCount)
+{
+    ensureCapacity(frameCount);
+}
+
+void Trajectory::resize(int frameCount)
+{
+    ensureCapacity(frameCount);
+    if(frameCount > mFrameCount)
+    {
+        std::memset(mpData + getSize() * 3, 0, (size_t)(frameCount - mFrameCount) * mAtomCount * sizeof(glm::vec3));
+    }
+    mFrameCount = frameCount;
+}
+
+glm::vec3* Trajectory::addFrames(int frameCount)
+{
+    int firstFrame = mFrameCount;
+    resize(mFrameCount + frameCount);
+    return getFrameData(firstFrame);
+}
+
+void Trajectory::wrap(float* pData, int atomCount, int frameCount, std::shared_ptr<void> spOwner)
+{
+    release();
+    mpData = pData;
+    mAtomCount = atomCount;
+    mFrameCount = frameCount;
+    mFrameCapacity = frameCount;
+    mspOwner = spOwner;
+}
+
+Trajectory::FrameSpan Trajectory::getFrame(std::shared_ptr<const Trajectory> spTrajectory, int frame)
+{
+    return FrameSpan(spTrajectory->getFrameData(frame), spTrajectory->getAtomCount(), spTrajectory);
+}
+
+void Trajectory::ensureCapacity(int frameCount)
+{
+    if(frameCount <= mFrameCapacity) { return; }
+
+    // Grow at least by factor of two, so appending frame by frame does not copy too often
+    int frameCapacity = frameCount > 2 * mFrameCapacity ? frameCount : 2 * mFrameCapacity;
+    size_t byteCount = (size_t)frameCapacity * mAtomCount * sizeof(glm::vec3);
+    void* pData = NULL;
+    if(posix_memalign(&pData, alignment, byteCount > 0 ? byteCount : alignment) != 0)
+    {
+        throw std::bad_alloc();
+    }
+
+    // Move existing frames
+    if(mpData != NULL)
+    {
+        std::memcpy(pData, mpData, getSize() * sizeof(glm::vec3));
+        release();
+    }
+    mpData = (float*)pData;
+    mFrameCapacity = frameCapacity;
+}
+
+void Trajectory::release()
+{
+    if(!mspOwner) { free(mpData); }
+    mspOwner.reset();
+    mpData = NULL;
+    mFrameCapacity = 0;
+}
@@ -0,0 +1,152 @@
+//============================================================================
+// Distributed under the MIT License. Author: Raphael Menges
+//============================================================================
+
+// Positions of atoms for all frames in one contiguous and aligned buffer. Frames
+// are stored one after another, positions within a frame are packed as x, y, z
+// floats. This is the layout of the trajectory SSBO, so the buffer is uploaded
+// to OpenGL without conversion. Loaders write into it directly and all consumers
+// share it. Frames are accessed through spans, single coordinates through views.
+// Buffer may also be memory owned by someone else, like a mapped snapshot file.
+
+#ifndef TRAJECTORY_H
+#define TRAJECTORY_H
+
+#include <glm/glm.hpp>
+#include <vector>
+#include <memory>
+#include <cstddef>
+
+class Trajectory
+{
+public:
+
+    // Alignment of buffer in bytes
+    static const size_t alignment = 64;
+
+    // View on one coordinate of all atoms in a frame (0 is x, 1 is y and 2 is z). Stride is
+    // three for interleaved positions and one for coordinates stored separately, e.g. in files
+    class ComponentView
+    {
+    public:
+
+        ComponentView(const float* pData, int size, int stride = 3) : mpData(pData), mSize(size), mStride(stride) {}
+        float operator[](int i) const { return mpData[mStride * i]; }
+        int size() const { return mSize; }
+        int stride() const { return mStride; }
+
+    private:
+
+        const float* mpData;
+        int mSize;
+        int mStride;
+    };
+
+    // Span over positions of atoms in one frame. Optionally shares ownership of the
+    // memory, so the span stays valid even when the trajectory is released
+    class FrameSpan
+    {
+    public:
+
+        FrameSpan() {}
+        FrameSpan(const glm::vec3* pData, int size, std::shared_ptr<const void> spOwner = std::shared_ptr<const void>())
+            : mpData(pData), mSize(size), mspOwner(spOwner) {}
+        FrameSpan(const std::vector<glm::vec3>& rPositions) : mpData(rPositions.data()), mSize((int)rPositions.size()) {}
+
+        const glm::vec3& operator[](int i) const { return mpData[i]; }
+        const glm::vec3& at(int i) const; // checks range
+        const glm::vec3* data() const { return mpData; }
+        const glm::vec3* begin() const { return mpData; }
+        const glm::vec3* end() const { return mpData + mSize; }
+        int size() const { return mSize; }
+        bool empty() const { return mSize == 0; }
+        ComponentView getComponent(int component) const { return ComponentView((const float*)mpData + component, mSize); }
+
+    private:
+
+        const glm::vec3* mpData = NULL;
+        int mSize = 0;
+        std::shared_ptr<const void> mspOwner;
+    };
+
+    // Constructor
+    Trajectory(int atomCount = 0);
+
+    // Destructor
+    virtual ~Trajectory();
+
+    // Set count of atoms per frame. Only possible as long as trajectory has no frames
+    bool setAtomCount(int atomCount);
+
+    // Get count of atoms per frame
+    int getAtomCount() const { return mAtomCount; }
+
+    // Get count of frames
+    int getFrameCount() const { return mFrameCount; }
+
+    // Reserve memory for frames, so adding frames does not move existing ones
+    void reserve(int frameCount);
+
+    // Resize to count of frames. New frames are zero
+    void resize(int frameCount);
+
+    // Append frames which are zero. Returns positions of first appended frame
+    glm::vec3* addFrames(int frameCount);
+
+    // Use memory with frame count many frames instead of own buffer. Memory must be aligned and writable and is
+    // kept alive by owner as long as it is used. It is only copied into own buffer when further frames are added
+    void wrap(float* pData, int atomCount, int frameCount, std::shared_ptr<void> spOwner);
+
+    // Get whether buffer is memory of someone else
+    bool isWrapped() const { return (bool)mspOwner; }
+
+    // Get positions of atoms in frame for writing
+    glm::vec3* getFrameData(int frame) { return (glm::vec3*)mpData + (size_t)frame * mAtomCount; }
+
+    // Get positions of atoms in frame
+    const glm::vec3* getFrameData(int frame) const { return (const glm::vec3*)mpData + (size_t)frame * mAtomCount; }
+
+    // Get span over positions of atoms in frame. Span does not share ownership of trajectory
+    FrameSpan getFrame(int frame) const { return FrameSpan(getFrameData(frame), mAtomCount); }
+
+    // Get span over positions of atoms in frame which shares ownership of trajectory
+    static FrameSpan getFrame(std::shared_ptr<const Trajectory> spTrajectory, int frame);
+
+    // Get view on one coordinate of all atoms in frame
+    ComponentView getComponent(int frame, int component) const { return getFrame(frame).getComponent(component); }
+
+    // Get positions of all frames
+    const glm::vec3* getData() const { return (const glm::vec3*)mpData; }
+
+    // Get count of positions over all frames
+    size_t getSize() const { return (size_t)mFrameCount * mAtomCount; }
+
+private:
+
+    // No copies of trajectory
+    Trajectory(const Trajectory&);
+    Trajectory& operator=(const Trajectory&);
+
+    // Make sure that memory for frame count many frames is available
+    void ensureCapacity(int frameCount);
+
+    // Free own buffer or release wrapped memory
+    void release();
+
+    // Aligned buffer with x, y, z floats per atom per frame
+    float* mpData = NULL;
+
+    // Count of atoms per frame
+    int mAtomCount = 0;
+
+    // Count of frames
+    int mFrameCount = 0;
+
+    // Count of frames which fit into buffer
+    int mFrameCapacity = 0;
+
+    // Owner of wrapped memory, empty if buffer is own one
+    std::shared_ptr<void> mspOwner;
+};
+
+#endif // TRAJECTORY_H
@@ -1,17 +1,16 @@
 // Fill out your copyright notice in the Description page of Project Settings.
 //#include "PharmaCV.h"
 #include "MdTrajWrapper.h"
+#include "Molecule/NativeLoader/PDBReader.h"
+#include "Molecule/NativeLoader/GROReader.h"
+#include "Molecule/NativeLoader/CIFReader.h"
+#include "Molecule/NativeLoader/TrajectoryFile.h"
+#include "Utils/Logger.h"
+#include <unordered_map>
 
 MdTrajWrapper::MdTrajWrapper()
 {
-    wchar_t* inputName = L"" PYTHON_BINARY;
-    Py_SetProgramName(inputName);
-    wchar_t* name = Py_GetProgramFullPath();
-    std::wcout << "Using python executable at " << name << std::endl;
-
-    Py_Initialize();
-    PySys_SetArgvEx(0, NULL, 0);
-    this->importMDTraj();
+    //python is initialized on first use, files read natively never start it
 }
 
 MdTrajWrapper::~MdTrajWrapper()
@@ -21,10 +20,12 @@ MdTrajWrapper::~MdTrajWrapper()
 }
 
 /*
-* @param vector of paths to xtc and/or pdb
-* if xtc then first argument in vector is path to pdb and second path to xtc
+* @param vector of paths to pdb, gro or cif and optionally xtc, dcd or trr
+* if trajectory then first argument in vector is path to structure and second path to trajectory
+* @param options frames and atoms to load, anything else is never materialized
+* @param atomIndices optionally filled with the indices of the loaded atoms in the files
 */
-std::auto_ptr<Protein> MdTrajWrapper::load(std::vector<std::string> paths)
+std::auto_ptr<Protein> MdTrajWrapper::load(std::vector<std::string> paths, const LoadOptions &options, std::vector<int> *atomIndices)
 {
     std::vector<std::string> names;
     std::vector<std::string> bonds;
@@ -32,14 +33,14 @@ std::auto_ptr<Protein> MdTrajWrapper::load(std::vector<std::string> paths)
     std::vector<std::string> residueNames;
     std::vector<std::string> elementNames;
     std::vector<std::string> distinctResidueNames;
-    std::vector<std::vector<glm::vec3>> positions;
+    std::shared_ptr<Trajectory> trajectory(new Trajectory); //filled directly by the readers, shared with protein
     std::vector<float> radii;
     int numAtoms;
     std::string pathTmp = paths[0].substr(paths[0].find_last_of("\\/")+1);
     std::string proteinName = pathTmp.substr(0, pathTmp.size()-4);
     getAllAtomProperties(paths, names,
                          elementNames, residueNames,
-                         indices, bonds, distinctResidueNames, positions, radii, numAtoms);
+                         indices, bonds, distinctResidueNames, *trajectory, radii, numAtoms, options, atomIndices);
 
     //	pDq->spawnProtein(names, elementNames, residueNames,
     //		indices, bonds, positions, proteinName, numAtoms, distinctResidueNames);
@@ -47,7 +48,7 @@ std::auto_ptr<Protein> MdTrajWrapper::load(std::vector<std::string> paths)
 
     std::auto_ptr<Protein> prot(  new Protein(names,
         elementNames, residueNames,
-        indices, bonds, positions, proteinName, numAtoms, distinctResidueNames, radii));
+        indices, bonds, trajectory, proteinName, numAtoms, distinctResidueNames, radii));
    // proteins_.push_back(prot);
     return prot;
 }
@@ -57,6 +58,19 @@ std::auto_ptr<Protein> MdTrajWrapper::load(std::vector<std::string> paths)
 
 void MdTrajWrapper::importMDTraj()
 {
+    //only once for all files
+    if (function_loadPDB != NULL) {
+        return;
+    }
+
+    wchar_t* inputName = L"" PYTHON_BINARY;
+    Py_SetProgramName(inputName);
+    wchar_t* name = Py_GetProgramFullPath();
+    std::wcout << "Using python executable at " << name << std::endl;
+
+    Py_Initialize();
+    PySys_SetArgvEx(0, NULL, 0);
+
     PyObject* MDTrajString = PyUnicode_FromString((char*)"mdtraj");
     PyObject* MDTraj = PyImport_Import(MDTrajString);
 
@@ -72,12 +86,16 @@ void MdTrajWrapper::importMDTraj()
     // get access to different functions
     function_loadPDB = PyObject_GetAttrString(MDTraj, (char*)"load_pdb");
     function_loadXTC = PyObject_GetAttrString(MDTraj, (char*)"load_xtc");
+    PyObject* element = PyObject_GetAttrString(MDTraj, (char*)"element");
+    function_getElementBySymbol = PyObject_GetAttrString(element, (char*)"get_by_symbol");
+    Py_DECREF(element);
 
     Py_DECREF(MDTraj);
 }
 
 PyObject* MdTrajWrapper::loadFilePDB(std::string path)
 {
+    importMDTraj();
     PyObject* args = PyTuple_Pack(1, PyUnicode_FromString(path.c_str()));
     PyObject* file = PyObject_CallObject(function_loadPDB, args);
 
@@ -86,6 +104,7 @@ PyObject* MdTrajWrapper::loadFilePDB(std::string path)
 }
 
 PyObject* MdTrajWrapper::loadFileXTC(std::string pathXTC, std::string pathPDB) {
+    importMDTraj();
 
     PyObject* args = PyTuple_Pack(1, PyUnicode_FromString(pathXTC.c_str()));
     PyObject *kwargs = Py_BuildValue("{s:O}", "top", PyUnicode_FromString(pathPDB.c_str()));
@@ -114,204 +133,369 @@ PyObject *MdTrajWrapper::getTopology(PyObject *file)
     return PyObject_GetAttrString(file, (char*)"topology");
 }
 
-
-void MdTrajWrapper::getAllAtomProperties(std::vector<std::string> &paths, std::vector<std::string> &names,
-                                         std::vector<std::string> &elementNames, std::vector<std::string> &residueNames,
-                                         std::vector<int> &indices, std::vector<std::string> &bonds, std::vector<std::string> &distinctResidue, std::vector<std::vector<glm::vec3>> &positions, std::vector<float> &radii, int &numAtoms)
+/**
+* @brief column of a pandas dataframe as python list
+*/
+PyObject *MdTrajWrapper::getColumn(PyObject *dataframe, const char* name)
 {
-    if (paths.size() > 2) {
-        return;
+    PyObject* name_py = PyUnicode_FromString(name);
+    PyObject* series = PyObject_GetItem(dataframe, name_py);
+    Py_DECREF(name_py);
+    if (series == NULL) {
+        return NULL;
     }
+    PyObject* list = PyObject_CallMethod(series, (char*)"tolist", NULL);
+    Py_DECREF(series);
+    return list;
+}
 
-    //---------------------------------------------------load file-----------------------------------------------
-
-    if (paths.size() == 1) {
-        if (paths[0].substr((paths[0].length() - 3), 3) != "pdb") {
-            return;
-        }
+//text of a python object, which may be no string, e.g. None
+static std::string toString(PyObject* object)
+{
+    if (PyUnicode_Check(object)) {
+        return PyUnicode_AsUTF8(object);
     }
-    PyObject* pdbFile = loadFilePDB(paths[0]);
+    PyObject* string_py = PyObject_Str(object);
+    std::string string = PyUnicode_AsUTF8(string_py);
+    Py_DECREF(string_py);
+    return string;
+}
 
+bool MdTrajWrapper::loadTopologyTable(std::string path, TopologyTable &table)
+{
+    PyObject* pdbFile = loadFilePDB(path);
+    if (pdbFile == NULL) {
+        PyErr_Print();
+        return false;
+    }
     PyObject* xyz_py = getXYZ(pdbFile);
-    PyObject* topo = getTopology(pdbFile);
-    Py_DECREF(pdbFile);
-
 
+    //--------------------------positions of all frames, converted to angstrom
     PyArrayObject* xyz_pyarray = reinterpret_cast<PyArrayObject*>(xyz_py);
+    long long numFrames = PyArray_SHAPE(xyz_pyarray)[0];
+    long long numAtom = PyArray_SHAPE(xyz_pyarray)[1];
+    long long numComponents = PyArray_SHAPE(xyz_pyarray)[2];
+    float* xyz_carray = reinterpret_cast<float*>(PyArray_DATA(xyz_pyarray));
+    table.frameCount = (int)numFrames;
+    table.positions.resize(numFrames * numAtom);
+    for (long long i = 0; i < numFrames * numAtom; i++) {
+        long long id = i * numComponents;
+        table.positions[i] = glm::vec3(xyz_carray[id], xyz_carray[id + 1], xyz_carray[id + 2]) * 10.f;
+    }
+    Py_DECREF(xyz_py);
 
-    //use iterator here for atom name and element :)
-    PyObject* atom_py = PyObject_GetAttrString(topo, "atoms");
+    bool complete = readTopologyColumns(pdbFile, numAtom, table);
+    Py_DECREF(pdbFile);
+    return complete;
+}
 
-    PyObject* atom_iterator_py = PyObject_GetIter(atom_py);
-    Py_DECREF(atom_py);
-    if (atom_iterator_py == NULL) {
-        // not good
+bool MdTrajWrapper::readTopologyColumns(PyObject* pdbFile, long long numAtom, TopologyTable &table)
+{
+    //--------------------------whole columns of the atom table and the bond array in one call
+    PyObject* topo = getTopology(pdbFile);
+    PyObject* dataframe_and_bonds = PyObject_CallMethod(topo, (char*)"to_dataframe", NULL);
+    Py_DECREF(topo);
+    if (dataframe_and_bonds == NULL) {
+        PyErr_Print();
+        return false;
+    }
+    PyObject* dataframe = PyTuple_GetItem(dataframe_and_bonds, 0);
+    PyObject* names_py = getColumn(dataframe, "name");
+    PyObject* elements_py = getColumn(dataframe, "element");
+    PyObject* residue_names_py = getColumn(dataframe, "resName");
+    PyObject* residue_numbers_py = getColumn(dataframe, "resSeq");
+    PyObject* chains_py = getColumn(dataframe, "chainID");
+    PyObject* bonds_py = PyObject_CallMethod(PyTuple_GetItem(dataframe_and_bonds, 1), (char*)"tolist", NULL);
+    bool complete = names_py != NULL && elements_py != NULL && residue_names_py != NULL && residue_numbers_py != NULL
+        && chains_py != NULL && bonds_py != NULL && PyList_Size(names_py) == numAtom;
+
+    //element name and radius are asked from mdtraj once per element symbol
+    std::unordered_map<std::string, std::pair<std::string, float> > elementCache;
+    std::string previousResidueNumber;
+    std::string previousChain;
+
+    for (long long a = 0; complete && a < numAtom; a++) {
+        table.names.push_back(toString(PyList_GET_ITEM(names_py, a)));
+        std::string residueName = toString(PyList_GET_ITEM(residue_names_py, a));
+        std::string residueNumber = toString(PyList_GET_ITEM(residue_numbers_py, a));
+        std::string chain = toString(PyList_GET_ITEM(chains_py, a));
+
+        //new residue starts when chain, number or name changes
+        if (a == 0) {
+            table.residueIndices.push_back(0);
+        }
+        else if (residueName != table.residueNames.back() || residueNumber != previousResidueNumber || chain != previousChain) {
+            table.residueIndices.push_back(table.residueIndices.back() + 1);
+        }
+        else {
+            table.residueIndices.push_back(table.residueIndices.back());
+        }
+        previousResidueNumber = residueNumber;
+        previousChain = chain;
+        table.residueNames.push_back(residueName);
+        table.distinctResidueNames.push_back(residueName + residueNumber);
+
+        std::string symbol = toString(PyList_GET_ITEM(elements_py, a));
+        auto it = elementCache.find(symbol);
+        if (it == elementCache.end()) {
+            std::string elementName = "other";
+            float radius = 1.5f;
+            PyObject* element_py = PyObject_CallFunction(function_getElementBySymbol, (char*)"s", symbol.c_str());
+            if (element_py != NULL) {
+                PyObject* element_name_py = PyObject_GetAttrString(element_py, "name");
+                PyObject* atom_radius_py = PyObject_GetAttrString(element_py, "radius");
+                elementName = PyUnicode_AsUTF8(element_name_py);
+                radius = (float)(PyFloat_AsDouble(atom_radius_py) * 10);
+                Py_DECREF(element_name_py);
+                Py_DECREF(atom_radius_py);
+                Py_DECREF(element_py);
+            }
+            else {
+                PyErr_Clear();
+            }
+            it = elementCache.insert(std::make_pair(symbol, std::make_pair(elementName, radius))).first;
+        }
+        table.elementSymbols.push_back(symbol);
+        table.elementNames.push_back(it->second.first);
+        table.radii.push_back(it->second.second);
     }
 
+    //rows of bond array start with indices of both atoms
+    for (Py_ssize_t b = 0; complete && b < PyList_Size(bonds_py); b++) {
+        PyObject* bond = PyList_GET_ITEM(bonds_py, b);
+        table.bonds.push_back(std::make_pair(
+            (int)PyFloat_AsDouble(PyList_GET_ITEM(bond, 0)),
+            (int)PyFloat_AsDouble(PyList_GET_ITEM(bond, 1))));
+    }
 
+    Py_XDECREF(names_py);
+    Py_XDECREF(elements_py);
+    Py_XDECREF(residue_names_py);
+    Py_XDECREF(residue_numbers_py);
+    Py_XDECREF(chains_py);
+    Py_XDECREF(bonds_py);
+    Py_DECREF(dataframe_and_bonds);
+    if (!complete) {
+        PyErr_Print();
+    }
+    return complete;
+}
 
-    //-----------------------------------------AtomProperties-----------------------------------------------------------
-
-    //get number of frames, atoms and components
-    long long numFrames{ PyArray_SHAPE(xyz_pyarray)[0] };
-    long long numAtom{ PyArray_SHAPE(xyz_pyarray)[1] };
-    long long numComponents{ PyArray_SHAPE(xyz_pyarray)[2] };
-    numAtoms = (int)numAtom;
+std::vector<MdTrajWrapper::TopologyTable> MdTrajWrapper::loadTopologyTables(const std::vector<std::string> &paths)
+{
+    std::vector<TopologyTable> tables(paths.size());
+    for (size_t i = 0; i < paths.size(); i++) {
+        if (!loadTopologyTable(paths[i], tables[i])) {
+            tables[i] = TopologyTable();
+        }
+    }
+    return tables;
+}
 
 
-    // cast the 3D numpy array to a 1D c array
-    float* xyz_carray;
-    xyz_carray = reinterpret_cast<float*>(PyArray_DATA(xyz_pyarray));
+void MdTrajWrapper::getAllAtomProperties(std::vector<std::string> &paths, std::vector<std::string> &names,
+                                         std::vector<std::string> &elementNames, std::vector<std::string> &residueNames,
+                                         std::vector<int> &indices, std::vector<std::string> &bonds, std::vector<std::string> &distinctResidue, Trajectory &trajectory, std::vector<float> &radii, int &numAtoms,
+                                         const LoadOptions &options, std::vector<int> *selectedAtomIndices)
+{
+    if (paths.size() > 2) {
+        return;
+    }
 
-    float positionX;
-    float positionY;
-    float positionZ;
+    //---------------------------------------------------load file-----------------------------------------------
 
-    std::vector<glm::vec3> frameHolder;
-    for (int a = 0; a < numAtoms; a++)
-    {
-        int id = a * numComponents;
-        positionX = xyz_carray[id] * 10;
-        positionY = xyz_carray[id + 1] * 10;
-        positionZ = xyz_carray[id + 2] * 10;
-        glm::vec3 posi(positionX, positionY, positionZ);
-        frameHolder.push_back(posi);
+    std::string extension = paths[0].length() > 3 ? paths[0].substr(paths[0].length() - 3, 3) : "";
+    if (extension != "pdb" && extension != "gro" && extension != "cif") {
+        return;
     }
-    positions.push_back(frameHolder);
-    frameHolder.clear();
-
-    Py_DECREF(xyz_py);
-    PyObject* atom;
-    PyObject* name_py;
-    PyObject* element_py;
-    PyObject* element_name_py;
-    PyObject* distinct_residue_name_py;
-    PyObject* atom_radius_py;
-    int i = 1;
-    atom = PyIter_Next(atom_iterator_py);
-    while ((atom != NULL)) {
-        name_py = PyObject_GetAttrString(atom, "name");
-
-        element_py = PyObject_GetAttrString(atom, "element");
-
-        element_name_py = PyObject_GetAttrString(element_py, "name");
-        Py_DECREF(element_py);
-        distinct_residue_name_py=PyObject_GetAttrString(atom, "residue");
-
-        atom_radius_py = PyObject_GetAttrString(element_py, "radius");
-        radii.push_back(PyFloat_AsDouble(atom_radius_py) * 10);
-
-        PyObject* dist = PyObject_Str(distinct_residue_name_py);
-        Py_DECREF(distinct_residue_name_py);
-        names.push_back(PyUnicode_AsUTF8(name_py));
-        Py_DECREF(name_py);
-        elementNames.push_back(PyUnicode_AsUTF8(element_name_py));
-        Py_DECREF(element_name_py);
-        distinctResidue.push_back(PyUnicode_AsUTF8(dist));
-        Py_DECREF(dist);
-        indices.push_back(i);
-        i++;
-
-        atom = PyIter_Next(atom_iterator_py);
+    //indices of the kept atoms in the files, so the xtc is filtered the same way
+    std::vector<int> localAtomIndices;
+    std::vector<int> &atomIndices = selectedAtomIndices != NULL ? *selectedAtomIndices : localAtomIndices;
+    atomIndices.clear();
+
+    //further models of the structure only become frames when there is no trajectory
+    LoadOptions structureOptions = options;
+    structureOptions.readAllModels = options.readAllModels && paths.size() == 1;
+
+    //--------------------------gro and mmcif are only parsed natively
+    if (extension == "gro" || extension == "cif") {
+        bool read = false;
+        if (extension == "gro") {
+            GROReader groReader(paths[0]);
+            read = groReader.read(names, elementNames, residueNames, indices, bonds, distinctResidue, trajectory, radii, numAtoms, options, &atomIndices);
+        }
+        else {
+            CIFReader cifReader(paths[0]);
+            read = cifReader.read(names, elementNames, residueNames, indices, bonds, distinctResidue, trajectory, radii, numAtoms, options, &atomIndices);
+        }
+        if (read && paths.size() == 2) {
+            loadXTC(paths, trajectory, numAtoms, options, atomIndices);
+        }
+        return;
     }
-    Py_DECREF(atom_iterator_py);
 
-    //-----------------------------------------------------------
-    //use iterator here for residue names
-    PyObject* residue_py = PyObject_GetAttrString(topo, "residues");
-    PyObject* residue_iterator_py = PyObject_GetIter(residue_py);
-    Py_DECREF(residue_py);
+    //--------------------------parse pdb natively, mdtraj is only used when that fails
+    PDBReader pdbReader(paths[0]);
+    if (pdbReader.read(names, elementNames, residueNames, indices, bonds, distinctResidue, trajectory, radii, numAtoms, structureOptions, &atomIndices)) {
+        if (paths.size() == 2) {
+            loadXTC(paths, trajectory, numAtoms, options, atomIndices);
+        }
+        return;
+    }
 
-    if (residue_iterator_py == NULL) {
-        //UE_LOG(LogTemp, Warning, TEXT("ITERATOR EMPTY"));
+    //--------------------------fallback pulls whole columns of the topology from mdtraj
+    PyObject* pdbFile = loadFilePDB(paths[0]);
+    if (pdbFile == NULL) {
+        PyErr_Print();
+        return;
+    }
+    PyObject* xyz_py = getXYZ(pdbFile);
+    PyArrayObject* xyz_pyarray = reinterpret_cast<PyArrayObject*>(xyz_py);
+    long long numFrames = PyArray_SHAPE(xyz_pyarray)[0];
+    int numAtom = (int)PyArray_SHAPE(xyz_pyarray)[1];
+    long long numComponents = PyArray_SHAPE(xyz_pyarray)[2];
+    TopologyTable table;
+    bool complete = readTopologyColumns(pdbFile, numAtom, table);
+    Py_DECREF(pdbFile);
+    if (!complete) {
+        Py_DECREF(xyz_py);
+        return;
     }
 
-    PyObject* residue;
-    PyObject* residue_name_py;
+    //keep atoms of kept residues, a residue name is added with the first kept atom of each residue
+    std::vector<int> keptIndices(numAtom, -1);
+    for (int a = 0; a < numAtom; a++) {
+        if (!options.keepsResidue(table.residueNames[a])) {
+            continue;
+        }
+        if (atomIndices.empty() || table.residueIndices[a] != table.residueIndices[atomIndices.back()]) {
+            residueNames.push_back(table.residueNames[a]);
+        }
+        keptIndices[a] = (int)atomIndices.size();
+        atomIndices.push_back(a);
+        names.push_back(table.names[a]);
+        elementNames.push_back(table.elementNames[a]);
+        distinctResidue.push_back(table.distinctResidueNames[a]);
+        radii.push_back(table.radii[a]);
+        indices.push_back((int)atomIndices.size());
+    }
+    numAtoms = (int)atomIndices.size();
+
+    //copy kept atoms of first frame, or of all models, straight from the array of mdtraj into the trajectory
+    float* xyz_carray = reinterpret_cast<float*>(PyArray_DATA(xyz_pyarray));
+    int structureFrameCount = structureOptions.readAllModels ? (int)numFrames : 1;
+    trajectory.setAtomCount(numAtoms);
+    glm::vec3* frames = trajectory.addFrames(structureFrameCount);
+    for (int f = 0; f < structureFrameCount; f++)
+    {
+        for (int a = 0; a < numAtoms; a++)
+        {
+            long long id = ((long long)f * numAtom + atomIndices[a]) * numComponents;
+            frames[(long long)f * numAtoms + a] = glm::vec3(xyz_carray[id], xyz_carray[id + 1], xyz_carray[id + 2]) * 10.f;
+        }
+    }
+    Py_DECREF(xyz_py);
 
-    residue = PyIter_Next(residue_iterator_py);
-    while ((residue != NULL)) {
-        residue_name_py = PyObject_GetAttrString(residue, "name");
-        residueNames.push_back(PyUnicode_AsUTF8(residue_name_py));
+    //bonds between kept atoms in the format of mdtraj, e.g. "(MET1-N, MET1-CA)"
+    for (const auto& bond : table.bonds) {
+        if (keptIndices[bond.first] < 0 || keptIndices[bond.second] < 0) {
+            continue;
+        }
+        bonds.push_back("(" + table.distinctResidueNames[bond.first] + "-" + table.names[bond.first] + ", "
+            + table.distinctResidueNames[bond.second] + "-" + table.names[bond.second] + ")");
+    }
 
-        Py_DECREF(residue_name_py);
-        residue = PyIter_Next(residue_iterator_py);
+    //-------------------------------------------------------load xtc if there was one
+    if (paths.size() == 2) {
+        loadXTC(paths, trajectory, numAtoms, options, atomIndices);
     }
-    Py_DECREF(residue_iterator_py);
 
+}
 
 
-    PyObject* bonds_py = PyObject_GetAttrString(topo, "bonds");
-    Py_DECREF(topo);
-    PyObject* bonds_iterator_py = PyObject_GetIter(bonds_py);
+/**
+* @brief appends frames of xtc, dcd or trr behind the frames already in trajectory
+* @param paths first is path to structure and second path to xtc, dcd or trr
+* @param options frames of the xtc to load
+* @param atomIndices indices of the atoms to load, as kept from the pdb
+*/
+void MdTrajWrapper::loadXTC(std::vector<std::string> &paths, Trajectory &trajectory, int &numAtoms,
+                            const LoadOptions &options, const std::vector<int> &atomIndices)
+{
+    long long numFrames;
+    long long numAtom;
+    long long numComponents;
+    float* xyz_carray;
+    PyArrayObject* xyz_pyarray;
 
-    if (bonds_iterator_py == NULL) {
-        //UE_LOG(LogTemp, Warning, TEXT("ITERATOR EMPTY"));
+    std::string pathPDB = paths.at(0);
+    std::string pathXTC = paths.at(1);
+    if (!TrajectoryFile::isSupported(pathXTC)) {
+       //UE_LOG(LogTemp, Error, TEXT("BOAH MAN EY, wenn du ne .xtc laden willst muss zuerst die .pdb rein und dann die .xtc"));
+       //UE_LOG(LogTemp, Error, TEXT("und wenn du mehrere .pdbs laden willst, musst du musst du die einzeln reinladen, MAN"));
+        return;
     }
+    else {
+        //--------------------------decode natively, directly behind the frame of the pdb
+        std::unique_ptr<TrajectoryFile> reader = TrajectoryFile::open(pathXTC);
+        if (reader->isOpen()) {
+            if (!reader->select(options, atomIndices) || reader->getAtomCount() != numAtoms) {
+                // pdb does not fit to xtc, only the pdb was loaded
+                return;
+            }
+            int structureFrameCount = trajectory.getFrameCount();
+            if (reader->read(0, reader->getFrameCount(), trajectory, structureFrameCount)) {
+                return;
+            }
 
-    PyObject* bond;
+            // corrupt or truncated file, frames which could not be decoded are dropped before trying mdtraj
+            Logger::instance().print("Could not decode all frames of trajectory: " + pathXTC, Logger::Mode::WARNING);
+            trajectory.resize(structureFrameCount);
+        }
 
-    bond = PyIter_Next(bonds_iterator_py);
-    while ((bond != NULL)) {
+        //--------------------------fall back to mdtraj, only for xtc
+        if (pathXTC.substr((pathXTC.length() - 3),3) != "xtc") {
+            return;
+        }
+        PyObject* traj = loadFileXTC(pathXTC, pathPDB);
+        if (traj == NULL) {
+           //UE_LOG(LogTemp, Error, TEXT("Ok, die pdb passt nicht zur xtc, es wurde nur die .pdb geladen. (Wahrscheinlich stimmt die Atomanzahl nicht ?berein. Vllt Wasser raus schneiden?)"));
+            return;
+        }
 
-        PyObject* bondfi = PyObject_Str(bond);
-        bonds.push_back(PyUnicode_AsUTF8(bondfi));
-        Py_DECREF(bondfi);
-        bond = PyIter_Next(bonds_iterator_py);
+        PyObject* xyz = getXYZ(traj);
 
-    }
-    Py_DECREF(bonds_iterator_py);
+        Py_DECREF(traj);
+        xyz_pyarray = reinterpret_cast<PyArrayObject*>(xyz);
+        xyz_carray = reinterpret_cast<float*>(PyArray_DATA(xyz_pyarray));
 
-    //-------------------------------------------------------load xtc if there was one
-    if (paths.size() == 2) {
-        std::string pathPDB = paths.at(0);
-        std::string pathXTC = paths.at(1);
-        if (pathXTC.substr((pathXTC.length() - 3),3) != "xtc") {
-           //UE_LOG(LogTemp, Error, TEXT("BOAH MAN EY, wenn du ne .xtc laden willst muss zuerst die .pdb rein und dann die .xtc"));
-           //UE_LOG(LogTemp, Error, TEXT("und wenn du mehrere .pdbs laden willst, musst du musst du die einzeln reinladen, MAN"));
+        //get number of frames, atoms and components
+        numFrames = PyArray_SHAPE(xyz_pyarray)[0];
+        numAtom = PyArray_SHAPE(xyz_pyarray)[1];
+        numComponents = PyArray_SHAPE(xyz_pyarray)[2];
+        numComponents = (int)numComponents;
+        numFrames = (int)numFrames;
+        if ((int)atomIndices.size() != trajectory.getAtomCount() || (!atomIndices.empty() && atomIndices.back() >= (int)numAtom)) {
+            // pdb does not fit to xtc, only the pdb was loaded
+            Py_DECREF(xyz);
             return;
         }
-        else {
-            PyObject* traj = loadFileXTC(pathXTC, pathPDB);
-            if (traj == NULL) {
-               //UE_LOG(LogTemp, Error, TEXT("Ok, die pdb passt nicht zur xtc, es wurde nur die .pdb geladen. (Wahrscheinlich stimmt die Atomanzahl nicht ?berein. Vllt Wasser raus schneiden?)"));
-                return;
-            }
-
-            PyObject* xyz = getXYZ(traj);
-
-            Py_DECREF(traj);
-            xyz_pyarray = reinterpret_cast<PyArrayObject*>(xyz);
-            xyz_carray = reinterpret_cast<float*>(PyArray_DATA(xyz_pyarray));
-
-            //get number of frames, atoms and components
-            numFrames = PyArray_SHAPE(xyz_pyarray)[0];
-            numAtom = PyArray_SHAPE(xyz_pyarray)[1];
-            numComponents = PyArray_SHAPE(xyz_pyarray)[2];
-            numComponents = (int)numComponents;
-            numFrames = (int)numFrames;
-            numAtoms = (int)numAtom;
-
-            //--------------------------read the atoms for each frame
-            int c = 0;
-            for (int b = 1; b < numFrames + 1; b++) {
-                for (c; c < numAtoms*b; c++) {
-                    int id = c * numComponents;
-                    positionX = xyz_carray[id] * 10;
-                    positionY = xyz_carray[id + 1] * 10;
-                    positionZ = xyz_carray[id + 2] * 10;
-                    glm::vec3 posi(positionX, positionY, positionZ);
-                    frameHolder.push_back(posi);
-                }
-                positions.push_back(frameHolder);
-                frameHolder.clear();
+        numAtoms = (int)atomIndices.size();
+
+        //--------------------------read the selected atoms of the selected frames directly into the trajectory
+        int selectedFrameCount = options.getFrameCount((int)numFrames);
+        glm::vec3* frames = trajectory.addFrames(selectedFrameCount);
+        for (int f = 0; f < selectedFrameCount; f++) {
+            long long frameStart = (long long)options.getFileFrame(f) * numAtom;
+            for (int a = 0; a < numAtoms; a++) {
+                long long id = (frameStart + atomIndices[a]) * numComponents;
+                frames[(long long)f * numAtoms + a] = glm::vec3(xyz_carray[id], xyz_carray[id + 1], xyz_carray[id + 2]) * 10.f;
             }
+        }
 
-            Py_DECREF(xyz);
+        Py_DECREF(xyz);
 
-        }
     }
-
 }
 
 /*
@@ -11,16 +11,51 @@
 #include <memory>
 #include <glm/ext.hpp>
 #include "Molecule/MDtrajLoader/Data/Protein.h"
+#include "Molecule/MDtrajLoader/Data/Trajectory.h"
+#include "Molecule/NativeLoader/LoadOptions.h"
 /**
-*
+* shared service, python and mdtraj are only initialized once and only when a file needs them
 */
 class MdTrajWrapper
 {
 public:
-	MdTrajWrapper();
+	static MdTrajWrapper& instance()
+	{
+		static MdTrajWrapper _instance;
+		return _instance;
+	}
 	~MdTrajWrapper();
 
-    std::auto_ptr<Protein> load(std::vector<std::string> paths);
+    std::auto_ptr<Protein> load(std::vector<std::string> paths, const LoadOptions &options = LoadOptions(),
+                                std::vector<int> *atomIndices = NULL);
+
+	/**
+	* @brief atoms of a topology loaded by mdtraj, pulled as whole columns instead of attribute by attribute
+	*/
+	struct TopologyTable
+	{
+		std::vector<std::string> names; //e.g. CA
+		std::vector<std::string> elementSymbols; //e.g. C
+		std::vector<std::string> elementNames; //e.g. carbon
+		std::vector<std::string> residueNames; //e.g. MET, per atom
+		std::vector<std::string> distinctResidueNames; //e.g. MET1, per atom
+		std::vector<int> residueIndices; //index of residue of each atom
+		std::vector<float> radii; //in angstrom
+		std::vector<std::pair<int, int> > bonds; //indices of bonded atoms
+		std::vector<glm::vec3> positions; //all frames one after the other, in angstrom
+		int frameCount = 0;
+	};
+
+	/**
+	* @brief load pdb through mdtraj into a table
+	* @return false if mdtraj could not load the file
+	*/
+	bool loadTopologyTable(std::string path, TopologyTable &table);
+
+	/**
+	* @brief load multiple pdbs back to back with the same interpreter, failed files give empty tables
+	*/
+	std::vector<TopologyTable> loadTopologyTables(const std::vector<std::string> &paths);
 
 	void importMDTraj();
 
@@ -33,11 +68,27 @@ public:
 	void getAllAtomProperties(std::vector<std::string> &paths, std::vector<std::string> &names, std::vector<std::string> &elementNames
 		, std::vector<std::string> &residueNames, std::vector<int> &indices
         , std::vector<std::string> &bonds, std::vector<std::string> &distinctResidueNames,
-                              std::vector<std::vector<glm::vec3>> &positions, std::vector<float> &radii, int &numAtoms);
+                              Trajectory &trajectory, std::vector<float> &radii, int &numAtoms,
+                              const LoadOptions &options = LoadOptions(), std::vector<int> *atomIndices = NULL);
 
 
 private:
+	MdTrajWrapper();                                    // disable creating an object of this class
+	MdTrajWrapper(const MdTrajWrapper&);                // disable copy constructor
+	MdTrajWrapper & operator = (const MdTrajWrapper&);  // disable new instance by copy
+
+	PyObject* getColumn(PyObject* dataframe, const char* name);
+
+	/**
+	* @brief fill all columns of the table except the positions from the topology of a loaded pdb
+	* @return false if the topology does not have numAtom atoms or a column is missing
+	*/
+	bool readTopologyColumns(PyObject* pdbFile, long long numAtom, TopologyTable &table);
+
+	void loadXTC(std::vector<std::string> &paths, Trajectory &trajectory, int &numAtoms,
+                 const LoadOptions &options, const std::vector<int> &atomIndices);
 
-	PyObject* function_loadPDB;
-	PyObject* function_loadXTC;
+	PyObject* function_loadPDB = NULL;
+	PyObject* function_loadXTC = NULL;
+	PyObject* function_getElementBySymbol = NULL;
 };
@@ -0,0 +1,412 @@
+//============================================================================
+// Distributed under the MIT License. Author: Raphael Menges
+//============================================================================
+
+#include "CIFReader.h"
+#include "FixedColumns.h"
+#include "ElementCache.h"
+#include "Utils/Logger.h"
+#include <algorithm>
+#include <cstring>
+#include <cctype>
+#include <climits>
+#include <iterator>
+#include <thread>
+
+// Chunks of rows are at least this large in bytes, smaller ones are not worth a thread
+const size_t minChunkSize = 1 << 20;
+
+// Prefix of data names in atom site loop
+const char atomSitePrefix[] = "_atom_site.";
+const size_t atomSitePrefixLength = sizeof(atomSitePrefix) - 1;
+
+// Columns of atom site loop which are used, each with author name first and label name second
+enum AtomSiteColumn { TYPE_SYMBOL, ATOM_NAME, RESIDUE_NAME, CHAIN, SEQUENCE_NUMBER, INSERTION_CODE, X, Y, Z, MODEL, COLUMN_COUNT };
+const char* atomSiteColumnNames[COLUMN_COUNT][2] =
+{
+    { "type_symbol", "type_symbol" },
+    { "auth_atom_id", "label_atom_id" },
+    { "auth_comp_id", "label_comp_id" },
+    { "auth_asym_id", "label_asym_id" },
+    { "auth_seq_id", "label_seq_id" },
+    { "pdbx_PDB_ins_code", "pdbx_PDB_ins_code" },
+    { "Cartn_x", "Cartn_x" },
+    { "Cartn_y", "Cartn_y" },
+    { "Cartn_z", "Cartn_z" },
+    { "pdbx_PDB_model_num", "pdbx_PDB_model_num" }
+};
+
+// Token of a row, without quotes
+typedef std::pair<const char*, const char*> Token;
+
+// Atoms parsed from one chunk of rows. Residues are counted within the chunk
+struct AtomSiteChunk
+{
+    std::vector<std::string> names;
+    std::vector<std::string> elementNames;
+    std::vector<glm::vec3> positions;
+    std::vector<float> radii;
+    std::vector<int> rowIndices; // index of row of each atom within chunk
+    std::vector<int> residueIndices; // index of residue of each atom within chunk
+    std::vector<std::string> residueNames;
+    std::vector<int> residueNumbers; // INT_MIN if not readable
+    std::string firstResidueKey; // identifies residue of first atom, to join it with residue of previous chunk
+    std::string lastResidueKey;
+    int rowCount = 0;
+    bool loopEnded = false; // chunk contains end of atom site loop
+    bool corrupt = false;
+};
+
+// Find next line, which ends before carriage return and line feed
+static const char* nextLine(const char* pLine, const char* pDataEnd, const char*& rpLineEnd)
+{
+    const char* pNewLine = (const char*)std::memchr(pLine, '\n', pDataEnd - pLine);
+    if(pNewLine == NULL) { pNewLine = pDataEnd; }
+    rpLineEnd = pNewLine;
+    if(rpLineEnd > pLine && *(rpLineEnd - 1) == '\r') { rpLineEnd--; }
+    return std::min(pNewLine + 1, pDataEnd);
+}
+
+// Split line into tokens separated by whitespace. Quoted tokens end at quote followed by whitespace
+static void tokenize(const char* pLine, const char* pLineEnd, std::vector<Token>& rTokens)
+{
+    rTokens.clear();
+    const char* pChar = pLine;
+    while(true)
+    {
+        while(pChar < pLineEnd && std::isspace((unsigned char)*pChar)) { pChar++; }
+        if(pChar >= pLineEnd) { break; }
+        if(*pChar == '\'' || *pChar == '"')
+        {
+            char quote = *pChar;
+            const char* pBegin = ++pChar;
+            while(pChar < pLineEnd && !(*pChar == quote && (pChar + 1 == pLineEnd || std::isspace((unsigned char)pChar[1])))) { pChar++; }
+            rTokens.push_back(Token(pBegin, pChar));
+            if(pChar < pLineEnd) { pChar++; }
+        }
+        else
+        {
+            const char* pBegin = pChar;
+            while(pChar < pLineEnd && !std::isspace((unsigned char)*pChar)) { pChar++; }
+            rTokens.push_back(Token(pBegin, pChar));
+        }
+    }
+}
+
+// Get whether line ends loop, since it starts with comment, data name, text field or keyword
+static bool endsLoop(const char* pLine, const char* pLineEnd)
+{
+    while(pLine < pLineEnd && (*pLine == ' ' || *pLine == '\t')) { pLine++; }
+    if(pLine == pLineEnd) { return false; }
+    if(*pLine == '#' || *pLine == '_' || *pLine == ';') { return true; }
+    const char* keywords[] = { "loop_", "data_", "save_", "global_", "stop_" };
+    for(const char* pKeyword : keywords)
+    {
+        size_t length = std::strlen(pKeyword);
+        if((size_t)(pLineEnd - pLine) < length) { continue; }
+        bool match = true;
+        for(size_t i = 0; i < length && match; i++) { match = std::tolower((unsigned char)pLine[i]) == pKeyword[i]; }
+        if(match) { return true; }
+    }
+    return false;
+}
+
+// Get whether token is missing or inapplicable value
+static bool isNull(const Token& rToken)
+{
+    return rToken.second - rToken.first == 1 && (*rToken.first == '.' || *rToken.first == '?');
+}
+
+// Parse rows of lines starting in [pBegin, pEnd[ until loop ends
+static void parseChunk(
+    const char* pBegin,
+    const char* pEnd,
+    const char* pDataEnd,
+    const int pColumns[COLUMN_COUNT],
+    size_t columnCount,
+    const std::string& rModel,
+    const LoadOptions& rOptions,
+    AtomSiteChunk& rChunk)
+{
+    // Element name and radius per element symbol
+    ElementCache elementCache;
+
+    std::vector<Token> tokens;
+    tokens.reserve(columnCount);
+    std::string residueKey;
+    const char* pLine = pBegin;
+    while(pLine < pEnd)
+    {
+        const char* pLineEnd;
+        const char* pNext = nextLine(pLine, pDataEnd, pLineEnd);
+        if(endsLoop(pLine, pLineEnd))
+        {
+            rChunk.loopEnded = true;
+            return;
+        }
+        tokenize(pLine, pLineEnd, tokens);
+        pLine = pNext;
+        if(tokens.empty()) { continue; }
+        if(tokens.size() != columnCount)
+        {
+            rChunk.corrupt = true;
+            return;
+        }
+        int row = rChunk.rowCount++;
+
+        // Only first model is read
+        if(pColumns[MODEL] >= 0)
+        {
+            const Token& rToken = tokens[pColumns[MODEL]];
+            if(rModel.compare(0, std::string::npos, rToken.first, rToken.second - rToken.first) != 0) { continue; }
+        }
+
+        // Skip atoms of removed residues, like water and ions
+        const Token& rResidueName = tokens[pColumns[RESIDUE_NAME]];
+        std::string residueName(rResidueName.first, rResidueName.second);
+        if(!rOptions.keepsAllAtoms() && !rOptions.keepsResidue(residueName)) { continue; }
+        rChunk.rowIndices.push_back(row);
+
+        // Name of atom
+        const Token& rName = tokens[pColumns[ATOM_NAME]];
+        rChunk.names.push_back(std::string(rName.first, rName.second));
+
+        // Residue, new one starts when chain, sequence number, insertion code or name changes
+        residueKey.clear();
+        for(int column : { CHAIN, SEQUENCE_NUMBER, INSERTION_CODE })
+        {
+            if(pColumns[column] >= 0) { residueKey.append(tokens[pColumns[column]].first, tokens[pColumns[column]].second); }
+            residueKey.push_back(' ');
+        }
+        residueKey += residueName;
+        if(rChunk.residueNames.empty() || residueKey != rChunk.lastResidueKey)
+        {
+            if(rChunk.residueNames.empty()) { rChunk.firstResidueKey = residueKey; }
+            rChunk.lastResidueKey = residueKey;
+            rChunk.residueNames.push_back(residueName);
+            int residueNumber = INT_MIN;
+            if(pColumns[SEQUENCE_NUMBER] >= 0)
+            {
+                const Token& rToken = tokens[pColumns[SEQUENCE_NUMBER]];
+                size_t length = rToken.second - rToken.first;
+                if(!FixedColumns::parseInt(rToken.first, length, 1, length, residueNumber)) { residueNumber = INT_MIN; }
+            }
+            rChunk.residueNumbers.push_back(residueNumber);
+        }
+        rChunk.residueIndices.push_back((int)rChunk.residueNames.size() - 1);
+
+        // Position
+        glm::vec3 position;
+        for(int component = 0; component < 3; component++)
+        {
+            const Token& rToken = tokens[pColumns[X + component]];
+            size_t length = rToken.second - rToken.first;
+            position[component] = FixedColumns::parseFloat(rToken.first, length, 1, length);
+        }
+        rChunk.positions.push_back(position);
+
+        // Element and radius, symbol is guessed from atom name if not given
+        std::string symbol;
+        if(pColumns[TYPE_SYMBOL] >= 0 && !isNull(tokens[pColumns[TYPE_SYMBOL]]))
+        {
+            symbol.assign(tokens[pColumns[TYPE_SYMBOL]].first, tokens[pColumns[TYPE_SYMBOL]].second);
+        }
+        else
+        {
+            const char* pChar = rName.first;
+            while(pChar < rName.second && !std::isalpha((unsigned char)*pChar)) { pChar++; }
+            if(pChar < rName.second) { symbol.push_back(*pChar); }
+        }
+        std::transform(symbol.begin(), symbol.end(), symbol.begin(), ::toupper);
+        const std::pair<std::string, float>& rElement = elementCache.resolve(symbol);
+        rChunk.elementNames.push_back(rElement.first);
+        rChunk.radii.push_back(rElement.second);
+    }
+}
+
+CIFReader::CIFReader(std::string filepath)
+{
+    mupFile = std::unique_ptr<MappedFile>(new MappedFile(filepath));
+}
+
+CIFReader::~CIFReader()
+{
+    // Nothing to do
+}
+
+bool CIFReader::read(
+    std::vector<std::string>& rNames,
+    std::vector<std::string>& rElementNames,
+    std::vector<std::string>& rResidueNames,
+    std::vector<int>& rIndices,
+    std::vector<std::string>&,
+    std::vector<std::string>& rDistinctResidueNames,
+    Trajectory& rTrajectory,
+    std::vector<float>& rRadii,
+    int& rAtomCount,
+    const LoadOptions& rOptions,
+    std::vector<int>* pAtomIndices,
+    int threadCount) const
+{
+    if(!isOpen()) { return false; }
+    const char* pData = mupFile->getData();
+    const char* pDataEnd = pData + mupFile->getSize();
+
+    // Find data names of atom site loop
+    std::vector<std::string> columnNames;
+    const char* pLine = pData;
+    const char* pLineEnd;
+    while(pLine < pDataEnd)
+    {
+        const char* pNext = nextLine(pLine, pDataEnd, pLineEnd);
+        bool atomSite = (size_t)(pLineEnd - pLine) > atomSitePrefixLength && std::memcmp(pLine, atomSitePrefix, atomSitePrefixLength) == 0;
+        if(atomSite)
+        {
+            const char* pNameEnd = pLine;
+            while(pNameEnd < pLineEnd && !std::isspace((unsigned char)*pNameEnd)) { pNameEnd++; }
+            columnNames.push_back(std::string(pLine + atomSitePrefixLength, pNameEnd));
+        }
+        else if(!columnNames.empty())
+        {
+            break;
+        }
+        pLine = pNext;
+    }
+
+    // Index of each used column, author name is preferred
+    int pColumns[COLUMN_COUNT];
+    for(int column = 0; column < COLUMN_COUNT; column++)
+    {
+        pColumns[column] = -1;
+        for(int variant = 1; variant >= 0; variant--)
+        {
+            auto it = std::find(columnNames.begin(), columnNames.end(), atomSiteColumnNames[column][variant]);
+            if(it != columnNames.end()) { pColumns[column] = (int)(it - columnNames.begin()); }
+        }
+    }
+    if(pColumns[ATOM_NAME] < 0 || pColumns[RESIDUE_NAME] < 0 || pColumns[X] < 0 || pColumns[Y] < 0 || pColumns[Z] < 0)
+    {
+        Logger::instance().print("No atom site loop with positions found in mmCIF file: " + mupFile->getFilepath(), Logger::Mode::ERROR);
+        return false;
+    }
+
+    // Model of first row
+    std::string model;
+    std::vector<Token> tokens;
+    for(const char* pRow = pLine; pRow < pDataEnd && pColumns[MODEL] >= 0 && model.empty();)
+    {
+        const char* pNext = nextLine(pRow, pDataEnd, pLineEnd);
+        if(endsLoop(pRow, pLineEnd)) { break; }
+        tokenize(pRow, pLineEnd, tokens);
+        if(tokens.size() == columnNames.size()) { model.assign(tokens[pColumns[MODEL]].first, tokens[pColumns[MODEL]].second); }
+        pRow = pNext;
+    }
+
+    // Split rows into chunks at line starts. Chunks behind end of loop are parsed in vain, but end is not known before
+    if(threadCount <= 0) { threadCount = (int)std::thread::hardware_concurrency(); }
+    size_t dataSize = pDataEnd - pLine;
+    int chunkCount = (int)std::max((size_t)1, std::min(dataSize / minChunkSize, (size_t)std::max(1, threadCount)));
+    std::vector<const char*> chunkBegins(chunkCount + 1, pDataEnd);
+    for(int i = 0; i < chunkCount; i++)
+    {
+        const char* pBegin = pLine + (dataSize * i) / chunkCount;
+        if(pBegin > pLine && *(pBegin - 1) != '\n')
+        {
+            const char* pNewLine = (const char*)std::memchr(pBegin, '\n', pDataEnd - pBegin);
+            pBegin = pNewLine != NULL ? pNewLine + 1 : pDataEnd;
+        }
+        chunkBegins[i] = pBegin;
+    }
+
+    // Parse chunks in parallel
+    std::vector<AtomSiteChunk> chunks(chunkCount);
+    std::vector<std::thread> threads;
+    for(int i = 0; i < chunkCount; i++)
+    {
+        threads.push_back(std::thread([&, i]()
+        {
+            parseChunk(chunkBegins[i], std::max(chunkBegins[i], chunkBegins[i + 1]), pDataEnd, pColumns, columnNames.size(), model, rOptions, chunks[i]);
+        }));
+    }
+    for(auto& rThread : threads) { rThread.join(); }
+
+    // Chunks are used until the one with end of loop
+    int usedChunkCount = 0;
+    size_t atomCount = 0;
+    size_t residueCount = 0;
+    for(const auto& rChunk : chunks)
+    {
+        if(rChunk.corrupt)
+        {
+            Logger::instance().print("Row of atom site loop does not fit to its columns in mmCIF file: " + mupFile->getFilepath(), Logger::Mode::ERROR);
+            return false;
+        }
+        usedChunkCount++;
+        atomCount += rChunk.names.size();
+        residueCount += rChunk.residueNames.size();
+        if(rChunk.loopEnded) { break; }
+    }
+    if(atomCount == 0)
+    {
+        Logger::instance().print("No atoms found in mmCIF file: " + mupFile->getFilepath(), Logger::Mode::ERROR);
+        return false;
+    }
+
+    // Frame is appended to trajectory
+    if(!rTrajectory.setAtomCount((int)atomCount))
+    {
+        Logger::instance().print("Count of atoms does not fit to trajectory: " + mupFile->getFilepath(), Logger::Mode::ERROR);
+        return false;
+    }
+    glm::vec3* pPositions = rTrajectory.addFrames(1);
+
+    // Join chunks in order. First residue of chunk continues last one of previous chunk if they are the same
+    std::vector<std::string> distinctResidueNames;
+    std::vector<int> atomIndices;
+    distinctResidueNames.reserve(residueCount);
+    atomIndices.reserve(atomCount);
+    rNames.reserve(rNames.size() + atomCount);
+    rElementNames.reserve(rElementNames.size() + atomCount);
+    rDistinctResidueNames.reserve(rDistinctResidueNames.size() + atomCount);
+    rRadii.reserve(rRadii.size() + atomCount);
+    const std::string* pLastResidueKey = NULL;
+    int rowOffset = 0;
+    for(int i = 0; i < usedChunkCount; i++)
+    {
+        AtomSiteChunk& rChunk = chunks[i];
+        int residueOffset = (int)distinctResidueNames.size();
+        if(!rChunk.residueNames.empty())
+        {
+            int firstResidue = 0;
+            if(pLastResidueKey != NULL && *pLastResidueKey == rChunk.firstResidueKey)
+            {
+                firstResidue = 1;
+                residueOffset--;
+            }
+            for(int residue = firstResidue; residue < (int)rChunk.residueNames.size(); residue++)
+            {
+                int residueNumber = rChunk.residueNumbers[residue];
+                if(residueNumber == INT_MIN) { residueNumber = (int)distinctResidueNames.size() + 1; }
+                distinctResidueNames.push_back(rChunk.residueNames[residue] + std::to_string(residueNumber));
+                rResidueNames.push_back(std::move(rChunk.residueNames[residue]));
+            }
+            pLastResidueKey = &rChunk.lastResidueKey;
+        }
+        for(size_t atom = 0; atom < rChunk.names.size(); atom++)
+        {
+            atomIndices.push_back(rowOffset + rChunk.rowIndices[atom]);
+            rDistinctResidueNames.push_back(distinctResidueNames[residueOffset + rChunk.residueIndices[atom]]);
+        }
+        rowOffset += rChunk.rowCount;
+        pPositions = std::copy(rChunk.positions.begin(), rChunk.positions.end(), pPositions);
+        rNames.insert(rNames.end(), std::make_move_iterator(rChunk.names.begin()), std::make_move_iterator(rChunk.names.end()));
+        rElementNames.insert(rElementNames.end(), std::make_move_iterator(rChunk.elementNames.begin()), std::make_move_iterator(rChunk.elementNames.end()));
+        rRadii.insert(rRadii.end(), rChunk.radii.begin(), rChunk.radii.end());
+    }
+
+    // Fill remaining output
+    rAtomCount = (int)atomCount;
+    for(int i = 0; i < rAtomCount; i++) { rIndices.push_back(i + 1); }
+    if(pAtomIndices != NULL) { *pAtomIndices = atomIndices; }
+    return true;
+}
@@ -0,0 +1,58 @@
+//============================================================================
+// Distributed under the MIT License. Author: Raphael Menges
+//============================================================================
+
+// Native reader of mmCIF files, which hold structures too large for PDB. File
+// is memory mapped and rows of the atom site loop are tokenized in one pass.
+// Rows are split into chunks of lines, which are parsed in parallel and then
+// joined in order, so millions of atoms are read in seconds.
+
+#ifndef CIF_READER_H
+#define CIF_READER_H
+
+#include "Molecule/NativeLoader/MappedFile.h"
+#include "Molecule/NativeLoader/LoadOptions.h"
+#include "Molecule/MDtrajLoader/Data/Trajectory.h"
+#include <glm/glm.hpp>
+#include <vector>
+#include <string>
+#include <memory>
+
+class CIFReader
+{
+public:
+
+    // Constructor, maps file. Check isOpen afterwards
+    CIFReader(std::string filepath);
+
+    // Destructor
+    virtual ~CIFReader();
+
+    // Get whether file could be opened
+    bool isOpen() const { return mupFile->isOpen(); }
+
+    // Parse atoms of first model into the structures consumed by Protein, like PDBReader does. Author names and
+    // numbers are preferred over label ones, as they match PDB files. Rows must not span multiple lines, as written
+    // by the PDB. No bonds are added. Atoms of residues removed by options are skipped, indices of kept atoms within
+    // the file are optionally filled in. Thread count of zero means hardware concurrency. Returns false if no atom was found
+    bool read(
+        std::vector<std::string>& rNames,
+        std::vector<std::string>& rElementNames,
+        std::vector<std::string>& rResidueNames,
+        std::vector<int>& rIndices,
+        std::vector<std::string>& rBonds,
+        std::vector<std::string>& rDistinctResidueNames,
+        Trajectory& rTrajectory,
+        std::vector<float>& rRadii,
+        int& rAtomCount,
+        const LoadOptions& rOptions = LoadOptions(),
+        std::vector<int>* pAtomIndices = NULL,
+        int threadCount = 0) const;
+
+private:
+
+    // Memory mapped file
+    std::unique_ptr<MappedFile> mupFile;
+};
+
+#endif // CIF_READER_H
@@ -0,0 +1,183 @@
+//============================================================================
+// Distributed under the MIT License. Author: Raphael Menges
+//============================================================================
+
+#include "CompressedTrajectory.h"
+#include <cmath>
+
+// Count of values which share one bit width
+const int blockSize = 32;
+
+// Quantized values are clamped, so differences of two of them fit into 32 bits. Value is exactly
+// representable as float, unlike 2^30 - 1 which is rounded up to 2^30 and lets differences overflow
+const float maxQuantizedValue = 536870912.f; // 2^29
+
+// Map signed to unsigned value, so small magnitudes need few bits
+inline uint32_t zigzag(int32_t value) { return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31); }
+inline int32_t unzigzag(uint32_t value) { return (int32_t)(value >> 1) ^ -(int32_t)(value & 1); }
+
+CompressedTrajectory::CompressedTrajectory(int atomCount, float precision, int keyframeInterval)
+{
+    mAtomCount = atomCount;
+    mPrecision = glm::max(precision, 1e-6f);
+    mInversePrecision = 1.f / mPrecision;
+    mKeyframeInterval = glm::max(1, keyframeInterval);
+    mKeyframeValues.resize(3 * mAtomCount, 0);
+}
+
+CompressedTrajectory::CompressedTrajectory(const Trajectory& rTrajectory, float precision, int keyframeInterval, int startFrame)
+    : CompressedTrajectory(rTrajectory.getAtomCount(), precision, keyframeInterval)
+{
+    for(int i = startFrame; i < rTrajectory.getFrameCount(); i++)
+    {
+        addFrame(rTrajectory.getFrameData(i));
+    }
+}
+
+CompressedTrajectory::~CompressedTrajectory()
+{
+    // Nothing to do
+}
+
+void CompressedTrajectory::addFrame(const glm::vec3* pPositions)
+{
+    std::vector<int32_t> values(3 * mAtomCount);
+    quantize(pPositions, values.data());
+
+    // Keyframe is encoded as difference to previous atom, other frames as difference to keyframe
+    bool isKeyframe = (getFrameCount() % mKeyframeInterval) == 0;
+    if(isKeyframe)
+    {
+        mKeyframeValues = values;
+        for(int c = 0; c < 3; c++)
+        {
+            int32_t* pComponent = values.data() + c * mAtomCount;
+            for(int i = mAtomCount - 1; i > 0; i--) { pComponent[i] -= pComponent[i - 1]; }
+        }
+    }
+    else
+    {
+        for(int i = 0; i < 3 * mAtomCount; i++) { values[i] -= mKeyframeValues[i]; }
+    }
+
+    // Encode it
+    mFrameOffsets.push_back(mData.size());
+    encode(values.data());
+}
+
+bool CompressedTrajectory::readFrame(int frame, glm::vec3* pPositions) const
+{
+    if(frame < 0 || frame >= getFrameCount()) { return false; }
+
+    // Every frame needs its keyframe
+    int keyframe = frame - (frame % mKeyframeInterval);
+    std::vector<int32_t> values(3 * mAtomCount);
+    decodeKeyframe(keyframe, values.data());
+
+    // Add differences to keyframe
+    if(frame != keyframe)
+    {
+        std::vector<int32_t> differences(mAtomCount);
+        const unsigned char* pData = mData.data() + mFrameOffsets.at(frame);
+        for(int c = 0; c < 3; c++)
+        {
+            pData = decode(pData, differences.data());
+            int32_t* pComponent = values.data() + c * mAtomCount;
+            for(int i = 0; i < mAtomCount; i++) { pComponent[i] += differences[i]; }
+        }
+    }
+
+    // Convert back to coordinates, simple loop over each component which is vectorized by compiler
+    float* pCoordinates = (float*)pPositions;
+    for(int c = 0; c < 3; c++)
+    {
+        const int32_t* pComponent = values.data() + c * mAtomCount;
+        for(int i = 0; i < mAtomCount; i++) { pCoordinates[3 * i + c] = (float)pComponent[i] * mPrecision; }
+    }
+    return true;
+}
+
+void CompressedTrajectory::quantize(const glm::vec3* pPositions, int32_t* pValues) const
+{
+    for(int c = 0; c < 3; c++)
+    {
+        for(int i = 0; i < mAtomCount; i++)
+        {
+            float value = glm::clamp(std::round(pPositions[i][c] * mInversePrecision), -maxQuantizedValue, maxQuantizedValue);
+            pValues[c * mAtomCount + i] = (int32_t)value;
+        }
+    }
+}
+
+void CompressedTrajectory::encode(const int32_t* pValues)
+{
+    for(int c = 0; c < 3; c++)
+    {
+        const int32_t* pComponent = pValues + c * mAtomCount;
+        for(int blockStart = 0; blockStart < mAtomCount; blockStart += blockSize)
+        {
+            int blockEnd = glm::min(blockStart + blockSize, mAtomCount);
+
+            // Bit width of block is decided by largest magnitude
+            uint32_t maxValue = 0;
+            for(int i = blockStart; i < blockEnd; i++) { maxValue |= zigzag(pComponent[i]); }
+            int bitCount = 0;
+            while(bitCount < 32 && (maxValue >> bitCount) != 0) { bitCount++; }
+            mData.push_back((unsigned char)bitCount);
+
+            // Pack values, block ends at full byte
+            uint64_t accumulator = 0;
+            int accumulatedBitCount = 0;
+            for(int i = blockStart; i < blockEnd; i++)
+            {
+                accumulator |= (uint64_t)zigzag(pComponent[i]) << accumulatedBitCount;
+                accumulatedBitCount += bitCount;
+                while(accumulatedBitCount >= 8)
+                {
+                    mData.push_back((unsigned char)accumulator);
+                    accumulator >>= 8;
+                    accumulatedBitCount -= 8;
+                }
+            }
+            if(accumulatedBitCount > 0) { mData.push_back((unsigned char)accumulator); }
+        }
+    }
+}
+
+const unsigned char* CompressedTrajectory::decode(const unsigned char* pData, int32_t* pValues) const
+{
+    for(int blockStart = 0; blockStart < mAtomCount; blockStart += blockSize)
+    {
+        int blockEnd = glm::min(blockStart + blockSize, mAtomCount);
+        int bitCount = *pData++;
+        uint64_t mask = (1ull << bitCount) - 1;
+
+        // Unpack values
+        uint64_t accumulator = 0;
+        int accumulatedBitCount = 0;
+        for(int i = blockStart; i < blockEnd; i++)
+        {
+            while(accumulatedBitCount < bitCount)
+            {
+                accumulator |= (uint64_t)(*pData++) << accumulatedBitCount;
+                accumulatedBitCount += 8;
+            }
+            pValues[i] = unzigzag((uint32_t)(accumulator & mask));
+            accumulator >>= bitCount;
+            accumulatedBitCount -= bitCount;
+        }
+    }
+    return pData;
+}
+
+void CompressedTrajectory::decodeKeyframe(int keyframe, int32_t* pValues) const
+{
+    const unsigned char* pData = mData.data() + mFrameOffsets.at(keyframe);
+    for(int c = 0; c < 3; c++)
+    {
+        // Sum up differences to previous atom
+        int32_t* pComponent = pValues + c * mAtomCount;
+        pData = decode(pData, pComponent);
+        for(int i = 1; i < mAtomCount; i++) { pComponent[i] += pComponent[i - 1]; }
+    }
+}
@@ -0,0 +1,84 @@
+//============================================================================
+// Distributed under the MIT License. Author: Raphael Menges
+//============================================================================
+
+// Trajectory compressed in memory. Coordinates are quantized to fixed point at
+// given precision. Every keyframe interval many frames, a keyframe is stored as
+// difference of each atom to the previous one, all other frames as difference
+// to their keyframe, so each frame is decoded from two frames at most. Values
+// are bit packed in blocks with common bit width. Decoding is done on demand,
+// usually through a frame cache as trajectory provider.
+
+#ifndef COMPRESSED_TRAJECTORY_H
+#define COMPRESSED_TRAJECTORY_H
+
+#include "Molecule/NativeLoader/TrajectoryProvider.h"
+#include "Molecule/MDtrajLoader/Data/Trajectory.h"
+#include <glm/glm.hpp>
+#include <vector>
+#include <cstdint>
+
+class CompressedTrajectory : public TrajectoryProvider
+{
+public:
+
+    // Constructor. Precision is step of quantization, decoded coordinates differ at most by half of it
+    CompressedTrajectory(int atomCount, float precision = 0.01f, int keyframeInterval = 10);
+
+    // Constructor which compresses frames [startFrame, frame count[ of trajectory
+    CompressedTrajectory(const Trajectory& rTrajectory, float precision = 0.01f, int keyframeInterval = 10, int startFrame = 0);
+
+    // Destructor
+    virtual ~CompressedTrajectory();
+
+    // Append frame with atom count many positions. Must not be called while frames are read by other threads
+    void addFrame(const glm::vec3* pPositions);
+
+    // Get count of atoms in each frame
+    virtual int getAtomCount() const { return mAtomCount; }
+
+    // Get count of frames
+    virtual int getFrameCount() const { return (int)mFrameOffsets.size(); }
+
+    // Decode frame into memory with space for atom count many entries. Can be called from multiple threads
+    virtual bool readFrame(int frame, glm::vec3* pPositions) const;
+
+    // Get precision of coordinates
+    float getPrecision() const { return mPrecision; }
+
+    // Get count of bytes used by compressed frames
+    size_t getByteCount() const { return mData.size(); }
+
+private:
+
+    // Quantize coordinates of positions, component after component
+    void quantize(const glm::vec3* pPositions, int32_t* pValues) const;
+
+    // Encode component after component of values as bit packed blocks
+    void encode(const int32_t* pValues);
+
+    // Decode values of one component. Returns position after encoded values
+    const unsigned char* decode(const unsigned char* pData, int32_t* pValues) const;
+
+    // Decode all components of keyframe into quantized values
+    void decodeKeyframe(int keyframe, int32_t* pValues) const;
+
+    // Count of atoms in each frame
+    int mAtomCount;
+
+    // Precision of quantization and its inverse
+    float mPrecision;
+    float mInversePrecision;
+
+    // Count of frames from one keyframe to the next
+    int mKeyframeInterval;
+
+    // Encoded frames and offset of each frame into them
+    std::vector<unsigned char> mData;
+    std::vector<size_t> mFrameOffsets;
+
+    // Quantized values of last keyframe, which further frames are encoded against
+    std::vector<int32_t> mKeyframeValues;
+};
+
+#endif // COMPRESSED_TRAJECTORY_H
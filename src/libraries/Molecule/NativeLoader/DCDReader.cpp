@@ -0,0 +1,166 @@
+//============================================================================
+// Distributed under the MIT License. Author: Raphael Menges
+//============================================================================
+
+#include "DCDReader.h"
+#include "Utils/Logger.h"
+#include <cstring>
+
+// Layout follows the DCD plugin of VMD. Each record is enclosed by its size in bytes as 32 bit integer
+
+// Size of first record with "CORD" and 20 control integers
+const int headerRecordSize = 84;
+
+// Indices of control integers in header
+const int fixedAtomCountControl = 8;
+const int unitCellControl = 10;
+const int fourDimensionsControl = 11;
+const int charmmVersionControl = 19;
+
+// Size of unit cell record with six doubles
+const int unitCellRecordSize = 48;
+
+// Reverse byte order of 32 bit word
+static unsigned int swapBytes(unsigned int value)
+{
+    return (value >> 24) | ((value >> 8) & 0x0000FF00u) | ((value << 8) & 0x00FF0000u) | (value << 24);
+}
+
+DCDReader::DCDReader(std::string filepath)
+{
+    mupFile = std::unique_ptr<MappedFile>(new MappedFile(filepath));
+    if(mupFile->isOpen() && !parseHeader())
+    {
+        mFrameCount = 0;
+        Logger::instance().print("Corrupt or unsupported DCD file: " + filepath, Logger::Mode::ERROR);
+    }
+}
+
+DCDReader::~DCDReader()
+{
+    // Nothing to do
+}
+
+bool DCDReader::decodeFrame(int fileFrame, glm::vec3* pPositions) const
+{
+    if(fileFrame < 0 || fileFrame >= mFrameCount) { return false; }
+
+    // Interleave separately stored coordinates
+    for(int component = 0; component < 3; component++)
+    {
+        const char* pData = mupFile->getData() + getComponentOffset(fileFrame, component);
+        for(int i = 0; i < mAtomCount; i++)
+        {
+            unsigned int bits;
+            std::memcpy(&bits, pData + 4 * i, sizeof(bits));
+            if(mSwapBytes) { bits = swapBytes(bits); }
+            std::memcpy(&pPositions[i][component], &bits, sizeof(bits));
+        }
+    }
+    return true;
+}
+
+bool DCDReader::decodeAtoms(int fileFrame, const int* pAtomIndices, int count, glm::vec3* pPositions) const
+{
+    // Files in other byte order are decoded completely
+    Trajectory::ComponentView x(NULL, 0), y(NULL, 0), z(NULL, 0);
+    if(!getComponent(fileFrame, 0, x) || !getComponent(fileFrame, 1, y) || !getComponent(fileFrame, 2, z))
+    {
+        return TrajectoryFile::decodeAtoms(fileFrame, pAtomIndices, count, pPositions);
+    }
+
+    // Gather selected atoms from mapped coordinates
+    for(int i = 0; i < count; i++)
+    {
+        int atomIndex = pAtomIndices[i];
+        pPositions[i] = glm::vec3(x[atomIndex], y[atomIndex], z[atomIndex]);
+    }
+    return true;
+}
+
+bool DCDReader::getComponent(int fileFrame, int component, Trajectory::ComponentView& rView) const
+{
+    if(fileFrame < 0 || fileFrame >= mFrameCount || component < 0 || component > 2) { return false; }
+    if(mSwapBytes) { return false; }
+
+    // Floats must be aligned to be used in place, which holds for all regular files since records have sizes of whole words
+    const char* pData = mupFile->getData() + getComponentOffset(fileFrame, component);
+    if((size_t)pData % alignof(float) != 0) { return false; }
+    rView = Trajectory::ComponentView((const float*)pData, mAtomCount, 1);
+    return true;
+}
+
+bool DCDReader::parseHeader()
+{
+    size_t size = mupFile->getSize();
+    if(size < headerRecordSize + 8) { return false; }
+
+    // Byte order is detected by size of first record
+    if(readInt(0) != headerRecordSize)
+    {
+        mSwapBytes = true;
+        if(readInt(0) != headerRecordSize) { return false; }
+    }
+    if(std::memcmp(mupFile->getData() + 4, "CORD", 4) != 0 || readInt(4 + headerRecordSize) != headerRecordSize) { return false; }
+
+    // Control integers. Fields after X-PLOR are only valid for CHARMM files
+    int controls[20];
+    for(int i = 0; i < 20; i++)
+    {
+        controls[i] = readInt(8 + 4 * i);
+    }
+    bool charmm = controls[charmmVersionControl] != 0;
+    bool unitCell = charmm && controls[unitCellControl] != 0;
+    bool fourDimensions = charmm && controls[fourDimensionsControl] != 0;
+
+    // Files with fixed atoms store only free atoms after first frame, so frames would have different sizes
+    if(controls[fixedAtomCountControl] != 0)
+    {
+        Logger::instance().print("DCD files with fixed atoms are not supported: " + mupFile->getFilepath(), Logger::Mode::ERROR);
+        return false;
+    }
+
+    // Skip title record
+    size_t offset = headerRecordSize + 8;
+    if(offset + 4 > size) { return false; }
+    int titleSize = readInt(offset);
+    if(titleSize < 0 || offset + 8 + (size_t)titleSize > size || readInt(offset + 4 + titleSize) != titleSize) { return false; }
+    offset += 8 + titleSize;
+
+    // Count of atoms
+    if(offset + 12 > size || readInt(offset) != 4 || readInt(offset + 8) != 4) { return false; }
+    mAtomCount = readInt(offset + 4);
+    if(mAtomCount <= 0) { return false; }
+    offset += 12;
+
+    // Frames have fixed size of optional unit cell, three coordinates and optional fourth dimension
+    size_t coordinateRecordSize = 8 + 4 * (size_t)mAtomCount;
+    mFirstFrameOffset = offset;
+    mUnitCellSize = unitCell ? unitCellRecordSize + 8 : 0;
+    mFrameSize = mUnitCellSize + 3 * coordinateRecordSize + (fourDimensions ? coordinateRecordSize : 0);
+    mFrameCount = (int)((size - mFirstFrameOffset) / mFrameSize);
+
+    // Check records of first frame, later ones are assumed to fit, so frames are accessed without scanning
+    if(mFrameCount > 0)
+    {
+        if(unitCell && readInt(mFirstFrameOffset) != unitCellRecordSize) { return false; }
+        for(int component = 0; component < 3; component++)
+        {
+            size_t recordOffset = getComponentOffset(0, component) - 4;
+            if(readInt(recordOffset) != 4 * mAtomCount || readInt(recordOffset + coordinateRecordSize - 4) != 4 * mAtomCount) { return false; }
+        }
+    }
+    return true;
+}
+
+int DCDReader::readInt(size_t offset) const
+{
+    unsigned int bits;
+    std::memcpy(&bits, mupFile->getData() + offset, sizeof(bits));
+    return (int)(mSwapBytes ? swapBytes(bits) : bits);
+}
+
+size_t DCDReader::getComponentOffset(int fileFrame, int component) const
+{
+    return mFirstFrameOffset + (size_t)fileFrame * mFrameSize + mUnitCellSize + (size_t)component * (8 + 4 * (size_t)mAtomCount) + 4;
+}
@@ -0,0 +1,82 @@
+//============================================================================
+// Distributed under the MIT License. Author: Raphael Menges
+//============================================================================
+
+// Native reader of CHARMM and NAMD DCD trajectories. Frames are uncompressed
+// and have fixed size, so file is memory mapped and each frame is found by its
+// offset without scanning. Coordinates of a frame are stored separately for x,
+// y and z, which are exposed as views on the mapped file without copying them.
+
+#ifndef DCD_READER_H
+#define DCD_READER_H
+
+#include "Molecule/NativeLoader/MappedFile.h"
+#include "Molecule/NativeLoader/TrajectoryFile.h"
+#include "Molecule/MDtrajLoader/Data/Trajectory.h"
+#include <glm/glm.hpp>
+#include <string>
+#include <memory>
+
+class DCDReader : public TrajectoryFile
+{
+public:
+
+    // Constructor, maps file and parses header. Check isOpen afterwards
+    DCDReader(std::string filepath);
+
+    // Destructor
+    virtual ~DCDReader();
+
+    // Get count of atoms in each frame of file
+    virtual int getFileAtomCount() const { return mAtomCount; }
+
+    // Get count of frames in file
+    virtual int getFileFrameCount() const { return mFrameCount; }
+
+    // Decode one frame of file with all its atoms into positions with space for file atom count many entries.
+    // Ignores selection. Coordinates are in angstrom already
+    virtual bool decodeFrame(int fileFrame, glm::vec3* pPositions) const;
+
+    // Decode atoms with given indices in file of one frame of file. Gathers them directly from views on mapped
+    // coordinates if possible, so frames with stripped atoms are not decoded completely
+    virtual bool decodeAtoms(int fileFrame, const int* pAtomIndices, int count, glm::vec3* pPositions) const;
+
+    // Get view on one coordinate of all atoms of a frame in file (0 is x, 1 is y and 2 is z) without copying it.
+    // Ignores selection. Only possible for files in native byte order, returns false otherwise
+    bool getComponent(int fileFrame, int component, Trajectory::ComponentView& rView) const;
+
+    // Get whether coordinates can be viewed without copying them
+    bool isZeroCopy() const { return !mSwapBytes; }
+
+private:
+
+    // Parse header records and compute size of frames. Returns false if file is no supported DCD
+    bool parseHeader();
+
+    // Read integer of file in its byte order
+    int readInt(size_t offset) const;
+
+    // Get offset of first float of one coordinate of a frame in file
+    size_t getComponentOffset(int fileFrame, int component) const;
+
+    // Memory mapped file
+    std::unique_ptr<MappedFile> mupFile;
+
+    // Whether byte order of file differs from native one
+    bool mSwapBytes = false;
+
+    // Count of atoms in each frame
+    int mAtomCount = 0;
+
+    // Count of complete frames in file
+    int mFrameCount = 0;
+
+    // Offset of first frame and size of each frame in bytes
+    size_t mFirstFrameOffset = 0;
+    size_t mFrameSize = 0;
+
+    // Bytes of unit cell record in front of coordinates of each frame, zero if there is none
+    size_t mUnitCellSize = 0;
+};
+
+#endif // DCD_READER_H
@@ -0,0 +1,24 @@
+//============================================================================
+// Distributed under the MIT License. Author: Raphael Menges
+//============================================================================
+
+#include "ElementCache.h"
+#include "Molecule/MDtrajLoader/Data/AtomLUT.h"
+
+const float ElementCache::defaultRadius = 1.5f;
+
+const std::string ElementCache::unknownElementName = "other";
+
+const std::pair<std::string, float>& ElementCache::resolve(const std::string& rSymbol)
+{
+    auto it = mElements.find(rSymbol);
+    if(it == mElements.end())
+    {
+        auto nameIt = AtomLUT::element_names.find(rSymbol);
+        std::string elementName = nameIt != AtomLUT::element_names.end() ? nameIt->second : unknownElementName;
+        auto radiusIt = AtomLUT::vdW_radii_picometer.find(elementName);
+        float radius = radiusIt != AtomLUT::vdW_radii_picometer.end() ? (float)radiusIt->second / 100.f : defaultRadius;
+        it = mElements.insert(std::make_pair(rSymbol, std::make_pair(elementName, radius))).first;
+    }
+    return it->second;
+}
@@ -0,0 +1,35 @@
+//============================================================================
+// Distributed under the MIT License. Author: Raphael Menges
+//============================================================================
+
+// Resolution of element symbols to element names and van der Waals radii, as
+// needed by all readers of structure files. Results are cached per symbol, so
+// the lookup tables are only asked once per element.
+
+#ifndef ELEMENT_CACHE_H
+#define ELEMENT_CACHE_H
+
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+class ElementCache
+{
+public:
+
+    // Radius in angstrom used for elements without known van der Waals radius
+    static const float defaultRadius;
+
+    // Name of elements which are not known
+    static const std::string unknownElementName;
+
+    // Get element name and van der Waals radius in angstrom of upper case element symbol, e.g. C or NA
+    const std::pair<std::string, float>& resolve(const std::string& rSymbol);
+
+private:
+
+    // Element name and radius per element symbol
+    std::unordered_map<std::string, std::pair<std::string, float> > mElements;
+};
+
+#endif // ELEMENT_CACHE_H
@@ -0,0 +1,101 @@
+//============================================================================
+// Distributed under the MIT License. Author: Raphael Menges
+//============================================================================
+
+#include "FixedColumns.h"
+#include <algorithm>
+#include <cstring>
+#include <cstdlib>
+#include <cctype>
+
+void FixedColumns::readField(const char* pLine, size_t length, size_t firstColumn, size_t lastColumn, const char*& rpBegin, const char*& rpEnd)
+{
+    rpBegin = pLine + std::min(length, firstColumn - 1);
+    rpEnd = pLine + std::min(length, lastColumn);
+    while(rpBegin < rpEnd && std::isspace((unsigned char)*rpBegin)) { rpBegin++; }
+    while(rpEnd > rpBegin && std::isspace((unsigned char)*(rpEnd - 1))) { rpEnd--; }
+}
+
+bool FixedColumns::parseInt(const char* pLine, size_t length, size_t firstColumn, size_t lastColumn, int& rValue)
+{
+    const char* pBegin;
+    const char* pEnd;
+    readField(pLine, length, firstColumn, lastColumn, pBegin, pEnd);
+    if(pBegin == pEnd) { return false; }
+
+    // Decimal numbers
+    if(std::isdigit((unsigned char)*pBegin) || *pBegin == '-')
+    {
+        char pBuffer[16];
+        size_t count = std::min((size_t)(pEnd - pBegin), sizeof(pBuffer) - 1);
+        std::memcpy(pBuffer, pBegin, count);
+        pBuffer[count] = '\0';
+        char* pParsedEnd;
+        rValue = (int)std::strtol(pBuffer, &pParsedEnd, 10);
+        return pParsedEnd != pBuffer;
+    }
+
+    // Hybrid-36, upper case digits follow the decimal numbers, lower case digits follow upper case ones
+    int width = (int)(lastColumn - firstColumn) + 1;
+    if(pEnd - pBegin != width) { return false; }
+    bool upperCase = std::isupper((unsigned char)*pBegin);
+    int value = 0;
+    for(const char* pChar = pBegin; pChar < pEnd; pChar++)
+    {
+        int digit;
+        if(std::isdigit((unsigned char)*pChar)) { digit = *pChar - '0'; }
+        else if(upperCase && std::isupper((unsigned char)*pChar)) { digit = *pChar - 'A' + 10; }
+        else if(!upperCase && std::islower((unsigned char)*pChar)) { digit = *pChar - 'a' + 10; }
+        else { return false; }
+        value = value * 36 + digit;
+    }
+    int power36 = 1;
+    int power10 = 1;
+    for(int i = 0; i < width - 1; i++) { power36 *= 36; power10 *= 10; }
+    power10 *= 10;
+    rValue = upperCase ? value - 10 * power36 + power10 : value + 16 * power36 + power10;
+    return true;
+}
+
+float FixedColumns::parseFloat(const char* pLine, size_t length, size_t firstColumn, size_t lastColumn)
+{
+    const char* pBegin;
+    const char* pEnd;
+    readField(pLine, length, firstColumn, lastColumn, pBegin, pEnd);
+
+    // Fixed point notation
+    const char* pChar = pBegin;
+    bool negative = pChar < pEnd && *pChar == '-';
+    if(negative) { pChar++; }
+    long long mantissa = 0;
+    int fractionDigits = -1;
+    for(; pChar < pEnd; pChar++)
+    {
+        if(std::isdigit((unsigned char)*pChar))
+        {
+            mantissa = mantissa * 10 + (*pChar - '0');
+            if(fractionDigits >= 0) { fractionDigits++; }
+        }
+        else if(*pChar == '.' && fractionDigits < 0)
+        {
+            fractionDigits = 0;
+        }
+        else
+        {
+            break;
+        }
+    }
+    if(pChar == pEnd && pEnd - pBegin < 16)
+    {
+        double value = (double)mantissa;
+        for(int i = 0; i < fractionDigits; i++) { value /= 10.0; }
+        return (float)(negative ? -value : value);
+    }
+
+    // Any other notation
+    char pBuffer[32];
+    size_t count = std::min((size_t)(pEnd - pBegin), sizeof(pBuffer) - 1);
+    std::memcpy(pBuffer, pBegin, count);
+    pBuffer[count] = '\0';
+    return std::strtof(pBuffer, NULL);
+}
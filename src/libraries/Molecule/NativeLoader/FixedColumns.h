@@ -0,0 +1,27 @@
+//============================================================================
+// Distributed under the MIT License. Author: Raphael Menges
+//============================================================================
+
+// Parsing of fields in text formats with fixed columns, like PDB and GRO. Lines
+// are not copied, columns are counted from one like in format descriptions.
+
+#ifndef FIXED_COLUMNS_H
+#define FIXED_COLUMNS_H
+
+#include <cstddef>
+
+class FixedColumns
+{
+public:
+
+    // Get trimmed field of line between columns [firstColumn, lastColumn]
+    static void readField(const char* pLine, size_t length, size_t firstColumn, size_t lastColumn, const char*& rpBegin, const char*& rpEnd);
+
+    // Parse integer of field. Supports hybrid-36 encoding used for more than 99999 atoms or 9999 residues
+    static bool parseInt(const char* pLine, size_t length, size_t firstColumn, size_t lastColumn, int& rValue);
+
+    // Parse floating point number of field. Usual fixed point notation is parsed directly, anything else by strtof
+    static float parseFloat(const char* pLine, size_t length, size_t firstColumn, size_t lastColumn);
+};
+
+#endif // FIXED_COLUMNS_H
@@ -0,0 +1,183 @@
+//============================================================================
+// Distributed under the MIT License. Author: Raphael Menges
+//============================================================================
+
+#include "FrameCache.h"
+#include "Utils/Logger.h"
+
+FrameCache::FrameCache(std::shared_ptr<const TrajectoryProvider> spProvider, int capacity, int readAheadCount)
+{
+    mspProvider = spProvider;
+    mReadAheadCount = glm::max(0, readAheadCount);
+    mCapacity = glm::max(capacity, mReadAheadCount + 1);
+
+    // Start read ahead thread
+    if(mReadAheadCount > 0)
+    {
+        mReadAheadThread = std::thread(&FrameCache::readAhead, this);
+    }
+}
+
+FrameCache::~FrameCache()
+{
+    // Stop read ahead thread
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStop = true;
+    }
+    mCondition.notify_all();
+    if(mReadAheadThread.joinable())
+    {
+        mReadAheadThread.join();
+    }
+}
+
+std::shared_ptr<const std::vector<glm::vec3> > FrameCache::getFrame(int frame)
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+
+    // Direction of playback decides which frames are read ahead
+    int direction = frame >= mLastRequestedFrame ? 1 : -1;
+    mLastRequestedFrame = frame;
+
+    std::shared_ptr<const std::vector<glm::vec3> > spFrame;
+    while(true)
+    {
+        // Cached
+        auto it = mEntries.find(frame);
+        if(it != mEntries.end())
+        {
+            spFrame = it->second.spFrame;
+            touch(frame);
+            break;
+        }
+
+        // Currently read by other thread, wait for it
+        if(mLoadingFrames.count(frame) > 0)
+        {
+            mCondition.wait(lock);
+            continue;
+        }
+
+        // Read it without holding the lock
+        mLoadingFrames.insert(frame);
+        lock.unlock();
+        spFrame = readFrame(frame);
+        lock.lock();
+        mLoadingFrames.erase(frame);
+        if(spFrame)
+        {
+            insert(frame, spFrame);
+        }
+        else
+        {
+            Logger::instance().print("Could not read frame " + std::to_string(frame) + " of trajectory", Logger::Mode::ERROR);
+        }
+        mCondition.notify_all();
+        break;
+    }
+
+    // Prepare next frames
+    requestReadAhead(frame, direction);
+    return spFrame;
+}
+
+void FrameCache::clear()
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    mEntries.clear();
+    mRecentlyUsed.clear();
+    mReadAheadQueue.clear();
+}
+
+std::shared_ptr<const std::vector<glm::vec3> > FrameCache::readFrame(int frame) const
+{
+    if(frame < 0 || frame >= mspProvider->getFrameCount()) { return std::shared_ptr<const std::vector<glm::vec3> >(); }
+    std::shared_ptr<std::vector<glm::vec3> > spFrame(new std::vector<glm::vec3>(mspProvider->getAtomCount()));
+    if(!mspProvider->readFrame(frame, spFrame->data())) { return std::shared_ptr<const std::vector<glm::vec3> >(); }
+    return spFrame;
+}
+
+void FrameCache::insert(int frame, std::shared_ptr<const std::vector<glm::vec3> > spFrame)
+{
+    // Add as most recently used
+    mRecentlyUsed.push_front(frame);
+    Entry entry;
+    entry.spFrame = spFrame;
+    entry.recentlyUsedPosition = mRecentlyUsed.begin();
+    mEntries[frame] = entry;
+
+    // Evict least recently used frames
+    while((int)mEntries.size() > mCapacity)
+    {
+        mEntries.erase(mRecentlyUsed.back());
+        mRecentlyUsed.pop_back();
+    }
+}
+
+void FrameCache::touch(int frame)
+{
+    Entry& rEntry = mEntries.at(frame);
+    mRecentlyUsed.splice(mRecentlyUsed.begin(), mRecentlyUsed, rEntry.recentlyUsedPosition);
+}
+
+void FrameCache::requestReadAhead(int frame, int direction)
+{
+    if(mReadAheadCount <= 0) { return; }
+
+    // Requests for previous playhead position are outdated
+    mReadAheadQueue.clear();
+    int frameCount = mspProvider->getFrameCount();
+    for(int i = 1; i <= mReadAheadCount; i++)
+    {
+        int nextFrame = frame + direction * i;
+        if(nextFrame < 0 || nextFrame >= frameCount) { break; }
+        auto it = mEntries.find(nextFrame);
+        if(it != mEntries.end())
+        {
+            // Keep it, but do not mark it more recent than requested frame
+            continue;
+        }
+        if(mLoadingFrames.count(nextFrame) == 0)
+        {
+            mReadAheadQueue.push_back(nextFrame);
+        }
+    }
+    if(!mReadAheadQueue.empty())
+    {
+        mCondition.notify_all();
+    }
+}
+
+void FrameCache::readAhead()
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+    while(true)
+    {
+        // Wait for work
+        mCondition.wait(lock, [this]() { return mStop || !mReadAheadQueue.empty(); });
+        if(mStop) { return; }
+
+        // Take next frame, which may have been read meanwhile
+        int frame = mReadAheadQueue.front();
+        mReadAheadQueue.pop_front();
+        if(mEntries.count(frame) > 0 || mLoadingFrames.count(frame) > 0) { continue; }
+
+        // Read it without holding the lock
+        mLoadingFrames.insert(frame);
+        lock.unlock();
+        std::shared_ptr<const std::vector<glm::vec3> > spFrame = readFrame(frame);
+        lock.lock();
+        mLoadingFrames.erase(frame);
+        if(spFrame)
+        {
+            // Requested frame stays more recent than read ahead frames, so they never evict it
+            insert(frame, spFrame);
+            if(mLastRequestedFrame != frame && mEntries.count(mLastRequestedFrame) > 0)
+            {
+                touch(mLastRequestedFrame);
+            }
+        }
+        mCondition.notify_all();
+    }
+}
@@ -0,0 +1,109 @@
+//============================================================================
+// Distributed under the MIT License. Author: Raphael Menges
+//============================================================================
+
+// Bounded cache of trajectory frames with least recently used eviction. Frames
+// following the requested one in direction of playback are read ahead by a
+// background thread.
+
+#ifndef FRAME_CACHE_H
+#define FRAME_CACHE_H
+
+#include "Molecule/NativeLoader/TrajectoryProvider.h"
+#include <glm/glm.hpp>
+#include <vector>
+#include <list>
+#include <deque>
+#include <set>
+#include <unordered_map>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+
+class FrameCache
+{
+public:
+
+    // Constructor. Capacity is count of frames kept in memory, at least one more than read ahead count
+    FrameCache(std::shared_ptr<const TrajectoryProvider> spProvider, int capacity, int readAheadCount = 4);
+
+    // Destructor, stops read ahead thread
+    virtual ~FrameCache();
+
+    // Get frame, read it when not cached. Returned frame stays valid even when evicted from cache.
+    // Returns empty pointer if frame could not be read. Can be called from multiple threads
+    std::shared_ptr<const std::vector<glm::vec3> > getFrame(int frame);
+
+    // Get count of atoms in each frame
+    int getAtomCount() const { return mspProvider->getAtomCount(); }
+
+    // Get count of frames of provider
+    int getFrameCount() const { return mspProvider->getFrameCount(); }
+
+    // Get count of frames kept in memory
+    int getCapacity() const { return mCapacity; }
+
+    // Remove all frames from cache
+    void clear();
+
+private:
+
+    // No copies of cache
+    FrameCache(const FrameCache&);
+    FrameCache& operator=(const FrameCache&);
+
+    // Read frame from provider, returns empty pointer on failure. Call without lock
+    std::shared_ptr<const std::vector<glm::vec3> > readFrame(int frame) const;
+
+    // Insert frame as most recently used and evict least recently used ones. Call with lock
+    void insert(int frame, std::shared_ptr<const std::vector<glm::vec3> > spFrame);
+
+    // Mark frame as most recently used. Call with lock
+    void touch(int frame);
+
+    // Queue frames after requested one for read ahead. Call with lock
+    void requestReadAhead(int frame, int direction);
+
+    // Loop of read ahead thread
+    void readAhead();
+
+    // Entry of cache
+    struct Entry
+    {
+        std::shared_ptr<const std::vector<glm::vec3> > spFrame;
+        std::list<int>::iterator recentlyUsedPosition;
+    };
+
+    // Source of frames
+    std::shared_ptr<const TrajectoryProvider> mspProvider;
+
+    // Count of frames kept in memory
+    int mCapacity;
+
+    // Count of frames read ahead
+    int mReadAheadCount;
+
+    // Cached frames and their order of usage (front is most recently used)
+    std::unordered_map<int, Entry> mEntries;
+    std::list<int> mRecentlyUsed;
+
+    // Frames currently read by any thread, so no frame is read twice
+    std::set<int> mLoadingFrames;
+
+    // Frames to read ahead
+    std::deque<int> mReadAheadQueue;
+
+    // Last requested frame, used to determine direction of playback
+    int mLastRequestedFrame = -1;
+
+    // Synchronization
+    std::mutex mMutex;
+    std::condition_variable mCondition;
+    bool mStop = false;
+
+    // Thread reading ahead
+    std::thread mReadAheadThread;
+};
+
+#endif // FRAME_CACHE_H
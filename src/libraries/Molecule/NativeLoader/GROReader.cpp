@@ -0,0 +1,204 @@
+//============================================================================
+// Distributed under the MIT License. Author: Raphael Menges
+//============================================================================
+
+#include "GROReader.h"
+#include "FixedColumns.h"
+#include "ElementCache.h"
+#include "Molecule/MDtrajLoader/Data/AtomLUT.h"
+#include "Utils/Logger.h"
+#include <algorithm>
+#include <cstring>
+#include <cstdlib>
+#include <cctype>
+#include <iterator>
+
+// Conversion from nanometer to angstrom
+const float nanometerToAngstrom = 10.f;
+
+// Columns of residue number, residue name and atom name. Coordinates follow, by default with eight columns each
+const size_t residueNumberColumns[2] = { 1, 5 };
+const size_t residueNameColumns[2] = { 6, 10 };
+const size_t atomNameColumns[2] = { 11, 15 };
+const size_t firstCoordinateColumn = 21;
+const size_t defaultCoordinateWidth = 8;
+
+// Find next line, which ends before carriage return and line feed
+static const char* nextLine(const char* pLine, const char* pDataEnd, size_t& rLength)
+{
+    const char* pLineEnd = (const char*)std::memchr(pLine, '\n', pDataEnd - pLine);
+    if(pLineEnd == NULL) { pLineEnd = pDataEnd; }
+    rLength = pLineEnd - pLine;
+    if(rLength > 0 && pLine[rLength - 1] == '\r') { rLength--; }
+    return std::min(pLineEnd + 1, pDataEnd);
+}
+
+// Guess element symbol from atom name. Ions are named like their residue, e.g. NA or CL,
+// otherwise first letter after leading digits is taken, e.g. C for CA or H for 1HB
+static std::string guessElementSymbol(const std::string& rAtomName, const std::string& rResidueName)
+{
+    std::string symbol;
+    if(rAtomName == rResidueName && rAtomName.size() <= 2)
+    {
+        symbol = rAtomName;
+        std::transform(symbol.begin(), symbol.end(), symbol.begin(), ::toupper);
+        if(AtomLUT::element_names.find(symbol) != AtomLUT::element_names.end()) { return symbol; }
+    }
+    for(char character : rAtomName)
+    {
+        if(std::isalpha((unsigned char)character)) { return std::string(1, (char)std::toupper((unsigned char)character)); }
+    }
+    return "";
+}
+
+GROReader::GROReader(std::string filepath)
+{
+    mupFile = std::unique_ptr<MappedFile>(new MappedFile(filepath));
+}
+
+GROReader::~GROReader()
+{
+    // Nothing to do
+}
+
+bool GROReader::read(
+    std::vector<std::string>& rNames,
+    std::vector<std::string>& rElementNames,
+    std::vector<std::string>& rResidueNames,
+    std::vector<int>& rIndices,
+    std::vector<std::string>&,
+    std::vector<std::string>& rDistinctResidueNames,
+    Trajectory& rTrajectory,
+    std::vector<float>& rRadii,
+    int& rAtomCount,
+    const LoadOptions& rOptions,
+    std::vector<int>* pAtomIndices) const
+{
+    if(!isOpen()) { return false; }
+    const char* pData = mupFile->getData();
+    const char* pDataEnd = pData + mupFile->getSize();
+
+    // Skip title and read count of atoms
+    size_t length;
+    const char* pLine = nextLine(pData, pDataEnd, length);
+    const char* pCountLine = pLine;
+    pLine = nextLine(pCountLine, pDataEnd, length);
+    int fileAtomCount = (int)std::strtol(std::string(pCountLine, length).c_str(), NULL, 10);
+    if(fileAtomCount <= 0)
+    {
+        Logger::instance().print("No atoms found in GRO file: " + mupFile->getFilepath(), Logger::Mode::ERROR);
+        return false;
+    }
+
+    // Reserve memory
+    std::vector<std::string> names;
+    std::vector<std::string> distinctResidueNames;
+    std::vector<std::string> elementNames;
+    std::vector<std::string> residueNames;
+    std::vector<glm::vec3> positions;
+    std::vector<float> radii;
+    std::vector<int> atomIndices;
+    names.reserve(fileAtomCount);
+    distinctResidueNames.reserve(fileAtomCount);
+    elementNames.reserve(fileAtomCount);
+    positions.reserve(fileAtomCount);
+    radii.reserve(fileAtomCount);
+    atomIndices.reserve(fileAtomCount);
+
+    // Element name and radius per element symbol
+    ElementCache elementCache;
+
+    // Residue number and name identify residue
+    char pResidueKey[10];
+    char pPreviousResidueKey[10];
+    std::string distinctResidueName;
+
+    // Width of coordinates is given by distance of their decimal points, which is larger for files with higher precision
+    size_t coordinateWidth = defaultCoordinateWidth;
+
+    // Go over lines of atoms
+    for(int fileAtomIndex = 0; fileAtomIndex < fileAtomCount; fileAtomIndex++)
+    {
+        if(pLine >= pDataEnd)
+        {
+            Logger::instance().print("GRO file ends before all atoms are read: " + mupFile->getFilepath(), Logger::Mode::ERROR);
+            return false;
+        }
+        const char* pAtomLine = pLine;
+        pLine = nextLine(pAtomLine, pDataEnd, length);
+        const char* pBegin;
+        const char* pEnd;
+
+        // Skip atoms of removed residues, like water and ions
+        FixedColumns::readField(pAtomLine, length, residueNameColumns[0], residueNameColumns[1], pBegin, pEnd);
+        std::string residueName(pBegin, pEnd);
+        if(!rOptions.keepsAllAtoms() && !rOptions.keepsResidue(residueName)) { continue; }
+        atomIndices.push_back(fileAtomIndex);
+
+        // Name of atom
+        FixedColumns::readField(pAtomLine, length, atomNameColumns[0], atomNameColumns[1], pBegin, pEnd);
+        names.push_back(std::string(pBegin, pEnd));
+
+        // Residue, new one starts when its number or name changes
+        for(size_t i = 0; i < 10; i++)
+        {
+            pResidueKey[i] = i < length ? pAtomLine[i] : ' ';
+        }
+        if(distinctResidueNames.empty() || std::memcmp(pResidueKey, pPreviousResidueKey, 10) != 0)
+        {
+            std::memcpy(pPreviousResidueKey, pResidueKey, 10);
+            residueNames.push_back(residueName);
+            int residueNumber;
+            if(!FixedColumns::parseInt(pAtomLine, length, residueNumberColumns[0], residueNumberColumns[1], residueNumber)) { residueNumber = (int)residueNames.size(); }
+            distinctResidueName = residueName + std::to_string(residueNumber);
+        }
+        distinctResidueNames.push_back(distinctResidueName);
+
+        // Position
+        if(positions.empty())
+        {
+            const char* pFirstPoint = (const char*)std::memchr(pAtomLine + std::min(length, firstCoordinateColumn - 1), '.', length - std::min(length, firstCoordinateColumn - 1));
+            const char* pSecondPoint = pFirstPoint != NULL ? (const char*)std::memchr(pFirstPoint + 1, '.', pAtomLine + length - pFirstPoint - 1) : NULL;
+            if(pSecondPoint != NULL) { coordinateWidth = pSecondPoint - pFirstPoint; }
+        }
+        size_t column = firstCoordinateColumn;
+        glm::vec3 position;
+        for(int component = 0; component < 3; component++)
+        {
+            position[component] = FixedColumns::parseFloat(pAtomLine, length, column, column + coordinateWidth - 1) * nanometerToAngstrom;
+            column += coordinateWidth;
+        }
+        positions.push_back(position);
+
+        // Element and radius
+        std::string symbol = guessElementSymbol(names.back(), residueName);
+        const std::pair<std::string, float>& rElement = elementCache.resolve(symbol);
+        elementNames.push_back(rElement.first);
+        radii.push_back(rElement.second);
+    }
+
+    if(names.empty())
+    {
+        Logger::instance().print("No atoms found in GRO file: " + mupFile->getFilepath(), Logger::Mode::ERROR);
+        return false;
+    }
+
+    // Frame is appended to trajectory
+    if(!rTrajectory.setAtomCount((int)names.size()))
+    {
+        Logger::instance().print("Count of atoms does not fit to trajectory: " + mupFile->getFilepath(), Logger::Mode::ERROR);
+        return false;
+    }
+
+    // Fill output
+    std::copy(positions.begin(), positions.end(), rTrajectory.addFrames(1));
+    rAtomCount = (int)names.size();
+    for(int i = 0; i < rAtomCount; i++) { rIndices.push_back(i + 1); }
+    rNames.insert(rNames.end(), std::make_move_iterator(names.begin()), std::make_move_iterator(names.end()));
+    rElementNames.insert(rElementNames.end(), std::make_move_iterator(elementNames.begin()), std::make_move_iterator(elementNames.end()));
+    rResidueNames.insert(rResidueNames.end(), std::make_move_iterator(residueNames.begin()), std::make_move_iterator(residueNames.end()));
+    rDistinctResidueNames.insert(rDistinctResidueNames.end(), std::make_move_iterator(distinctResidueNames.begin()), std::make_move_iterator(distinctResidueNames.end()));
+    rRadii.insert(rRadii.end(), radii.begin(), radii.end());
+    if(pAtomIndices != NULL) { *pAtomIndices = atomIndices; }
+    return true;
+}
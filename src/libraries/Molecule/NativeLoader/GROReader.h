@@ -0,0 +1,56 @@
+//============================================================================
+// Distributed under the MIT License. Author: Raphael Menges
+//============================================================================
+
+// Native reader of GROMACS GRO files. File is memory mapped and atoms of the
+// first frame are parsed by their fixed columns without copying lines. GRO has
+// no elements and no bonds, elements are guessed from atom names.
+
+#ifndef GRO_READER_H
+#define GRO_READER_H
+
+#include "Molecule/NativeLoader/MappedFile.h"
+#include "Molecule/NativeLoader/LoadOptions.h"
+#include "Molecule/MDtrajLoader/Data/Trajectory.h"
+#include <glm/glm.hpp>
+#include <vector>
+#include <string>
+#include <memory>
+
+class GROReader
+{
+public:
+
+    // Constructor, maps file. Check isOpen afterwards
+    GROReader(std::string filepath);
+
+    // Destructor
+    virtual ~GROReader();
+
+    // Get whether file could be opened
+    bool isOpen() const { return mupFile->isOpen(); }
+
+    // Parse atoms of first frame into the structures consumed by Protein, like PDBReader does. Positions are converted
+    // to angstrom and appended as frame to the trajectory, which must be empty or fit in atom count. No bonds are
+    // added. Atoms of residues removed by options are skipped, indices of kept atoms within the file are optionally
+    // filled in, so trajectories can select the same atoms. Returns false if no atom was found
+    bool read(
+        std::vector<std::string>& rNames,
+        std::vector<std::string>& rElementNames,
+        std::vector<std::string>& rResidueNames,
+        std::vector<int>& rIndices,
+        std::vector<std::string>& rBonds,
+        std::vector<std::string>& rDistinctResidueNames,
+        Trajectory& rTrajectory,
+        std::vector<float>& rRadii,
+        int& rAtomCount,
+        const LoadOptions& rOptions = LoadOptions(),
+        std::vector<int>* pAtomIndices = NULL) const;
+
+private:
+
+    // Memory mapped file
+    std::unique_ptr<MappedFile> mupFile;
+};
+
+#endif // GRO_READER_H
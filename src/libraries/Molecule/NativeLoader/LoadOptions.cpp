@@ -0,0 +1,49 @@
+//============================================================================
+// Distributed under the MIT License. Author: Raphael Menges
+//============================================================================
+
+#include "LoadOptions.h"
+#include <glm/glm.hpp>
+#include <cctype>
+
+// Residue names of common water models
+const std::set<std::string> waterResidueNames =
+{
+    "HOH", "WAT", "SOL", "H2O", "DOD", "TIP", "TIP3", "TIP4", "TIP5", "T3P", "T4P", "T5P", "SPC", "SPCE"
+};
+
+// Residue names of common monoatomic ions
+const std::set<std::string> ionResidueNames =
+{
+    "NA", "NA+", "SOD", "K", "K+", "POT", "CL", "CL-", "CLA", "MG", "MG2", "CA", "CA2", "CAL",
+    "ZN", "ZN2", "MN", "FE", "FE2", "CU", "CD", "CS", "LI", "RB", "BR", "IOD", "F"
+};
+
+bool LoadOptions::keepsResidue(const std::string& rResidueName) const
+{
+    if(keepsAllAtoms()) { return true; }
+
+    // Residue names are compared in upper case without surrounding spaces
+    std::string name;
+    for(char c : rResidueName)
+    {
+        if(!std::isspace((unsigned char)c)) { name.push_back((char)std::toupper((unsigned char)c)); }
+    }
+    if(stripWater && waterResidueNames.count(name) > 0) { return false; }
+    if(stripIons && ionResidueNames.count(name) > 0) { return false; }
+    return strippedResidueNames.count(rResidueName) == 0 && strippedResidueNames.count(name) == 0;
+}
+
+int LoadOptions::getFrameCount(int fileFrameCount) const
+{
+    int start = glm::max(0, startFrame);
+    int stop = stopFrame < 0 ? fileFrameCount : glm::min(stopFrame, fileFrameCount);
+    if(stop <= start) { return 0; }
+    int stride = glm::max(1, frameStride);
+    return (stop - start + stride - 1) / stride;
+}
+
+int LoadOptions::getFileFrame(int frame) const
+{
+    return glm::max(0, startFrame) + frame * glm::max(1, frameStride);
+}
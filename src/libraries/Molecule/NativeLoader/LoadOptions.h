@@ -0,0 +1,50 @@
+//============================================================================
+// Distributed under the MIT License. Author: Raphael Menges
+//============================================================================
+
+// Options which restrict what is loaded. Frames are selected by range and
+// stride, atoms by residue name, so unneeded data is never materialized.
+
+#ifndef LOAD_OPTIONS_H
+#define LOAD_OPTIONS_H
+
+#include <string>
+#include <set>
+
+struct LoadOptions
+{
+    // First frame of trajectory file which is loaded
+    int startFrame = 0;
+
+    // Frame of trajectory file where loading stops (exclusive). Negative means end of file
+    int stopFrame = -1;
+
+    // Only every stride-th frame is loaded
+    int frameStride = 1;
+
+    // Load models of structure file after the first one as further frames, e.g. of NMR ensembles
+    bool readAllModels = true;
+
+    // Remove water molecules
+    bool stripWater = false;
+
+    // Remove monoatomic ions
+    bool stripIons = false;
+
+    // Further residue names which are removed
+    std::set<std::string> strippedResidueNames;
+
+    // Get whether atoms of residue are loaded
+    bool keepsResidue(const std::string& rResidueName) const;
+
+    // Get whether all atoms are loaded
+    bool keepsAllAtoms() const { return !stripWater && !stripIons && strippedResidueNames.empty(); }
+
+    // Get count of frames loaded from file with given count of frames
+    int getFrameCount(int fileFrameCount) const;
+
+    // Get frame of file for index of loaded frame
+    int getFileFrame(int frame) const;
+};
+
+#endif // LOAD_OPTIONS_H
@@ -0,0 +1,57 @@
+//============================================================================
+// Distributed under the MIT License. Author: Raphael Menges
+//============================================================================
+
+#include "MappedFile.h"
+#include "Utils/Logger.h"
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+MappedFile::MappedFile(std::string filepath, bool copyOnWrite)
+{
+    mFilepath = filepath;
+    mCopyOnWrite = copyOnWrite;
+
+    // Open file
+    int fileDescriptor = open(filepath.c_str(), O_RDONLY);
+    if(fileDescriptor < 0)
+    {
+        Logger::instance().print("Could not open file: " + filepath, Logger::Mode::ERROR);
+        return;
+    }
+
+    // Determine size
+    struct stat fileStatus;
+    if(fstat(fileDescriptor, &fileStatus) < 0 || fileStatus.st_size == 0)
+    {
+        Logger::instance().print("Could not determine size or empty file: " + filepath, Logger::Mode::ERROR);
+        close(fileDescriptor);
+        return;
+    }
+    mSize = (size_t)fileStatus.st_size;
+    mModificationTime = (long long)fileStatus.st_mtime;
+
+    // Map it, file descriptor is not needed after mapping. Private mapping never writes back to file
+    void* pMapping = mmap(NULL, mSize, copyOnWrite ? PROT_READ | PROT_WRITE : PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+    close(fileDescriptor);
+    if(pMapping == MAP_FAILED)
+    {
+        Logger::instance().print("Could not map file: " + filepath, Logger::Mode::ERROR);
+        mSize = 0;
+        return;
+    }
+
+    // Files are mostly read front to back
+    madvise(pMapping, mSize, MADV_SEQUENTIAL);
+    mpData = (const char*)pMapping;
+}
+
+MappedFile::~MappedFile()
+{
+    if(mpData != NULL)
+    {
+        munmap((void*)mpData, mSize);
+    }
+}
@@ -0,0 +1,64 @@
+//============================================================================
+// Distributed under the MIT License. Author: Raphael Menges
+//============================================================================
+
+// Memory mapping of a complete file. Either read only or copy on write, where
+// changes stay in memory and are never written back to the file.
+
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <string>
+#include <cstddef>
+
+class MappedFile
+{
+public:
+
+    // Constructor, maps file. Check isOpen afterwards
+    MappedFile(std::string filepath, bool copyOnWrite = false);
+
+    // Destructor, unmaps file
+    virtual ~MappedFile();
+
+    // Get whether file could be mapped
+    bool isOpen() const { return mpData != NULL; }
+
+    // Get pointer to first byte of file
+    const char* getData() const { return mpData; }
+
+    // Get pointer to first byte of file for writing. Only available for copy on write mapping
+    char* getWritableData() { return mCopyOnWrite ? (char*)mpData : NULL; }
+
+    // Get size of file in bytes
+    size_t getSize() const { return mSize; }
+
+    // Get path of mapped file
+    std::string getFilepath() const { return mFilepath; }
+
+    // Get time of last modification of file in seconds since epoch
+    long long getModificationTime() const { return mModificationTime; }
+
+private:
+
+    // No copies of mapping
+    MappedFile(const MappedFile&);
+    MappedFile& operator=(const MappedFile&);
+
+    // Path of file
+    std::string mFilepath;
+
+    // Mapped memory
+    const char* mpData = NULL;
+
+    // Size of mapped memory
+    size_t mSize = 0;
+
+    // Time of last modification
+    long long mModificationTime = 0;
+
+    // Whether mapping is writable copy of file
+    bool mCopyOnWrite = false;
+};
+
+#endif // MAPPED_FILE_H
@@ -0,0 +1,307 @@
+//============================================================================
+// Distributed under the MIT License. Author: Raphael Menges
+//============================================================================
+
+#include "PDBReader.h"
+#include "FixedColumns.h"
+#include "ElementCache.h"
+#include "Utils/Logger.h"
+#include <unordered_map>
+#include <algorithm>
+#include <cstring>
+#include <cstdlib>
+#include <cctype>
+#include <iterator>
+
+// Bytes of a usual line, used to estimate count of atoms
+const size_t usualLineLength = 81;
+
+// Record name of line, padded with spaces to six characters
+static void readRecord(const char* pLine, size_t length, char pRecord[7])
+{
+    for(size_t i = 0; i < 6; i++)
+    {
+        pRecord[i] = i < length ? pLine[i] : ' ';
+    }
+    pRecord[6] = '\0';
+}
+
+// Upper case element symbol of atom, either from element columns or guessed from atom name columns
+static void readElementSymbol(const char* pLine, size_t length, std::string& rSymbol)
+{
+    const char* pBegin;
+    const char* pEnd;
+    FixedColumns::readField(pLine, length, 77, 78, pBegin, pEnd);
+
+    // Guess from atom name, where two letter elements start at column 13 and single letter ones at column 14
+    if(pBegin == pEnd)
+    {
+        FixedColumns::readField(pLine, length, 13, 14, pBegin, pEnd);
+        while(pBegin < pEnd && std::isdigit((unsigned char)*pBegin)) { pBegin++; }
+        bool singleLetter = length > 12 && (std::isspace((unsigned char)pLine[12]) || std::isdigit((unsigned char)pLine[12]));
+
+        // Names filling all four columns, like HG12 or HD21, are hydrogens by convention
+        singleLetter = singleLetter || (length > 15 && std::toupper((unsigned char)pLine[12]) == 'H'
+            && !std::isspace((unsigned char)pLine[13]) && !std::isspace((unsigned char)pLine[14]) && !std::isspace((unsigned char)pLine[15]));
+        if(singleLetter)
+        {
+            pEnd = std::min(pEnd, pBegin + 1);
+        }
+    }
+
+    // Take up to two letters
+    rSymbol.clear();
+    for(const char* pChar = pBegin; pChar < pEnd && pChar < pBegin + 2; pChar++)
+    {
+        if(!std::isalpha((unsigned char)*pChar)) { break; }
+        rSymbol.push_back((char)std::toupper((unsigned char)*pChar));
+    }
+}
+
+PDBReader::PDBReader(std::string filepath)
+{
+    mupFile = std::unique_ptr<MappedFile>(new MappedFile(filepath));
+}
+
+PDBReader::~PDBReader()
+{
+    // Nothing to do
+}
+
+bool PDBReader::read(
+    std::vector<std::string>& rNames,
+    std::vector<std::string>& rElementNames,
+    std::vector<std::string>& rResidueNames,
+    std::vector<int>& rIndices,
+    std::vector<std::string>& rBonds,
+    std::vector<std::string>& rDistinctResidueNames,
+    Trajectory& rTrajectory,
+    std::vector<float>& rRadii,
+    int& rAtomCount,
+    const LoadOptions& rOptions,
+    std::vector<int>* pAtomIndices) const
+{
+    if(!isOpen()) { return false; }
+    const char* pData = mupFile->getData();
+    const char* pDataEnd = pData + mupFile->getSize();
+
+    // Reserve memory with estimated count of atoms
+    size_t estimatedAtomCount = mupFile->getSize() / usualLineLength;
+    std::vector<std::string> names;
+    std::vector<std::string> distinctResidueNames;
+    std::vector<std::string> elementNames;
+    std::vector<std::string> residueNames;
+    std::vector<glm::vec3> positions;
+    std::vector<float> radii;
+    std::vector<int> atomIndices;
+    names.reserve(estimatedAtomCount);
+    distinctResidueNames.reserve(estimatedAtomCount);
+    elementNames.reserve(estimatedAtomCount);
+    positions.reserve(estimatedAtomCount);
+    radii.reserve(estimatedAtomCount);
+
+    // Map from serial number of atom to its index, used by CONECT records
+    std::unordered_map<int, int> serialToIndex;
+    serialToIndex.reserve(estimatedAtomCount);
+
+    // Pairs of bonded atom indices, lower index first
+    std::vector<std::pair<int, int> > bondPairs;
+
+    // Element name and radius per element symbol
+    ElementCache elementCache;
+    std::string symbol;
+
+    // Columns 18 to 27 identify residue (name, chain, sequence number and insertion code)
+    char pResidueKey[10];
+    char pPreviousResidueKey[10];
+    bool firstAtom = true;
+    bool modelDone = false;
+    std::string distinctResidueName;
+
+    // Positions of further models, one block after the other, and count of atoms in current model
+    std::vector<glm::vec3> modelPositions;
+    size_t modelAtomCount = 0;
+    int modelCount = 0;
+    bool modelsFit = true;
+
+    // Index of next atom within file, including skipped ones
+    int fileAtomIndex = 0;
+
+    // Go over lines
+    char pRecord[7];
+    const char* pLine = pData;
+    while(pLine < pDataEnd)
+    {
+        // Find end of line
+        const char* pLineEnd = (const char*)std::memchr(pLine, '\n', pDataEnd - pLine);
+        if(pLineEnd == NULL) { pLineEnd = pDataEnd; }
+        size_t length = pLineEnd - pLine;
+        if(length > 0 && pLine[length - 1] == '\r') { length--; }
+        readRecord(pLine, length, pRecord);
+
+        if(!modelDone && (std::memcmp(pRecord, "ATOM  ", 6) == 0 || std::memcmp(pRecord, "HETATM", 6) == 0))
+        {
+            int index = (int)names.size();
+            const char* pBegin;
+            const char* pEnd;
+
+            // Skip atoms of removed residues, like water and ions
+            if(!rOptions.keepsAllAtoms())
+            {
+                FixedColumns::readField(pLine, length, 18, 20, pBegin, pEnd);
+                if(!rOptions.keepsResidue(std::string(pBegin, pEnd)))
+                {
+                    fileAtomIndex++;
+                    pLine = pLineEnd + 1;
+                    continue;
+                }
+            }
+            atomIndices.push_back(fileAtomIndex++);
+
+            // Serial number of atom, counted up if not readable
+            int serial;
+            if(!FixedColumns::parseInt(pLine, length, 7, 11, serial)) { serial = fileAtomIndex; }
+            serialToIndex[serial] = index;
+
+            // Name of atom
+            FixedColumns::readField(pLine, length, 13, 16, pBegin, pEnd);
+            names.push_back(std::string(pBegin, pEnd));
+
+            // Residue, new one starts when any of its columns changes
+            for(size_t i = 0; i < 10; i++)
+            {
+                pResidueKey[i] = 17 + i < length ? pLine[17 + i] : ' ';
+            }
+            if(firstAtom || std::memcmp(pResidueKey, pPreviousResidueKey, 10) != 0)
+            {
+                std::memcpy(pPreviousResidueKey, pResidueKey, 10);
+                FixedColumns::readField(pLine, length, 18, 20, pBegin, pEnd);
+                residueNames.push_back(std::string(pBegin, pEnd));
+                int sequenceNumber;
+                if(!FixedColumns::parseInt(pLine, length, 23, 26, sequenceNumber)) { sequenceNumber = (int)residueNames.size(); }
+                distinctResidueName = residueNames.back() + std::to_string(sequenceNumber);
+                firstAtom = false;
+            }
+            distinctResidueNames.push_back(distinctResidueName);
+
+            // Position
+            positions.push_back(glm::vec3(
+                FixedColumns::parseFloat(pLine, length, 31, 38),
+                FixedColumns::parseFloat(pLine, length, 39, 46),
+                FixedColumns::parseFloat(pLine, length, 47, 54)));
+
+            // Element and radius
+            readElementSymbol(pLine, length, symbol);
+            const std::pair<std::string, float>& rElement = elementCache.resolve(symbol);
+            elementNames.push_back(rElement.first);
+            radii.push_back(rElement.second);
+        }
+        else if(modelDone && rOptions.readAllModels && modelsFit
+            && (std::memcmp(pRecord, "ATOM  ", 6) == 0 || std::memcmp(pRecord, "HETATM", 6) == 0))
+        {
+            // Further models only provide positions of the same atoms
+            if(!rOptions.keepsAllAtoms())
+            {
+                const char* pBegin;
+                const char* pEnd;
+                FixedColumns::readField(pLine, length, 18, 20, pBegin, pEnd);
+                if(!rOptions.keepsResidue(std::string(pBegin, pEnd)))
+                {
+                    pLine = pLineEnd + 1;
+                    continue;
+                }
+            }
+            modelAtomCount++;
+            modelPositions.push_back(glm::vec3(
+                FixedColumns::parseFloat(pLine, length, 31, 38),
+                FixedColumns::parseFloat(pLine, length, 39, 46),
+                FixedColumns::parseFloat(pLine, length, 47, 54)));
+        }
+        else if(std::memcmp(pRecord, "ENDMDL", 6) == 0)
+        {
+            // Topology is taken from first model, further ones must have same count of atoms
+            if(modelDone && modelAtomCount > 0)
+            {
+                modelsFit = modelsFit && modelAtomCount == names.size();
+                modelCount++;
+            }
+            modelDone = true;
+            modelAtomCount = 0;
+        }
+        else if(std::memcmp(pRecord, "CONECT", 6) == 0)
+        {
+            // Atom and up to four bonded atoms
+            int serial;
+            if(FixedColumns::parseInt(pLine, length, 7, 11, serial))
+            {
+                auto atomIt = serialToIndex.find(serial);
+                for(size_t column = 12; atomIt != serialToIndex.end() && column <= 27; column += 5)
+                {
+                    int bondedSerial;
+                    if(!FixedColumns::parseInt(pLine, length, column, column + 4, bondedSerial)) { continue; }
+                    auto bondedIt = serialToIndex.find(bondedSerial);
+                    if(bondedIt == serialToIndex.end() || bondedIt->second == atomIt->second) { continue; }
+                    bondPairs.push_back(std::make_pair(
+                        std::min(atomIt->second, bondedIt->second),
+                        std::max(atomIt->second, bondedIt->second)));
+                }
+            }
+        }
+        else if(std::memcmp(pRecord, "END   ", 6) == 0)
+        {
+            break;
+        }
+
+        pLine = pLineEnd + 1;
+    }
+
+    if(names.empty())
+    {
+        Logger::instance().print("No atoms found in PDB file: " + mupFile->getFilepath(), Logger::Mode::ERROR);
+        return false;
+    }
+
+    // Frame is appended to trajectory
+    if(!rTrajectory.setAtomCount((int)names.size()))
+    {
+        Logger::instance().print("Count of atoms does not fit to trajectory: " + mupFile->getFilepath(), Logger::Mode::ERROR);
+        return false;
+    }
+
+    // Last model may miss its ENDMDL record
+    if(modelAtomCount > 0)
+    {
+        modelsFit = modelsFit && modelAtomCount == names.size();
+        modelCount++;
+    }
+    if(!modelsFit)
+    {
+        Logger::instance().print("Models of PDB file differ in their atoms, only first one is loaded: " + mupFile->getFilepath(), Logger::Mode::WARNING);
+        modelCount = 0;
+    }
+
+    // Bonds are listed in both directions by CONECT records
+    std::sort(bondPairs.begin(), bondPairs.end());
+    bondPairs.erase(std::unique(bondPairs.begin(), bondPairs.end()), bondPairs.end());
+    rBonds.reserve(rBonds.size() + bondPairs.size());
+    for(const auto& rPair : bondPairs)
+    {
+        rBonds.push_back(
+            "(" + distinctResidueNames.at(rPair.first) + "-" + names.at(rPair.first) + ", "
+            + distinctResidueNames.at(rPair.second) + "-" + names.at(rPair.second) + ")");
+    }
+
+    // Fill output
+    glm::vec3* pFrames = rTrajectory.addFrames(1 + modelCount);
+    pFrames = std::copy(positions.begin(), positions.end(), pFrames);
+    if(modelCount > 0) { std::copy(modelPositions.begin(), modelPositions.end(), pFrames); }
+    rAtomCount = (int)names.size();
+    for(int i = 0; i < rAtomCount; i++) { rIndices.push_back(i + 1); }
+    rNames.insert(rNames.end(), std::make_move_iterator(names.begin()), std::make_move_iterator(names.end()));
+    rElementNames.insert(rElementNames.end(), std::make_move_iterator(elementNames.begin()), std::make_move_iterator(elementNames.end()));
+    rResidueNames.insert(rResidueNames.end(), std::make_move_iterator(residueNames.begin()), std::make_move_iterator(residueNames.end()));
+    rDistinctResidueNames.insert(rDistinctResidueNames.end(), std::make_move_iterator(distinctResidueNames.begin()), std::make_move_iterator(distinctResidueNames.end()));
+    rRadii.insert(rRadii.end(), radii.begin(), radii.end());
+    if(pAtomIndices != NULL) { *pAtomIndices = atomIndices; }
+    return true;
+}
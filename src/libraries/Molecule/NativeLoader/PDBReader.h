@@ -0,0 +1,56 @@
+//============================================================================
+// Distributed under the MIT License. Author: Raphael Menges
+//============================================================================
+
+// Native reader of PDB files. File is memory mapped and ATOM, HETATM and CONECT
+// records are parsed by their fixed columns without copying lines.
+
+#ifndef PDB_READER_H
+#define PDB_READER_H
+
+#include "Molecule/NativeLoader/MappedFile.h"
+#include "Molecule/NativeLoader/LoadOptions.h"
+#include "Molecule/MDtrajLoader/Data/Trajectory.h"
+#include <glm/glm.hpp>
+#include <vector>
+#include <string>
+#include <memory>
+
+class PDBReader
+{
+public:
+
+    // Constructor, maps file. Check isOpen afterwards
+    PDBReader(std::string filepath);
+
+    // Destructor
+    virtual ~PDBReader();
+
+    // Get whether file could be opened
+    bool isOpen() const { return mupFile->isOpen(); }
+
+    // Parse atoms of first model into the structures consumed by Protein. Positions of the model and, if options read
+    // all models, of each further model with the same atoms are appended as frames to the trajectory, which must be
+    // empty or fit in atom count. Bonds are taken from CONECT records and formatted
+    // like "(MET1-N, MET1-CA)". Atoms of residues removed by options are skipped, indices of kept atoms within the
+    // file are optionally filled in, so trajectories can select the same atoms. Returns false if no atom was found
+    bool read(
+        std::vector<std::string>& rNames,
+        std::vector<std::string>& rElementNames,
+        std::vector<std::string>& rResidueNames,
+        std::vector<int>& rIndices,
+        std::vector<std::string>& rBonds,
+        std::vector<std::string>& rDistinctResidueNames,
+        Trajectory& rTrajectory,
+        std::vector<float>& rRadii,
+        int& rAtomCount,
+        const LoadOptions& rOptions = LoadOptions(),
+        std::vector<int>* pAtomIndices = NULL) const;
+
+private:
+
+    // Memory mapped file
+    std::unique_ptr<MappedFile> mupFile;
+};
+
+#endif // PDB_READER_H
@@ -0,0 +1,355 @@
+//============================================================================
+// Distributed under the MIT License. Author: Raphael Menges
+//============================================================================
+
+#include "ProteinSnapshot.h"
+#include "Molecule/NativeLoader/MappedFile.h"
+#include "Utils/Logger.h"
+#include <sys/stat.h>
+#include <fstream>
+#include <cstring>
+#include <cstdio>
+
+const std::string ProteinSnapshot::extension = ".snapshot";
+
+// Identification of format. Snapshots are written in native byte order, mark detects other machines
+const char snapshotMagic[8] = { 'O', 'G', 'F', 'S', 'N', 'A', 'P', '\0' };
+const uint32_t byteOrderMark = 0x01020304;
+
+// Sections are aligned like buffer of trajectory, so trajectory is used in place
+const uint64_t sectionAlignment = Trajectory::alignment;
+
+// Sections of snapshot
+enum Section
+{
+    NAME, // characters of protein name
+    STRING_OFFSETS, // offset of each string in characters, one more entry than strings
+    STRINGS, // characters of all strings
+    ATOM_TABLE, // atom records
+    RESIDUE_RANGES, // residue ranges
+    DIFF_AMINOS, // string ids of distinct amino acids
+    BOND_OFFSETS, // offsets into bond partners, one more entry than atoms
+    BOND_PARTNERS, // indices of bonded atoms
+    RADII, // radius of each atom
+    SOURCE_ATOM_INDICES, // index of each atom in source files, may be empty
+    TRAJECTORY, // positions of all atoms in all frames
+    SECTION_COUNT
+};
+
+// Position of section in file
+struct SectionEntry
+{
+    uint64_t offset;
+    uint64_t size;
+};
+
+// Header at start of file
+struct Header
+{
+    char pMagic[8];
+    uint32_t version;
+    uint32_t byteOrderMark;
+    uint64_t fileSize;
+    uint64_t sourceKey;
+    int32_t atomCount;
+    int32_t frameCount;
+    int32_t stringCount;
+    int32_t padding;
+    SectionEntry pSections[SECTION_COUNT];
+};
+
+static_assert(sizeof(Protein::AtomRecord) == 5 * sizeof(int32_t), "Atom records must be packed");
+static_assert(sizeof(Protein::ResidueRange) == 3 * sizeof(int32_t), "Residue ranges must be packed");
+
+// Copy section into vector. Fails if section is not within file or does not hold whole elements
+template<typename T>
+static bool readSection(const char* pData, const Header& rHeader, Section section, std::vector<T>& rValues)
+{
+    const SectionEntry& rSection = rHeader.pSections[section];
+    if(rSection.offset < sizeof(Header)
+        || rSection.offset > rHeader.fileSize
+        || rSection.size > rHeader.fileSize - rSection.offset
+        || rSection.size % sizeof(T) != 0)
+    {
+        return false;
+    }
+    rValues.resize(rSection.size / sizeof(T));
+    if(!rValues.empty()) { std::memcpy(rValues.data(), pData + rSection.offset, rSection.size); }
+    return true;
+}
+
+bool ProteinSnapshot::write(
+    std::string filepath,
+    Protein* pProtein,
+    const std::vector<int>& rSourceAtomIndices,
+    uint64_t sourceKey)
+{
+    const std::vector<Protein::AtomRecord>& rAtomTable = *pProtein->getAtomTable();
+    std::shared_ptr<const Trajectory> spTrajectory = pProtein->getTrajectory();
+    int atomCount = (int)rAtomTable.size();
+    if(spTrajectory->getFrameCount() > 0 && spTrajectory->getAtomCount() != atomCount)
+    {
+        Logger::instance().print("Trajectory does not fit to protein, snapshot not written: " + filepath, Logger::Mode::ERROR);
+        return false;
+    }
+
+    // Strings of protein keep their ids, names of amino acids are added if missing
+    StringTable strings;
+    std::shared_ptr<const StringTable> spProteinStrings = pProtein->getStrings();
+    for(int i = 0; i < spProteinStrings->size(); i++) { strings.intern(spProteinStrings->get((StringTable::Id)i)); }
+    std::vector<StringTable::Id> diffAminos;
+    for(const std::string& rAmino : *pProtein->getDiffAminos()) { diffAminos.push_back(strings.intern(rAmino)); }
+    std::vector<uint64_t> stringOffsets(1, 0);
+    std::string stringData;
+    for(int i = 0; i < strings.size(); i++)
+    {
+        stringData += strings.get((StringTable::Id)i);
+        stringOffsets.push_back(stringData.size());
+    }
+
+    // Data of sections
+    std::string name = pProtein->getName();
+    std::vector<float> radii = pProtein->getRadii();
+    std::vector<int32_t> sourceAtomIndices(rSourceAtomIndices.begin(), rSourceAtomIndices.end());
+    const std::vector<int>& rBondOffsets = *pProtein->getBondOffsets();
+    const std::vector<int>& rBondPartners = *pProtein->getBondPartners();
+    const void* pSectionData[SECTION_COUNT] =
+    {
+        name.data(),
+        stringOffsets.data(),
+        stringData.data(),
+        rAtomTable.data(),
+        pProtein->getResidueRanges()->data(),
+        diffAminos.data(),
+        rBondOffsets.data(),
+        rBondPartners.data(),
+        radii.data(),
+        sourceAtomIndices.data(),
+        spTrajectory->getData()
+    };
+    uint64_t pSectionSizes[SECTION_COUNT] =
+    {
+        name.size(),
+        stringOffsets.size() * sizeof(uint64_t),
+        stringData.size(),
+        rAtomTable.size() * sizeof(Protein::AtomRecord),
+        pProtein->getResidueRanges()->size() * sizeof(Protein::ResidueRange),
+        diffAminos.size() * sizeof(StringTable::Id),
+        rBondOffsets.size() * sizeof(int),
+        rBondPartners.size() * sizeof(int),
+        radii.size() * sizeof(float),
+        sourceAtomIndices.size() * sizeof(int32_t),
+        spTrajectory->getSize() * sizeof(glm::vec3)
+    };
+
+    // Header with sections placed one after another
+    Header header = Header();
+    std::memcpy(header.pMagic, snapshotMagic, sizeof(header.pMagic));
+    header.version = version;
+    header.byteOrderMark = byteOrderMark;
+    header.sourceKey = sourceKey;
+    header.atomCount = atomCount;
+    header.frameCount = spTrajectory->getFrameCount();
+    header.stringCount = strings.size();
+    uint64_t offset = sizeof(Header);
+    for(int i = 0; i < SECTION_COUNT; i++)
+    {
+        offset = (offset + sectionAlignment - 1) / sectionAlignment * sectionAlignment;
+        header.pSections[i].offset = offset;
+        header.pSections[i].size = pSectionSizes[i];
+        offset += pSectionSizes[i];
+    }
+    header.fileSize = offset;
+
+    // Write temporary file, which replaces snapshot when complete
+    std::string temporaryFilepath = filepath + ".tmp";
+    {
+        std::ofstream out(temporaryFilepath, std::ios::binary | std::ios::trunc);
+        out.write((const char*)&header, sizeof(Header));
+        uint64_t position = sizeof(Header);
+        const char pPadding[sectionAlignment] = {};
+        for(int i = 0; i < SECTION_COUNT && out; i++)
+        {
+            out.write(pPadding, header.pSections[i].offset - position);
+            out.write((const char*)pSectionData[i], pSectionSizes[i]);
+            position = header.pSections[i].offset + pSectionSizes[i];
+        }
+        out.close();
+        if(!out)
+        {
+            Logger::instance().print("Could not write snapshot: " + filepath, Logger::Mode::ERROR);
+            std::remove(temporaryFilepath.c_str());
+            return false;
+        }
+    }
+    if(std::rename(temporaryFilepath.c_str(), filepath.c_str()) != 0)
+    {
+        Logger::instance().print("Could not write snapshot: " + filepath, Logger::Mode::ERROR);
+        std::remove(temporaryFilepath.c_str());
+        return false;
+    }
+    return true;
+}
+
+std::unique_ptr<Protein> ProteinSnapshot::read(
+    std::string filepath,
+    uint64_t sourceKey,
+    std::vector<int>* pSourceAtomIndices)
+{
+    // Missing snapshot is no error, caller falls back to source files
+    struct stat fileStatus;
+    if(stat(filepath.c_str(), &fileStatus) != 0) { return std::unique_ptr<Protein>(); }
+
+    // Map file as copy on write, so the trajectory can be changed in memory like any other
+    std::shared_ptr<MappedFile> spFile(new MappedFile(filepath, true));
+    if(!spFile->isOpen()) { return std::unique_ptr<Protein>(); }
+    char* pData = spFile->getWritableData();
+
+    // Check header
+    Header header;
+    if(spFile->getSize() < sizeof(Header)) { return std::unique_ptr<Protein>(); }
+    std::memcpy(&header, pData, sizeof(Header));
+    if(std::memcmp(header.pMagic, snapshotMagic, sizeof(header.pMagic)) != 0
+        || header.version != version
+        || header.byteOrderMark != byteOrderMark
+        || header.fileSize != (uint64_t)spFile->getSize()
+        || header.atomCount <= 0
+        || header.frameCount < 0
+        || header.stringCount < 0)
+    {
+        Logger::instance().print("Snapshot is invalid or of other version: " + filepath, Logger::Mode::WARNING);
+        return std::unique_ptr<Protein>();
+    }
+
+    // Outdated cache is silently ignored
+    if(sourceKey != 0 && header.sourceKey != sourceKey) { return std::unique_ptr<Protein>(); }
+
+    // Copy compact topology, it is small compared to trajectory
+    std::string name;
+    std::vector<uint64_t> stringOffsets;
+    std::vector<char> stringData;
+    std::vector<Protein::AtomRecord> atomTable;
+    std::vector<Protein::ResidueRange> residueRanges;
+    std::vector<StringTable::Id> diffAminoIds;
+    std::vector<int> bondOffsets;
+    std::vector<int> bondPartners;
+    std::vector<float> radii;
+    std::vector<int32_t> sourceAtomIndices;
+    std::vector<char> nameData;
+    bool valid =
+        readSection(pData, header, NAME, nameData)
+        && readSection(pData, header, STRING_OFFSETS, stringOffsets)
+        && readSection(pData, header, STRINGS, stringData)
+        && readSection(pData, header, ATOM_TABLE, atomTable)
+        && readSection(pData, header, RESIDUE_RANGES, residueRanges)
+        && readSection(pData, header, DIFF_AMINOS, diffAminoIds)
+        && readSection(pData, header, BOND_OFFSETS, bondOffsets)
+        && readSection(pData, header, BOND_PARTNERS, bondPartners)
+        && readSection(pData, header, RADII, radii)
+        && readSection(pData, header, SOURCE_ATOM_INDICES, sourceAtomIndices);
+
+    // Sizes must fit to each other
+    int atomCount = header.atomCount;
+    uint32_t stringCount = (uint32_t)header.stringCount;
+    const SectionEntry& rTrajectorySection = header.pSections[TRAJECTORY];
+    valid = valid
+        && stringOffsets.size() == stringCount + 1
+        && stringOffsets.back() == stringData.size()
+        && (int)atomTable.size() == atomCount
+        && (int)bondOffsets.size() == atomCount + 1
+        && (int)radii.size() == atomCount
+        && (sourceAtomIndices.empty() || (int)sourceAtomIndices.size() == atomCount)
+        && rTrajectorySection.offset % sectionAlignment == 0
+        && rTrajectorySection.offset <= header.fileSize
+        && rTrajectorySection.size <= header.fileSize - rTrajectorySection.offset
+        && rTrajectorySection.size == (uint64_t)header.frameCount * (uint64_t)atomCount * sizeof(glm::vec3);
+
+    // References must be within their targets
+    for(uint32_t i = 0; valid && i < stringCount; i++) { valid = stringOffsets[i] <= stringOffsets[i + 1]; }
+    for(int i = 0; valid && i < atomCount; i++)
+    {
+        const Protein::AtomRecord& rRecord = atomTable[i];
+        valid = rRecord.name < stringCount && rRecord.element < stringCount
+            && rRecord.amino < stringCount && rRecord.distinctResidue < stringCount;
+    }
+    int nextAtom = 0;
+    for(size_t i = 0; valid && i < residueRanges.size(); i++)
+    {
+        const Protein::ResidueRange& rRange = residueRanges[i];
+        valid = rRange.firstAtom == nextAtom && rRange.atomCount > 0 && rRange.distinctResidue < stringCount;
+        nextAtom += rRange.atomCount;
+    }
+    valid = valid && nextAtom == atomCount && bondOffsets.front() == 0 && bondOffsets.back() == (int)bondPartners.size();
+    for(int i = 0; valid && i < atomCount; i++) { valid = bondOffsets[i] <= bondOffsets[i + 1]; }
+    for(size_t i = 0; valid && i < bondPartners.size(); i++) { valid = bondPartners[i] >= 0 && bondPartners[i] < atomCount; }
+    for(size_t i = 0; valid && i < diffAminoIds.size(); i++) { valid = diffAminoIds[i] < stringCount; }
+    if(!valid)
+    {
+        Logger::instance().print("Snapshot is corrupt: " + filepath, Logger::Mode::WARNING);
+        return std::unique_ptr<Protein>();
+    }
+
+    // Strings get same ids again, since they are distinct
+    std::shared_ptr<StringTable> spStrings(new StringTable);
+    for(uint32_t i = 0; i < stringCount; i++)
+    {
+        spStrings->intern(std::string(stringData.data() + stringOffsets[i], stringData.data() + stringOffsets[i + 1]));
+    }
+    if((uint32_t)spStrings->size() != stringCount)
+    {
+        Logger::instance().print("Snapshot is corrupt: " + filepath, Logger::Mode::WARNING);
+        return std::unique_ptr<Protein>();
+    }
+    std::vector<std::string> diffAminos;
+    for(StringTable::Id id : diffAminoIds) { diffAminos.push_back(spStrings->get(id)); }
+    name.assign(nameData.begin(), nameData.end());
+
+    // Trajectory uses mapped memory, which is kept alive by it
+    std::shared_ptr<Trajectory> spTrajectory(new Trajectory(atomCount));
+    if(header.frameCount > 0)
+    {
+        spTrajectory->wrap((float*)(pData + rTrajectorySection.offset), atomCount, header.frameCount, spFile);
+    }
+
+    // Create protein
+    if(pSourceAtomIndices != NULL) { pSourceAtomIndices->assign(sourceAtomIndices.begin(), sourceAtomIndices.end()); }
+    return std::unique_ptr<Protein>(new Protein(
+        spStrings, atomTable, residueRanges, diffAminos, bondOffsets, bondPartners, spTrajectory, name, radii));
+}
+
+uint64_t ProteinSnapshot::computeSourceKey(const std::vector<std::string>& rSourceFilepaths, const LoadOptions& rOptions)
+{
+    // Describe sources and options
+    std::string description = "v" + std::to_string(version);
+    for(const std::string& rFilepath : rSourceFilepaths)
+    {
+        struct stat fileStatus;
+        description += "|" + rFilepath;
+        if(stat(rFilepath.c_str(), &fileStatus) == 0)
+        {
+            description += ":" + std::to_string((long long)fileStatus.st_size) + ":" + std::to_string((long long)fileStatus.st_mtime);
+        }
+    }
+    description += "|" + std::to_string(rOptions.startFrame)
+        + ":" + std::to_string(rOptions.stopFrame)
+        + ":" + std::to_string(rOptions.frameStride)
+        + ":" + std::to_string(rOptions.stripWater)
+        + ":" + std::to_string(rOptions.stripIons)
+        + ":" + std::to_string(rOptions.readAllModels);
+    for(const std::string& rName : rOptions.strippedResidueNames) { description += ":" + rName; }
+
+    // FNV-1a hash of description, never zero
+    uint64_t key = 14695981039346656037ull;
+    for(char c : description)
+    {
+        key ^= (unsigned char)c;
+        key *= 1099511628211ull;
+    }
+    return key != 0 ? key : 1;
+}
+
+bool ProteinSnapshot::isSnapshotFilepath(std::string filepath)
+{
+    return filepath.size() >= extension.size()
+        && filepath.compare(filepath.size() - extension.size(), extension.size(), extension) == 0;
+}
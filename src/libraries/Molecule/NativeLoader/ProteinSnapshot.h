@@ -0,0 +1,57 @@
+//============================================================================
+// Distributed under the MIT License. Author: Raphael Menges
+//============================================================================
+
+// Versioned binary snapshot of a loaded protein. Holds the compact topology with
+// string table, atom table, residue ranges and bond graph, the radii and the
+// contiguous trajectory, each in its own aligned section. Reading maps the file
+// and takes the sections over without any parsing, the trajectory even without
+// copying it. Snapshots can be opened directly or serve as cache of the files a
+// protein was loaded from, identified by a key of those files and load options.
+
+#ifndef PROTEIN_SNAPSHOT_H
+#define PROTEIN_SNAPSHOT_H
+
+#include "Molecule/NativeLoader/LoadOptions.h"
+#include "Molecule/MDtrajLoader/Data/Protein.h"
+#include <vector>
+#include <string>
+#include <memory>
+#include <cstdint>
+
+class ProteinSnapshot
+{
+public:
+
+    // Version of format, snapshots of other versions are not read
+    static const uint32_t version = 1;
+
+    // Extension of snapshot files
+    static const std::string extension;
+
+    // Write protein with all frames of its trajectory. Indices of atoms in source files are stored for streamed
+    // trajectories, source key identifies what the protein was loaded from. Returns false on failure
+    static bool write(
+        std::string filepath,
+        Protein* pProtein,
+        const std::vector<int>& rSourceAtomIndices = std::vector<int>(),
+        uint64_t sourceKey = 0);
+
+    // Read protein, trajectory uses the mapped file. Fails if source key is not zero and differs from stored one.
+    // Optionally fills indices of atoms in source files. Returns empty pointer on failure
+    static std::unique_ptr<Protein> read(
+        std::string filepath,
+        uint64_t sourceKey = 0,
+        std::vector<int>* pSourceAtomIndices = NULL);
+
+    // Compute key of source files, including their size and time of modification, and of load options
+    static uint64_t computeSourceKey(const std::vector<std::string>& rSourceFilepaths, const LoadOptions& rOptions);
+
+    // Get whether path has snapshot extension
+    static bool isSnapshotFilepath(std::string filepath);
+
+    // Get path of snapshot which caches protein loaded from source file
+    static std::string getCacheFilepath(std::string sourceFilepath) { return sourceFilepath + extension; }
+};
+
+#endif // PROTEIN_SNAPSHOT_H
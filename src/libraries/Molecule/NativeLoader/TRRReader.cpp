@@ -0,0 +1,150 @@
+//============================================================================
+// Distributed under the MIT License. Author: Raphael Menges
+//============================================================================
+
+#include "TRRReader.h"
+#include "Utils/Logger.h"
+#include <cstring>
+
+// Layout follows the trnio of GROMACS (do_trr_frame_header). Values are stored big endian
+
+// Magic number at start of each frame
+const int trrMagic = 1993;
+
+// Count of integers with sizes of blocks, atom count, step and energy count
+const int headerIntCount = 13;
+
+// Indices of integers in header
+const int boxSizeIndex = 2;
+const int virialSizeIndex = 3;
+const int pressureSizeIndex = 4;
+const int positionSizeIndex = 7;
+const int velocitySizeIndex = 8;
+const int forceSizeIndex = 9;
+const int atomCountIndex = 10;
+
+// Conversion from nanometer to angstrom
+const float nanometerToAngstrom = 10.f;
+
+// Read big endian integer
+static unsigned int readUnsigned(const char* pData)
+{
+    const unsigned char* pBytes = (const unsigned char*)pData;
+    return ((unsigned int)pBytes[0] << 24) | ((unsigned int)pBytes[1] << 16) | ((unsigned int)pBytes[2] << 8) | (unsigned int)pBytes[3];
+}
+
+static int readInt(const char* pData)
+{
+    return (int)readUnsigned(pData);
+}
+
+// Read big endian floating point numbers
+static float readFloat(const char* pData)
+{
+    unsigned int bits = readUnsigned(pData);
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+static double readDouble(const char* pData)
+{
+    unsigned long long bits = ((unsigned long long)readUnsigned(pData) << 32) | (unsigned long long)readUnsigned(pData + 4);
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+TRRReader::TRRReader(std::string filepath)
+{
+    mupFile = std::unique_ptr<MappedFile>(new MappedFile(filepath));
+    if(mupFile->isOpen() && !scan())
+    {
+        Logger::instance().print("Corrupt TRR file: " + filepath, Logger::Mode::ERROR);
+    }
+}
+
+TRRReader::~TRRReader()
+{
+    // Nothing to do
+}
+
+bool TRRReader::decodeFrame(int fileFrame, glm::vec3* pPositions) const
+{
+    if(fileFrame < 0 || fileFrame >= getFileFrameCount()) { return false; }
+    const char* pData = mupFile->getData() + mPositionOffsets[fileFrame];
+    if(mDoublePrecision)
+    {
+        for(int i = 0; i < mAtomCount; i++)
+        {
+            const char* pAtom = pData + 24 * (size_t)i;
+            pPositions[i] = glm::vec3(readDouble(pAtom), readDouble(pAtom + 8), readDouble(pAtom + 16)) * nanometerToAngstrom;
+        }
+    }
+    else
+    {
+        for(int i = 0; i < mAtomCount; i++)
+        {
+            const char* pAtom = pData + 12 * (size_t)i;
+            pPositions[i] = glm::vec3(readFloat(pAtom), readFloat(pAtom + 4), readFloat(pAtom + 8)) * nanometerToAngstrom;
+        }
+    }
+    return true;
+}
+
+bool TRRReader::scan()
+{
+    const char* pData = mupFile->getData();
+    size_t size = mupFile->getSize();
+    size_t offset = 0;
+    while(offset < size)
+    {
+        // Magic number and version string, which is stored as its size and then as padded XDR string
+        if(offset + 12 > size || readInt(pData + offset) != trrMagic) { return false; }
+        size_t stringSize = (size_t)readUnsigned(pData + offset + 8);
+        size_t headerOffset = offset + 12 + ((stringSize + 3) & ~(size_t)3);
+        if(headerOffset + 4 * headerIntCount > size) { return false; }
+
+        // Sizes of blocks in bytes
+        int pHeader[headerIntCount];
+        for(int i = 0; i < headerIntCount; i++)
+        {
+            pHeader[i] = readInt(pData + headerOffset + 4 * i);
+            if(pHeader[i] < 0 && i < atomCountIndex) { return false; }
+        }
+        int atomCount = pHeader[atomCountIndex];
+        if(atomCount <= 0) { return false; }
+
+        // Precision is given by size of any block with known count of values
+        int realSize = 0;
+        if(pHeader[boxSizeIndex] > 0) { realSize = pHeader[boxSizeIndex] / 9; }
+        else if(pHeader[positionSizeIndex] > 0) { realSize = pHeader[positionSizeIndex] / (3 * atomCount); }
+        else if(pHeader[velocitySizeIndex] > 0) { realSize = pHeader[velocitySizeIndex] / (3 * atomCount); }
+        else if(pHeader[forceSizeIndex] > 0) { realSize = pHeader[forceSizeIndex] / (3 * atomCount); }
+        if(realSize != 4 && realSize != 8) { return false; }
+
+        // All frames must have same atoms and precision
+        if(offset == 0)
+        {
+            mAtomCount = atomCount;
+            mDoublePrecision = realSize == 8;
+        }
+        else if(atomCount != mAtomCount || (realSize == 8) != mDoublePrecision)
+        {
+            return false;
+        }
+
+        // Blocks follow time and lambda, positions after box, virial and pressure
+        size_t dataOffset = headerOffset + 4 * headerIntCount + 2 * (size_t)realSize;
+        size_t positionOffset = dataOffset + (size_t)pHeader[boxSizeIndex] + (size_t)pHeader[virialSizeIndex] + (size_t)pHeader[pressureSizeIndex];
+        size_t frameEnd = positionOffset + (size_t)pHeader[positionSizeIndex] + (size_t)pHeader[velocitySizeIndex] + (size_t)pHeader[forceSizeIndex];
+        if(frameEnd > size) { return false; }
+        if(pHeader[positionSizeIndex] > 0)
+        {
+            if(pHeader[positionSizeIndex] != 3 * atomCount * realSize) { return false; }
+            mPositionOffsets.push_back(positionOffset);
+        }
+        offset = frameEnd;
+    }
+    return !mPositionOffsets.empty();
+}
@@ -0,0 +1,58 @@
+//============================================================================
+// Distributed under the MIT License. Author: Raphael Menges
+//============================================================================
+
+// Native reader of uncompressed GROMACS TRR trajectories in single or double
+// precision. File is memory mapped and an index of frames with positions is
+// built by jumping from header to header, so frames are decoded in parallel.
+// Frames holding only velocities or forces are not part of the index.
+
+#ifndef TRR_READER_H
+#define TRR_READER_H
+
+#include "Molecule/NativeLoader/MappedFile.h"
+#include "Molecule/NativeLoader/TrajectoryFile.h"
+#include <glm/glm.hpp>
+#include <vector>
+#include <string>
+#include <memory>
+
+class TRRReader : public TrajectoryFile
+{
+public:
+
+    // Constructor, maps file and indexes its frames. Check isOpen afterwards
+    TRRReader(std::string filepath);
+
+    // Destructor
+    virtual ~TRRReader();
+
+    // Get count of atoms in each frame of file
+    virtual int getFileAtomCount() const { return mAtomCount; }
+
+    // Get count of frames with positions in file
+    virtual int getFileFrameCount() const { return (int)mPositionOffsets.size(); }
+
+    // Decode one frame of file with all its atoms into positions with space for file atom count many entries.
+    // Ignores selection. Coordinates are converted to angstrom
+    virtual bool decodeFrame(int fileFrame, glm::vec3* pPositions) const;
+
+private:
+
+    // Go over headers of frames and collect offsets of their positions
+    bool scan();
+
+    // Memory mapped file
+    std::unique_ptr<MappedFile> mupFile;
+
+    // Count of atoms in each frame
+    int mAtomCount = 0;
+
+    // Whether values are stored in double precision
+    bool mDoublePrecision = false;
+
+    // Offset of positions of each frame in bytes
+    std::vector<size_t> mPositionOffsets;
+};
+
+#endif // TRR_READER_H
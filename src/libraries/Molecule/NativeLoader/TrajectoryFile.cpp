@@ -0,0 +1,117 @@
+//============================================================================
+// Distributed under the MIT License. Author: Raphael Menges
+//============================================================================
+
+#include "TrajectoryFile.h"
+#include "XTCReader.h"
+#include "DCDReader.h"
+#include "TRRReader.h"
+#include <algorithm>
+#include <cctype>
+#include <thread>
+
+// Get extension of file in lower case
+static std::string getExtension(const std::string& rFilepath)
+{
+    size_t dot = rFilepath.find_last_of('.');
+    std::string extension = (dot == std::string::npos) ? "" : rFilepath.substr(dot + 1);
+    std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+    return extension;
+}
+
+std::unique_ptr<TrajectoryFile> TrajectoryFile::open(std::string filepath)
+{
+    // Choose reader by extension
+    std::string extension = getExtension(filepath);
+    if(extension == "xtc") { return std::unique_ptr<TrajectoryFile>(new XTCReader(filepath)); }
+    if(extension == "dcd") { return std::unique_ptr<TrajectoryFile>(new DCDReader(filepath)); }
+    if(extension == "trr") { return std::unique_ptr<TrajectoryFile>(new TRRReader(filepath)); }
+    return std::unique_ptr<TrajectoryFile>();
+}
+
+bool TrajectoryFile::isSupported(std::string filepath)
+{
+    std::string extension = getExtension(filepath);
+    return extension == "xtc" || extension == "dcd" || extension == "trr";
+}
+
+bool TrajectoryFile::select(const LoadOptions& rOptions, const std::vector<int>& rAtomIndices)
+{
+    // Indices must be within file
+    for(int index : rAtomIndices)
+    {
+        if(index < 0 || index >= getFileAtomCount()) { return false; }
+    }
+    mAtomIndices = rAtomIndices;
+
+    // Selection of frames
+    mFrameStart = glm::max(0, rOptions.startFrame);
+    mFrameStride = glm::max(1, rOptions.frameStride);
+    mFrameCount = rOptions.getFrameCount(getFileFrameCount());
+    return true;
+}
+
+bool TrajectoryFile::read(
+    int startFrame,
+    int endFrame,
+    Trajectory& rTrajectory,
+    int offset,
+    int threadCount) const
+{
+    if(startFrame < 0 || endFrame > getFrameCount() || startFrame > endFrame) { return false; }
+    if(!rTrajectory.setAtomCount(getAtomCount())) { return false; }
+
+    // Prepare storage once, so threads write into distinct frames which do not move
+    int frameCount = endFrame - startFrame;
+    if(rTrajectory.getFrameCount() < offset + frameCount) { rTrajectory.resize(offset + frameCount); }
+
+    // Decide about count of threads
+    if(threadCount <= 0) { threadCount = (int)std::thread::hardware_concurrency(); }
+    threadCount = glm::max(1, glm::min(threadCount, frameCount));
+
+    // Launch threads on ranges of frames
+    std::vector<std::thread> threads;
+    std::vector<char> successes(threadCount, 1);
+    for(int i = 0; i < threadCount; i++)
+    {
+        threads.push_back(std::thread([&, i]()
+        {
+            int minFrame = startFrame + (frameCount * i) / threadCount;
+            int maxFrame = startFrame + (frameCount * (i + 1)) / threadCount;
+            for(int frame = minFrame; frame < maxFrame; frame++)
+            {
+                if(!readFrame(frame, rTrajectory.getFrameData(offset + frame - startFrame))) { successes.at(i) = 0; }
+            }
+        }));
+    }
+
+    // Join threads
+    bool success = true;
+    for(int i = 0; i < threadCount; i++)
+    {
+        threads.at(i).join();
+        success = success && successes.at(i);
+    }
+    return success;
+}
+
+bool TrajectoryFile::readFrame(int frame, glm::vec3* pPositions) const
+{
+    if(frame < 0 || frame >= getFrameCount()) { return false; }
+    int fileFrame = getFileFrame(frame);
+    if(mAtomIndices.empty()) { return decodeFrame(fileFrame, pPositions); }
+    return decodeAtoms(fileFrame, mAtomIndices.data(), (int)mAtomIndices.size(), pPositions);
+}
+
+bool TrajectoryFile::decodeAtoms(int fileFrame, const int* pAtomIndices, int count, glm::vec3* pPositions) const
+{
+    // Decode all atoms and gather selected ones. Buffer is kept per thread, since frames are read in parallel
+    static thread_local std::vector<glm::vec3> positions;
+    positions.resize(getFileAtomCount());
+    if(!decodeFrame(fileFrame, positions.data())) { return false; }
+    for(int i = 0; i < count; i++)
+    {
+        pPositions[i] = positions[pAtomIndices[i]];
+    }
+    return true;
+}
@@ -0,0 +1,88 @@
+//============================================================================
+// Distributed under the MIT License. Author: Raphael Menges
+//============================================================================
+
+// Base of native readers of trajectory files. Readers decode single frames of
+// the file, the base adds a selection of frames and atoms and reading of many
+// frames in parallel directly into a trajectory. Files are opened by extension.
+
+#ifndef TRAJECTORY_FILE_H
+#define TRAJECTORY_FILE_H
+
+#include "Molecule/NativeLoader/TrajectoryProvider.h"
+#include "Molecule/NativeLoader/LoadOptions.h"
+#include "Molecule/MDtrajLoader/Data/Trajectory.h"
+#include <glm/glm.hpp>
+#include <vector>
+#include <string>
+#include <memory>
+
+class TrajectoryFile : public TrajectoryProvider
+{
+public:
+
+    // Destructor
+    virtual ~TrajectoryFile() {}
+
+    // Open file with reader fitting to its extension. Returns empty pointer for unknown extensions. Check isOpen
+    static std::unique_ptr<TrajectoryFile> open(std::string filepath);
+
+    // Get whether extension of file is supported
+    static bool isSupported(std::string filepath);
+
+    // Get whether file could be opened and contains at least one frame
+    bool isOpen() const { return getFileFrameCount() > 0; }
+
+    // Get count of atoms in each frame of file
+    virtual int getFileAtomCount() const = 0;
+
+    // Get count of frames in file
+    virtual int getFileFrameCount() const = 0;
+
+    // Decode one frame of file with all its atoms into positions with space for file atom count many entries.
+    // Ignores selection. Coordinates are in angstrom. Must be safe to call from multiple threads at once
+    virtual bool decodeFrame(int fileFrame, glm::vec3* pPositions) const = 0;
+
+    // Decode atoms with given indices in file of one frame of file into positions with space for count many entries.
+    // Ignores selection. Decodes complete frame and gathers atoms, readers may override it to decode only needed ones.
+    // Must be safe to call from multiple threads at once
+    virtual bool decodeAtoms(int fileFrame, const int* pAtomIndices, int count, glm::vec3* pPositions) const;
+
+    // Select frames by range and stride of options and atoms by their indices in file. Empty indices select all atoms.
+    // Afterwards, frames and atoms are counted and indexed within the selection. Returns false if indices are invalid
+    bool select(const LoadOptions& rOptions, const std::vector<int>& rAtomIndices = std::vector<int>());
+
+    // Get count of selected atoms in each frame
+    virtual int getAtomCount() const { return mAtomIndices.empty() ? getFileAtomCount() : (int)mAtomIndices.size(); }
+
+    // Get count of selected frames
+    virtual int getFrameCount() const { return mFrameCount < 0 ? getFileFrameCount() : mFrameCount; }
+
+    // Get frame of file for selected frame
+    int getFileFrame(int frame) const { return mFrameStart + frame * mFrameStride; }
+
+    // Decode selected atoms of selected frame into positions with space for atom count many entries
+    virtual bool readFrame(int frame, glm::vec3* pPositions) const;
+
+    // Decode selected frames [startFrame, endFrame[ in parallel directly into frame offset + frame - startFrame of
+    // trajectory, which is resized if too small. Trajectory must be empty or fit in count of selected atoms.
+    // Thread count of zero means hardware concurrency
+    bool read(
+        int startFrame,
+        int endFrame,
+        Trajectory& rTrajectory,
+        int offset = 0,
+        int threadCount = 0) const;
+
+private:
+
+    // Selection of frames as first frame in file, stride and count. Negative count means all frames
+    int mFrameStart = 0;
+    int mFrameStride = 1;
+    int mFrameCount = -1;
+
+    // Indices of selected atoms in file, empty when all are selected
+    std::vector<int> mAtomIndices;
+};
+
+#endif // TRAJECTORY_FILE_H
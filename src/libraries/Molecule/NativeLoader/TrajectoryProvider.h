@@ -0,0 +1,31 @@
+//============================================================================
+// Distributed under the MIT License. Author: Raphael Menges
+//============================================================================
+
+// Interface for sources of trajectory frames, so frames can be read on demand
+// instead of holding the complete trajectory in memory.
+
+#ifndef TRAJECTORY_PROVIDER_H
+#define TRAJECTORY_PROVIDER_H
+
+#include <glm/glm.hpp>
+
+class TrajectoryProvider
+{
+public:
+
+    // Destructor
+    virtual ~TrajectoryProvider() {}
+
+    // Get count of atoms in each frame
+    virtual int getAtomCount() const = 0;
+
+    // Get count of available frames
+    virtual int getFrameCount() const = 0;
+
+    // Read positions of one frame into memory with space for atom count many entries.
+    // Must be safe to call from multiple threads at once
+    virtual bool readFrame(int frame, glm::vec3* pPositions) const = 0;
+};
+
+#endif // TRAJECTORY_PROVIDER_H
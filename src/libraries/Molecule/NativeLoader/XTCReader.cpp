@@ -0,0 +1,484 @@
+//============================================================================
+// Distributed under the MIT License. Author: Raphael Menges
+//============================================================================
+
+#include "XTCReader.h"
+#include "Utils/Logger.h"
+#include <cstring>
+#include <fstream>
+
+// Decompression follows the xdrfile library of GROMACS (xdr3dfcoord)
+
+// Magic numbers at start of each frame. Newer files with 64 bit size of compressed data use 2023
+const int xtcMagic = 1995;
+const int xtcMagicLarge = 2023;
+
+// Bytes of header with magic, atom count, step, time and box until atom count of coordinates
+const size_t headerSize = 4 * 4 + 9 * 4;
+
+// Up to this count of atoms coordinates are stored uncompressed
+const int maxUncompressedAtomCount = 9;
+
+// Conversion from nanometer to angstrom
+const float nanometerToAngstrom = 10.f;
+
+// Index file with cached frame offsets. Written in native byte order, since it is only a local cache
+const char indexMagic[4] = { 'X', 'T', 'C', 'I' };
+const int indexVersion = 1;
+struct IndexHeader
+{
+    char pMagic[4];
+    int version;
+    int atomCount;
+    int padding = 0;
+    unsigned long long fileSize;
+    long long modificationTime;
+    unsigned long long frameCount;
+};
+
+// Table of integer sizes used for the small differences between atoms
+const int magicInts[] =
+{
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 8, 10, 12, 16, 20, 25, 32, 40, 50, 64,
+    80, 101, 128, 161, 203, 256, 322, 406, 512, 645, 812, 1024, 1290,
+    1625, 2048, 2580, 3250, 4096, 5060, 6501, 8192, 10321, 13003,
+    16384, 20642, 26007, 32768, 41285, 52015, 65536, 82570, 104031,
+    131072, 165140, 208063, 262144, 330280, 416127, 524287, 660561,
+    832255, 1048576, 1321122, 1664510, 2097152, 2642245, 3329021,
+    4194304, 5284491, 6658042, 8388607, 10568983, 13316085, 16777216
+};
+const int firstMagicIndex = 9;
+const int lastMagicIndex = sizeof(magicInts) / sizeof(magicInts[0]);
+
+// Read big endian integer
+static unsigned int readUnsigned(const char* pData)
+{
+    const unsigned char* pBytes = (const unsigned char*)pData;
+    return ((unsigned int)pBytes[0] << 24) | ((unsigned int)pBytes[1] << 16) | ((unsigned int)pBytes[2] << 8) | (unsigned int)pBytes[3];
+}
+
+static int readInt(const char* pData)
+{
+    return (int)readUnsigned(pData);
+}
+
+static float readFloat(const char* pData)
+{
+    unsigned int bits = readUnsigned(pData);
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+// Count of bits necessary to store size
+static int sizeOfInt(unsigned int size)
+{
+    unsigned int num = 1;
+    int bitCount = 0;
+    while(size >= num && bitCount < 32)
+    {
+        bitCount++;
+        num <<= 1;
+    }
+    return bitCount;
+}
+
+// Count of bits necessary to store three integers with given sizes as one number
+static int sizeOfInts(const unsigned int sizes[3])
+{
+    unsigned int bytes[32];
+    unsigned int byteCount = 1;
+    bytes[0] = 1;
+    for(int i = 0; i < 3; i++)
+    {
+        unsigned int tmp = 0;
+        unsigned int byteIndex;
+        for(byteIndex = 0; byteIndex < byteCount; byteIndex++)
+        {
+            tmp = bytes[byteIndex] * sizes[i] + tmp;
+            bytes[byteIndex] = tmp & 0xff;
+            tmp >>= 8;
+        }
+        while(tmp != 0)
+        {
+            bytes[byteIndex++] = tmp & 0xff;
+            tmp >>= 8;
+        }
+        byteCount = byteIndex;
+    }
+    unsigned int num = 1;
+    int bitCount = 0;
+    byteCount--;
+    while(bytes[byteCount] >= num)
+    {
+        bitCount++;
+        num *= 2;
+    }
+    return bitCount + (int)byteCount * 8;
+}
+
+// Reader for bits of compressed coordinates
+struct BitReader
+{
+    const unsigned char* pData;
+    size_t size = 0; // count of bytes of compressed coordinates
+    size_t count = 0;
+    unsigned int lastBits = 0;
+    unsigned int lastByte = 0;
+    bool overrun = false; // set when more bytes are requested than available
+
+    unsigned int nextByte()
+    {
+        if(count >= size)
+        {
+            overrun = true;
+            return 0;
+        }
+        return pData[count++];
+    }
+
+    int receiveBits(int bitCount)
+    {
+        unsigned int mask = bitCount >= 32 ? 0xffffffffu : ((1u << bitCount) - 1);
+        unsigned int num = 0;
+        while(bitCount >= 8)
+        {
+            lastByte = (lastByte << 8) | nextByte();
+            num |= (lastByte >> lastBits) << (bitCount - 8);
+            bitCount -= 8;
+        }
+        if(bitCount > 0)
+        {
+            if((int)lastBits < bitCount)
+            {
+                lastBits += 8;
+                lastByte = (lastByte << 8) | nextByte();
+            }
+            lastBits -= bitCount;
+            num |= (lastByte >> lastBits) & ((1u << bitCount) - 1);
+        }
+        return (int)(num & mask);
+    }
+
+    void receiveInts(int bitCount, const unsigned int sizes[3], int nums[3])
+    {
+        int bytes[32];
+        int byteCount = 0;
+        bytes[0] = bytes[1] = bytes[2] = bytes[3] = 0;
+        while(bitCount > 8)
+        {
+            bytes[byteCount++] = receiveBits(8);
+            bitCount -= 8;
+        }
+        if(bitCount > 0)
+        {
+            bytes[byteCount++] = receiveBits(bitCount);
+        }
+        for(int i = 2; i > 0; i--)
+        {
+            unsigned int num = 0;
+            for(int j = byteCount - 1; j >= 0; j--)
+            {
+                num = (num << 8) | (unsigned int)bytes[j];
+                unsigned int p = num / sizes[i];
+                bytes[j] = (int)p;
+                num = num - p * sizes[i];
+            }
+            nums[i] = (int)num;
+        }
+        nums[0] = bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | (bytes[3] << 24);
+    }
+};
+
+XTCReader::XTCReader(std::string filepath, bool useIndexFile)
+{
+    mupFile = std::unique_ptr<MappedFile>(new MappedFile(filepath));
+    if(mupFile->isOpen())
+    {
+        // Try cached offsets first, otherwise scan file and cache offsets for next time
+        if(useIndexFile && loadIndex())
+        {
+            // Nothing to do
+        }
+        else if(!scan())
+        {
+            Logger::instance().print("Corrupt XTC file: " + filepath, Logger::Mode::ERROR);
+        }
+        else if(useIndexFile && !saveIndex())
+        {
+            Logger::instance().print("Could not write XTC index file: " + getIndexFilepath(), Logger::Mode::WARNING);
+        }
+    }
+}
+
+XTCReader::~XTCReader()
+{
+    // Nothing to do
+}
+
+bool XTCReader::scan()
+{
+    const char* pData = mupFile->getData();
+    size_t size = mupFile->getSize();
+    size_t offset = 0;
+    while(offset + headerSize + 4 <= size)
+    {
+        // Check magic number and count of atoms
+        int magic = readInt(pData + offset);
+        int atomCount = readInt(pData + offset + 4);
+        if((magic != xtcMagic && magic != xtcMagicLarge) || atomCount <= 0) { return false; }
+        if(mFrameOffsets.empty()) { mAtomCount = atomCount; }
+        else if(atomCount != mAtomCount) { return false; }
+
+        // Skip coordinates
+        size_t frameSize = headerSize + 4;
+        if(atomCount <= maxUncompressedAtomCount)
+        {
+            frameSize += 3 * 4 * (size_t)atomCount;
+        }
+        else
+        {
+            // Precision, min and max integers and small index
+            frameSize += 4 + 3 * 4 + 3 * 4 + 4;
+            if(offset + frameSize + 8 > size) { return false; }
+
+            // Count of bytes of compressed coordinates, padded to multiple of four
+            size_t byteCount;
+            if(magic == xtcMagicLarge)
+            {
+                byteCount = ((size_t)readUnsigned(pData + offset + frameSize) << 32) | (size_t)readUnsigned(pData + offset + frameSize + 4);
+                frameSize += 8;
+            }
+            else
+            {
+                byteCount = (size_t)readUnsigned(pData + offset + frameSize);
+                frameSize += 4;
+            }
+            frameSize += (byteCount + 3) & ~((size_t)3);
+        }
+        if(offset + frameSize > size) { return false; }
+
+        // Remember frame
+        mFrameOffsets.push_back(offset);
+        offset += frameSize;
+    }
+    return !mFrameOffsets.empty();
+}
+
+bool XTCReader::loadIndex()
+{
+    std::ifstream in(getIndexFilepath(), std::ios::binary | std::ios::ate);
+    if(!in) { return false; }
+    unsigned long long indexSize = (unsigned long long)in.tellg();
+    in.seekg(0, std::ios::beg);
+
+    // Header must match the current state of the trajectory file
+    IndexHeader header;
+    if(!in.read((char*)&header, sizeof(header))) { return false; }
+    if(std::memcmp(header.pMagic, indexMagic, sizeof(header.pMagic)) != 0
+        || header.version != indexVersion
+        || header.fileSize != (unsigned long long)mupFile->getSize()
+        || header.modificationTime != mupFile->getModificationTime()
+        || header.atomCount <= 0
+        || header.frameCount == 0)
+    {
+        return false;
+    }
+
+    // Size of index must fit count of frames, otherwise it is truncated or stale and gets rebuilt
+    if(indexSize < sizeof(header)
+        || header.frameCount != (indexSize - sizeof(header)) / sizeof(unsigned long long)
+        || sizeof(header) + header.frameCount * sizeof(unsigned long long) != indexSize)
+    {
+        return false;
+    }
+
+    // Read offsets
+    std::vector<unsigned long long> offsets(header.frameCount);
+    if(!in.read((char*)offsets.data(), offsets.size() * sizeof(unsigned long long))) { return false; }
+
+    // Offsets must be ascending and each must point at a frame header
+    const char* pData = mupFile->getData();
+    for(size_t i = 0; i < offsets.size(); i++)
+    {
+        if((i > 0 && offsets.at(i) <= offsets.at(i - 1)) || offsets.at(i) + headerSize + 4 > header.fileSize) { return false; }
+        int magic = readInt(pData + offsets.at(i));
+        if((magic != xtcMagic && magic != xtcMagicLarge) || readInt(pData + offsets.at(i) + 4) != header.atomCount) { return false; }
+    }
+
+    // Use it
+    mAtomCount = header.atomCount;
+    mFrameOffsets.assign(offsets.begin(), offsets.end());
+    return true;
+}
+
+bool XTCReader::saveIndex() const
+{
+    std::ofstream out(getIndexFilepath(), std::ios::binary | std::ios::trunc);
+    if(!out) { return false; }
+
+    // Header
+    IndexHeader header;
+    std::memcpy(header.pMagic, indexMagic, sizeof(header.pMagic));
+    header.version = indexVersion;
+    header.atomCount = mAtomCount;
+    header.fileSize = (unsigned long long)mupFile->getSize();
+    header.modificationTime = mupFile->getModificationTime();
+    header.frameCount = (unsigned long long)mFrameOffsets.size();
+    out.write((const char*)&header, sizeof(header));
+
+    // Offsets
+    std::vector<unsigned long long> offsets(mFrameOffsets.begin(), mFrameOffsets.end());
+    out.write((const char*)offsets.data(), offsets.size() * sizeof(unsigned long long));
+    return (bool)out;
+}
+
+bool XTCReader::decodeFrame(int fileFrame, glm::vec3* pPositions) const
+{
+    if(fileFrame < 0 || fileFrame >= getFileFrameCount()) { return false; }
+    const char* pData = mupFile->getData() + mFrameOffsets.at(fileFrame);
+    int magic = readInt(pData);
+    pData += headerSize;
+
+    // Check count of atoms
+    int atomCount = readInt(pData);
+    pData += 4;
+    if(atomCount != mAtomCount) { return false; }
+
+    // Few atoms are stored uncompressed
+    if(atomCount <= maxUncompressedAtomCount)
+    {
+        for(int i = 0; i < atomCount; i++)
+        {
+            pPositions[i] = glm::vec3(
+                readFloat(pData + 12 * i) * nanometerToAngstrom,
+                readFloat(pData + 12 * i + 4) * nanometerToAngstrom,
+                readFloat(pData + 12 * i + 8) * nanometerToAngstrom);
+        }
+        return true;
+    }
+
+    // Precision and integer ranges
+    float precision = readFloat(pData);
+    int minInt[3] = { readInt(pData + 4), readInt(pData + 8), readInt(pData + 12) };
+    int maxInt[3] = { readInt(pData + 16), readInt(pData + 20), readInt(pData + 24) };
+    int smallIndex = readInt(pData + 28);
+    pData += 32;
+    if(smallIndex < 0 || smallIndex >= lastMagicIndex || precision <= 0) { return false; }
+
+    // Count of bytes of compressed coordinates, must not exceed mapped file
+    size_t byteCount;
+    if(magic == xtcMagicLarge)
+    {
+        byteCount = ((size_t)readUnsigned(pData) << 32) | (size_t)readUnsigned(pData + 4);
+        pData += 8;
+    }
+    else
+    {
+        byteCount = (size_t)readUnsigned(pData);
+        pData += 4;
+    }
+    const char* pFileEnd = mupFile->getData() + mupFile->getSize();
+    if(pData > pFileEnd || byteCount > (size_t)(pFileEnd - pData)) { return false; }
+
+    // Sizes of integers
+    unsigned int sizeInt[3];
+    int bitSizeInt[3] = { 0, 0, 0 };
+    int bitSize = 0;
+    for(int i = 0; i < 3; i++) { sizeInt[i] = (unsigned int)(maxInt[i] - minInt[i] + 1); }
+    if((sizeInt[0] | sizeInt[1] | sizeInt[2]) > 0xffffff)
+    {
+        // Sizes are too big to be multiplied, so each one is stored separately
+        for(int i = 0; i < 3; i++) { bitSizeInt[i] = sizeOfInt(sizeInt[i]); }
+    }
+    else
+    {
+        bitSize = sizeOfInts(sizeInt);
+    }
+    int smaller = magicInts[glm::max(firstMagicIndex, smallIndex - 1)] / 2;
+    int smallNum = magicInts[smallIndex] / 2;
+    unsigned int sizeSmall[3];
+    sizeSmall[0] = sizeSmall[1] = sizeSmall[2] = (unsigned int)magicInts[smallIndex];
+
+    // Decode coordinates
+    BitReader reader;
+    reader.pData = (const unsigned char*)pData;
+    reader.size = byteCount;
+    float factor = nanometerToAngstrom / precision;
+    int thisCoord[3];
+    int prevCoord[3];
+    int run = 0;
+    int i = 0;
+    while(i < atomCount)
+    {
+        // Full coordinate
+        if(bitSize == 0)
+        {
+            for(int k = 0; k < 3; k++) { thisCoord[k] = reader.receiveBits(bitSizeInt[k]); }
+        }
+        else
+        {
+            reader.receiveInts(bitSize, sizeInt, thisCoord);
+        }
+        for(int k = 0; k < 3; k++)
+        {
+            thisCoord[k] += minInt[k];
+            prevCoord[k] = thisCoord[k];
+        }
+
+        // Run of small differences follows. Run is kept from previous atom when flag is not set
+        int isSmaller = 0;
+        if(reader.receiveBits(1) == 1)
+        {
+            run = reader.receiveBits(5);
+            isSmaller = run % 3;
+            run -= isSmaller;
+            isSmaller--;
+        }
+        if(run > 0)
+        {
+            if(i + run / 3 >= atomCount) { return false; }
+            pPositions[i++] = glm::vec3(thisCoord[0], thisCoord[1], thisCoord[2]) * factor;
+            for(int k = 0; k < run; k += 3)
+            {
+                reader.receiveInts(smallIndex, sizeSmall, thisCoord);
+                for(int l = 0; l < 3; l++) { thisCoord[l] += prevCoord[l] - smallNum; }
+                if(k == 0)
+                {
+                    // First and second atom are interchanged for better compression of water molecules
+                    for(int l = 0; l < 3; l++) { std::swap(thisCoord[l], prevCoord[l]); }
+                    pPositions[i - 1] = glm::vec3(prevCoord[0], prevCoord[1], prevCoord[2]) * factor;
+                }
+                else
+                {
+                    for(int l = 0; l < 3; l++) { prevCoord[l] = thisCoord[l]; }
+                }
+                pPositions[i++] = glm::vec3(thisCoord[0], thisCoord[1], thisCoord[2]) * factor;
+            }
+        }
+        else
+        {
+            pPositions[i++] = glm::vec3(thisCoord[0], thisCoord[1], thisCoord[2]) * factor;
+        }
+
+        // Adapt size of small differences
+        smallIndex += isSmaller;
+        if(smallIndex < firstMagicIndex || smallIndex >= lastMagicIndex) { return false; }
+        if(isSmaller < 0)
+        {
+            smallNum = smaller;
+            smaller = smallIndex > firstMagicIndex ? magicInts[smallIndex - 1] / 2 : 0;
+        }
+        else if(isSmaller > 0)
+        {
+            smaller = smallNum;
+            smallNum = magicInts[smallIndex] / 2;
+        }
+        sizeSmall[0] = sizeSmall[1] = sizeSmall[2] = (unsigned int)magicInts[smallIndex];
+
+        // Corrupt frame which requests more bits than stored
+        if(reader.overrun) { return false; }
+    }
+
+    return true;
+}
@@ -0,0 +1,64 @@
+//============================================================================
+// Distributed under the MIT License. Author: Raphael Menges
+//============================================================================
+
+// Native reader of compressed GROMACS XTC trajectories. File is memory mapped
+// and frame offsets are found in one scan, so frames are decoded in parallel.
+// Offsets are cached in an index file next to the trajectory, so later opens
+// jump to any frame without scanning again.
+
+#ifndef XTC_READER_H
+#define XTC_READER_H
+
+#include "Molecule/NativeLoader/MappedFile.h"
+#include "Molecule/NativeLoader/TrajectoryFile.h"
+#include <glm/glm.hpp>
+#include <vector>
+#include <string>
+#include <memory>
+
+class XTCReader : public TrajectoryFile
+{
+public:
+
+    // Constructor, maps file and loads frame offsets from index file or scans for them. Check isOpen afterwards
+    XTCReader(std::string filepath, bool useIndexFile = true);
+
+    // Destructor
+    virtual ~XTCReader();
+
+    // Get count of atoms in each frame of file
+    virtual int getFileAtomCount() const { return mAtomCount; }
+
+    // Get count of frames in file
+    virtual int getFileFrameCount() const { return (int)mFrameOffsets.size(); }
+
+    // Get path of index file which caches the frame offsets
+    std::string getIndexFilepath() const { return mupFile->getFilepath() + ".idx"; }
+
+    // Decode one frame of file with all its atoms into positions with space for file atom count many entries.
+    // Ignores selection. Coordinates are converted to angstrom
+    virtual bool decodeFrame(int fileFrame, glm::vec3* pPositions) const;
+
+private:
+
+    // Scan file for frame offsets
+    bool scan();
+
+    // Load frame offsets from index file. Fails if index does not belong to current file
+    bool loadIndex();
+
+    // Save frame offsets to index file
+    bool saveIndex() const;
+
+    // Memory mapped file
+    std::unique_ptr<MappedFile> mupFile;
+
+    // Count of atoms in each frame
+    int mAtomCount = 0;
+
+    // Offset of each frame in bytes
+    std::vector<size_t> mFrameOffsets;
+};
+
+#endif // XTC_READER_H
@@ -0,0 +1,235 @@
+//============================================================================
+// Distributed under the MIT License. Author: Adrian Derstroff
+//============================================================================
+
+#include "CPUCountingSort.h"
+
+#include <thread>
+#include <algorithm>
+
+CPUCountingSort::CPUCountingSort()
+{
+    m_numThreads = 1;
+    m_numElements = 0;
+    m_numCells = 0;
+    m_maxCells = 0;
+    m_numSorted = 0;
+}
+
+
+/*
+ * Getter and setter
+ */
+int CPUCountingSort::getNumberOfThreads()
+{
+    return m_numThreads;
+}
+uint CPUCountingSort::getNumberOfCells()
+{
+    return m_numCells;
+}
+
+
+
+//-----------------------------------------------------//
+//                   INITIALIZATION                    //
+//-----------------------------------------------------//
+void CPUCountingSort::init(int numThreads)
+{
+    m_numThreads = numThreads;
+    if (m_numThreads <= 0) {
+        m_numThreads = std::max(1, (int)std::thread::hardware_concurrency());
+    }
+    m_threadSums.assign(m_numThreads, 0);
+
+    // per thread counts have to be reallocated for the new number of threads
+    m_threadGridcnt.clear();
+    m_numCells = 0;
+    m_maxCells = 0;
+}
+
+
+
+void CPUCountingSort::allocateBuffers(uint numElements, uint maxCells)
+{
+    // element related buffers
+    if (numElements != m_numElements) {
+        m_sortedPositions.assign(numElements, glm::vec3(0));
+        m_gcell.assign(numElements, (uint)GRID_UNDEF);
+        m_gndx.assign(numElements, (uint)GRID_UNDEF);
+        m_grid.assign(numElements, (uint)GRID_UNDEF);
+        m_undx.assign(numElements, (uint)GRID_UNDEF);
+    }
+
+    // grid related buffers
+    if (maxCells != m_maxCells || m_threadGridcnt.size() != (size_t)m_numThreads * maxCells) {
+        m_gridcnt.assign(maxCells, 0);
+        m_gridoff.assign(maxCells, 0);
+        m_threadGridcnt.assign((size_t)m_numThreads * maxCells, 0);
+    }
+
+    m_numElements = numElements;
+    m_numCells = maxCells;
+    m_maxCells = maxCells;
+    m_numSorted = 0;
+}
+
+
+
+void CPUCountingSort::executeInRanges(int count, std::function<void(int threadIdx, int begin, int end)> function)
+{
+    // run directly when there is nothing to split
+    if (m_numThreads <= 1) {
+        function(0, 0, count);
+        return;
+    }
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < m_numThreads; t++) {
+        int begin = (int)(((long long)count * t) / m_numThreads);
+        int end   = (int)(((long long)count * (t+1)) / m_numThreads);
+        threads.push_back(std::thread(function, t, begin, end));
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+}
+
+
+
+
+
+
+//-----------------------------------------------------//
+//                       SORTING                       //
+//-----------------------------------------------------//
+template<class T>
+void CPUCountingSort::sort(const T* positions, const uint* cells, uint numCells, CPUNeighborhood& neighborhood)
+{
+    /*
+     * the per thread counts are packed with a row length of numCells,
+     * so they only have to grow when the upper bound is exceeded
+     */
+    if (numCells > m_maxCells) {
+        allocateBuffers(m_numElements, numCells);
+    }
+    m_numCells = numCells;
+
+    countElements(cells);
+    prefixSumCells();
+
+    /*
+     * every thread moves the elements of the same range it counted
+     * to the offsets computed for it
+     */
+    executeInRanges(m_numElements, [&](int threadIdx, int begin, int end) {
+        uint* sortOffsets = &m_threadGridcnt[(size_t)threadIdx * m_numCells];
+        for (int i = begin; i < end; i++) {
+            uint icell = cells[i];
+
+            // elements outside of the grid are not sorted in
+            if (icell == (uint)GRID_UNDEF) {
+                m_grid[i] = (uint)GRID_UNDEF;
+                continue;
+            }
+
+            // transfer data to sort location
+            uint sort_ndx = sortOffsets[icell]++;
+            m_grid[i]                   = sort_ndx;         // map old idx to new idx
+            m_sortedPositions[sort_ndx] = glm::vec3(positions[i]);
+            m_gcell[sort_ndx]           = icell;
+            m_gndx[sort_ndx]            = sort_ndx - m_gridoff[icell];
+            m_undx[sort_ndx]            = (uint)i;
+        }
+    });
+
+    // mark the remaining sort locations of elements outside of the grid
+    std::fill(m_gcell.begin() + m_numSorted, m_gcell.end(), (uint)GRID_UNDEF);
+    std::fill(m_gndx.begin() + m_numSorted, m_gndx.end(), (uint)GRID_UNDEF);
+    std::fill(m_undx.begin() + m_numSorted, m_undx.end(), (uint)GRID_UNDEF);
+
+    // update neighborhood
+    neighborhood.p_sortedPositions          = m_sortedPositions.data();
+    neighborhood.p_particleOriginalIndex    = m_undx.data();
+    neighborhood.p_particleCell             = m_gcell.data();
+    neighborhood.p_particleCellIndex        = m_gndx.data();
+    neighborhood.p_grid                     = m_grid.data();
+    neighborhood.p_gridCellCounts           = m_gridcnt.data();
+    neighborhood.p_gridCellOffsets          = m_gridoff.data();
+    neighborhood.numberOfSortedElements     = m_numSorted;
+}
+template void CPUCountingSort::sort<glm::vec3>(const glm::vec3* positions, const uint* cells, uint numCells, CPUNeighborhood& neighborhood);
+template void CPUCountingSort::sort<glm::vec4>(const glm::vec4* positions, const uint* cells, uint numCells, CPUNeighborhood& neighborhood);
+
+
+
+void CPUCountingSort::countElements(const uint* cells)
+{
+    /*
+     * every thread counts the elements of its range in its own row of cell
+     * counts, so no atomics are needed and the insertion order stays the same
+     * as in a sequential run
+     */
+    executeInRanges(m_numElements, [&](int threadIdx, int begin, int end) {
+        uint* gridcnt = &m_threadGridcnt[(size_t)threadIdx * m_numCells];
+        std::fill_n(gridcnt, m_numCells, 0);
+        for (int i = begin; i < end; i++) {
+            if (cells[i] != (uint)GRID_UNDEF) {
+                gridcnt[cells[i]]++;
+            }
+        }
+    });
+}
+
+
+
+void CPUCountingSort::prefixSumCells()
+{
+    /*
+     * sum up the per thread counts of every cell and
+     * the counts of every range of cells
+     */
+    executeInRanges(m_numCells, [&](int threadIdx, int begin, int end) {
+        uint sum = 0;
+        for (int c = begin; c < end; c++) {
+            uint count = 0;
+            for (int t = 0; t < m_numThreads; t++) {
+                count += m_threadGridcnt[(size_t)t * m_numCells + c];
+            }
+            m_gridcnt[c] = count;
+            sum += count;
+        }
+        m_threadSums[threadIdx] = sum;
+    });
+
+    /*
+     * exclusive scan of the range sums, there is only one per thread
+     */
+    uint offset = 0;
+    for (int t = 0; t < m_numThreads; t++) {
+        uint sum = m_threadSums[t];
+        m_threadSums[t] = offset;
+        offset += sum;
+    }
+    m_numSorted = offset;
+
+    /*
+     * exclusive scan inside every range of cells starting at the range offset.
+     * The per thread counts are turned into the position where the respective
+     * thread inserts its next element of that cell
+     */
+    executeInRanges(m_numCells, [&](int threadIdx, int begin, int end) {
+        uint cellOffset = m_threadSums[threadIdx];
+        for (int c = begin; c < end; c++) {
+            m_gridoff[c] = cellOffset;
+            uint threadOffset = cellOffset;
+            for (int t = 0; t < m_numThreads; t++) {
+                uint& count = m_threadGridcnt[(size_t)t * m_numCells + c];
+                uint threadCount = count;
+                count = threadOffset;
+                threadOffset += threadCount;
+            }
+            cellOffset += m_gridcnt[c];
+        }
+    });
+}
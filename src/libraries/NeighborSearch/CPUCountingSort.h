@@ -0,0 +1,85 @@
+//============================================================================
+// Distributed under the MIT License. Author: Adrian Derstroff
+//============================================================================
+
+#ifndef OPENGL_FRAMEWORK_CPUCOUNTINGSORT_H
+#define OPENGL_FRAMEWORK_CPUCOUNTINGSORT_H
+
+#include <vector>
+#include <functional>
+
+#include "NeighborhoodSearchDefines.h"
+
+/*
+ * Parallel counting sort of elements by the cell they are in, shared by the
+ * cpu neighborhood searches. Every thread counts its range of elements into
+ * its own row of cell counts, a two pass prefix sum over the cells turns
+ * them into per thread insert offsets and the elements are scattered without
+ * atomics, so the result equals a sequential stable counting sort.
+ */
+class CPUCountingSort {
+public:
+    CPUCountingSort();
+
+    /*
+     * Getter and setter
+     */
+    int getNumberOfThreads();
+    uint getNumberOfCells();
+
+    /*
+     * number of threads <= 0 uses all hardware threads
+     */
+    void init(int numThreads);
+
+    /*
+     * maxCells is an upper bound for the number of cells of every sort,
+     * so the grid buffers are not reallocated when it changes between sorts
+     */
+    void allocateBuffers(uint numElements, uint maxCells);
+
+    /*
+     * sort the elements by their cell, cells outside of [0, numCells) have to be GRID_UNDEF.
+     * Fills the arrays of the neighborhood, which stay valid until the next sort
+     */
+    template<class T>
+    void sort(const T* positions, const uint* cells, uint numCells, CPUNeighborhood& neighborhood);
+
+    /*
+     * split [0,count) into one range per thread and process them in parallel,
+     * the ranges only depend on count and the number of threads
+     */
+    void executeInRanges(int count, std::function<void(int threadIdx, int begin, int end)> function);
+
+
+private:
+    int                 m_numThreads;
+    uint                m_numElements;
+    uint                m_numCells;             // number of cells of the current sort
+    uint                m_maxCells;             // number of cells the grid buffers are allocated for
+    uint                m_numSorted;
+
+    // particle buffers, sorted by cell
+    std::vector<glm::vec3> m_sortedPositions;
+    std::vector<uint>   m_gcell;                // cell idx the particle is in
+    std::vector<uint>   m_gndx;                 // insertion idx of the particle inside the cell
+    std::vector<uint>   m_grid;                 // idx of the particle after sorting
+    std::vector<uint>   m_undx;                 // get unsorted index from sorted index
+    // grid buffers
+    std::vector<uint>   m_gridcnt;              // number of particles per cell
+    std::vector<uint>   m_gridoff;              // offset of every cell
+    // temporary buffers
+    std::vector<uint>   m_threadGridcnt;        // per thread counts, turned into per thread offsets
+    std::vector<uint>   m_threadSums;           // sum of the cells of every thread for the prefix sum
+
+
+
+    /*
+     * sort helper functions
+     */
+    void countElements(const uint* cells);
+    void prefixSumCells();
+};
+
+
+#endif //OPENGL_FRAMEWORK_CPUCOUNTINGSORT_H
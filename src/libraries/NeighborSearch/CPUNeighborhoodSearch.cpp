@@ -0,0 +1,167 @@
+//============================================================================
+// Distributed under the MIT License. Author: Adrian Derstroff
+//============================================================================
+
+#include "CPUNeighborhoodSearch.h"
+
+#include <algorithm>
+
+CPUNeighborhoodSearch::CPUNeighborhoodSearch()
+{
+    m_numElements = 0;
+    m_neighborhood = CPUNeighborhood();
+}
+
+
+/*
+ * Getter and setter
+ */
+int CPUNeighborhoodSearch::getNumberOfGridCells()
+{
+    return m_searchGrid.total;
+}
+glm::vec3 CPUNeighborhoodSearch::getGridSize()
+{
+    return m_searchGrid.size;
+}
+glm::ivec3 CPUNeighborhoodSearch::getGridResolution()
+{
+    return m_searchGrid.res;
+}
+float CPUNeighborhoodSearch::getCellSize()
+{
+    return m_searchGrid.cellSize;
+}
+void CPUNeighborhoodSearch::getGridMinMax(glm::vec3& min, glm::vec3& max)
+{
+    min = m_searchGrid.min;
+    max = m_searchGrid.max;
+}
+int CPUNeighborhoodSearch::getGridSearch()
+{
+    return m_searchGrid.search;
+}
+float CPUNeighborhoodSearch::getMaxSearchRadius()
+{
+    return m_searchGrid.maxSearchRadius;
+}
+int CPUNeighborhoodSearch::getNumberOfThreads()
+{
+    return m_sort.getNumberOfThreads();
+}
+const SearchGrid& CPUNeighborhoodSearch::getSearchGrid()
+{
+    return m_searchGrid;
+}
+
+
+
+//-----------------------------------------------------//
+//                   INITIALIZATION                    //
+//-----------------------------------------------------//
+void CPUNeighborhoodSearch::init(uint numElements, glm::fvec3 min, glm::fvec3 max, glm::ivec3 resolution, float searchRadius, int numThreads)
+{
+    m_sort.init(numThreads);
+    update(numElements, min, max, resolution, searchRadius);
+}
+
+
+
+void CPUNeighborhoodSearch::update(uint numElements, glm::fvec3 min, glm::fvec3 max, glm::ivec3 resolution, float searchRadius)
+{
+    m_numElements = numElements;
+    m_searchGrid.setup(min, max, resolution, searchRadius);
+    m_sort.allocateBuffers(numElements, m_searchGrid.total);
+    m_tempGcell.assign(numElements, (uint)GRID_UNDEF);
+    m_neighborhood = CPUNeighborhood();
+}
+
+
+
+void CPUNeighborhoodSearch::executeInRanges(int count, std::function<void(int threadIdx, int begin, int end)> function)
+{
+    m_sort.executeInRanges(count, function);
+}
+
+
+
+
+
+
+//-----------------------------------------------------//
+//                NEIGHBORHOODSEARCH                   //
+//-----------------------------------------------------//
+void CPUNeighborhoodSearch::run(const glm::vec3* positions, CPUNeighborhood& neighborhood)
+{
+    runCPU(positions, neighborhood);
+}
+void CPUNeighborhoodSearch::run(const glm::vec4* positions, CPUNeighborhood& neighborhood)
+{
+    runCPU(positions, neighborhood);
+}
+
+
+
+template<class T>
+void CPUNeighborhoodSearch::runCPU(const T* positions, CPUNeighborhood& neighborhood)
+{
+    insertElementsInGridCPU(positions);
+    m_sort.sort(positions, m_tempGcell.data(), m_searchGrid.total, m_neighborhood);
+
+    // update neighborhood
+    m_neighborhood.p_searchCellOffsets      = m_searchGrid.adj;
+    m_neighborhood.startCellOffset          = m_searchGrid.adjOff;
+    m_neighborhood.numberOfSearchCells      = m_searchGrid.adjCnt;
+    m_neighborhood.searchRadius             = m_searchGrid.searchRadius;
+    neighborhood = m_neighborhood;
+}
+
+
+
+template<class T>
+void CPUNeighborhoodSearch::insertElementsInGridCPU(const T* positions)
+{
+    // determine the corresponding cell of every element
+    executeInRanges(m_numElements, [&](int, int begin, int end) {
+        for (int i = begin; i < end; i++) {
+            m_tempGcell[i] = m_searchGrid.cellIndex(glm::vec3(positions[i]));
+        }
+    });
+}
+
+
+
+void CPUNeighborhoodSearch::findNeighbors(uint elementIdx, std::vector<uint>& neighbors)
+{
+    neighbors.clear();
+    if (elementIdx >= (uint)m_numElements || m_neighborhood.p_grid == NULL) return;
+    uint i = m_neighborhood.p_grid[elementIdx];
+    if (i == (uint)GRID_UNDEF) return;
+
+    /*
+     * search all cells within the search radius, clamped to the grid borders
+     * instead of relying on the flattened adjacency mask
+     */
+    glm::vec3 pos = m_neighborhood.p_sortedPositions[i];
+    glm::ivec3 gc = m_searchGrid.cellCoordinates(pos);
+    int reach = std::max(1, (int)ceil(m_searchGrid.searchRadius / m_searchGrid.cellSize));
+    glm::ivec3 res = m_searchGrid.res;
+    float radius2 = m_searchGrid.searchRadius * m_searchGrid.searchRadius;
+
+    for (int y = std::max(0, gc.y - reach); y <= std::min(res.y - 1, gc.y + reach); y++) {
+        for (int z = std::max(0, gc.z - reach); z <= std::min(res.z - 1, gc.z + reach); z++) {
+            for (int x = std::max(0, gc.x - reach); x <= std::min(res.x - 1, gc.x + reach); x++) {
+                uint currentCell = (uint)((y * res.z + z) * res.x + x);
+                uint cellStart = m_neighborhood.p_gridCellOffsets[currentCell];
+                uint cellEnd = cellStart + m_neighborhood.p_gridCellCounts[currentCell];
+                for (uint j = cellStart; j < cellEnd; j++) {
+                    if (j == i) continue;
+                    glm::vec3 d = m_neighborhood.p_sortedPositions[j] - pos;
+                    if (d.x*d.x + d.y*d.y + d.z*d.z <= radius2) {
+                        neighbors.push_back(m_neighborhood.p_particleOriginalIndex[j]);
+                    }
+                }
+            }
+        }
+    }
+}
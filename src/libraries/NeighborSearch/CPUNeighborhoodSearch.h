@@ -0,0 +1,83 @@
+//============================================================================
+// Distributed under the MIT License. Author: Adrian Derstroff
+//============================================================================
+
+#ifndef OPENGL_FRAMEWORK_CPUNEIGHBORHOODSEARCH_H
+#define OPENGL_FRAMEWORK_CPUNEIGHBORHOODSEARCH_H
+
+#include <vector>
+#include <functional>
+
+#include "Utils/Logger.h"
+#include "NeighborhoodSearchDefines.h"
+#include "SearchGrid.h"
+#include "CPUCountingSort.h"
+
+/*
+ * Multithreaded cpu counterpart of the NeighborhoodSearch. Uses the same grid
+ * parameters and produces the same sorted grid arrays, but works on positions
+ * in main memory and does not need an OpenGL context. Insertion, prefix sum
+ * and counting sort run in parallel over ranges of elements and cells.
+ */
+class CPUNeighborhoodSearch {
+public:
+    CPUNeighborhoodSearch();
+
+    /*
+     * Getter and setter
+     */
+    int getNumberOfGridCells();
+    glm::vec3 getGridSize();
+    glm::ivec3 getGridResolution();
+    float getCellSize();
+    void getGridMinMax(glm::vec3& min, glm::vec3& max);
+    int getGridSearch();
+    float getMaxSearchRadius();
+    int getNumberOfThreads();
+    const SearchGrid& getSearchGrid();
+
+    /*
+     * neighbor search, number of threads <= 0 uses all hardware threads
+     */
+    void init(uint numElements, glm::fvec3 min, glm::fvec3 max, glm::ivec3 resolution, float searchRadius, int numThreads = 0);
+    void update(uint numElements, glm::fvec3 min, glm::fvec3 max, glm::ivec3 resolution, float searchRadius);
+    void run(const glm::vec3* positions, CPUNeighborhood& neighborhood);
+    void run(const glm::vec4* positions, CPUNeighborhood& neighborhood);
+
+    /*
+     * collect the original indices of all elements within the search radius
+     * of the element with the given original index, excluding the element itself.
+     * Only valid after run
+     */
+    void findNeighbors(uint elementIdx, std::vector<uint>& neighbors);
+
+    /*
+     * split [0,count) into one range per thread and process them in parallel,
+     * the ranges only depend on count and the number of threads
+     */
+    void executeInRanges(int count, std::function<void(int threadIdx, int begin, int end)> function);
+
+
+private:
+    // grid parameters
+    SearchGrid          m_searchGrid;
+    int                 m_numElements;          // number of particles
+
+    // sorting
+    CPUCountingSort     m_sort;
+    std::vector<uint>   m_tempGcell;            // cell idx in unsorted order
+    CPUNeighborhood     m_neighborhood;         // result of the last run
+
+
+
+    /*
+     * run helper functions
+     */
+    template<class T>
+    void runCPU(const T* positions, CPUNeighborhood& neighborhood);
+    template<class T>
+    void insertElementsInGridCPU(const T* positions);
+};
+
+
+#endif //OPENGL_FRAMEWORK_CPUNEIGHBORHOODSEARCH_H
@@ -0,0 +1,333 @@
+//============================================================================
+// Distributed under the MIT License. Author: Adrian Derstroff
+//============================================================================
+
+#include "HashedNeighborhoodSearch.h"
+
+#include <math.h>
+#include <algorithm>
+
+static const uint64_t KEY_EMPTY          = UINT64_MAX;  // marks empty table slots and elements without cell
+static const int      KEY_BITS           = 21;          // bits per cell coordinate within a key
+static const float    DENSE_OCCUPANCY    = 8.f;         // mean elements per cell of search radius size
+                                                        // above which cells of half the size are used
+
+HashedNeighborhoodSearch::HashedNeighborhoodSearch()
+{
+    m_searchRadius = 0;
+    m_cellSize = 0;
+    m_gridSearch = 1;
+    m_gridMin = glm::vec3(0);
+    m_gridMax = glm::vec3(0);
+    m_numElements = 0;
+    m_tableMask = 0;
+    m_numOccupiedCells = 0;
+    m_neighborhood = CPUNeighborhood();
+}
+
+
+/*
+ * Getter and setter
+ */
+int HashedNeighborhoodSearch::getNumberOfOccupiedCells()
+{
+    return m_numOccupiedCells;
+}
+float HashedNeighborhoodSearch::getCellSize()
+{
+    return m_cellSize;
+}
+void HashedNeighborhoodSearch::getGridMinMax(glm::vec3& min, glm::vec3& max)
+{
+    min = m_gridMin;
+    max = m_gridMax;
+}
+int HashedNeighborhoodSearch::getGridSearch()
+{
+    return 2 * m_gridSearch + 1;
+}
+float HashedNeighborhoodSearch::getSearchRadius()
+{
+    return m_searchRadius;
+}
+int HashedNeighborhoodSearch::getNumberOfThreads()
+{
+    return m_sort.getNumberOfThreads();
+}
+
+
+
+//-----------------------------------------------------//
+//                   INITIALIZATION                    //
+//-----------------------------------------------------//
+void HashedNeighborhoodSearch::init(uint numElements, float searchRadius, int numThreads)
+{
+    m_sort.init(numThreads);
+    m_threadMin.resize(m_sort.getNumberOfThreads());
+    m_threadMax.resize(m_sort.getNumberOfThreads());
+    update(numElements, searchRadius);
+}
+
+
+
+void HashedNeighborhoodSearch::update(uint numElements, float searchRadius)
+{
+    m_numElements = numElements;
+    m_searchRadius = searchRadius;
+    m_cellSize = 0; // choose again on the next run
+
+    // there are never more occupied cells than elements, keep the table at most half full
+    uint tableSize = 16;
+    while (tableSize < 2 * numElements) {
+        tableSize *= 2;
+    }
+    m_tableKeys.resize(tableSize);
+    m_tableCells.resize(tableSize);
+    m_tableMask = tableSize - 1;
+    m_numOccupiedCells = 0;
+
+    m_elementKeys.assign(numElements, KEY_EMPTY);
+    m_tempGcell.assign(numElements, (uint)GRID_UNDEF);
+    m_sort.allocateBuffers(numElements, numElements);
+    m_neighborhood = CPUNeighborhood();
+}
+
+
+
+void HashedNeighborhoodSearch::executeInRanges(int count, std::function<void(int threadIdx, int begin, int end)> function)
+{
+    m_sort.executeInRanges(count, function);
+}
+
+
+
+
+
+
+//-----------------------------------------------------//
+//                NEIGHBORHOODSEARCH                   //
+//-----------------------------------------------------//
+void HashedNeighborhoodSearch::run(const glm::vec3* positions, CPUNeighborhood& neighborhood)
+{
+    runCPU(positions, neighborhood);
+}
+void HashedNeighborhoodSearch::run(const glm::vec4* positions, CPUNeighborhood& neighborhood)
+{
+    runCPU(positions, neighborhood);
+}
+
+
+
+template<class T>
+void HashedNeighborhoodSearch::runCPU(const T* positions, CPUNeighborhood& neighborhood)
+{
+    computeBounds(positions);
+    if (m_cellSize <= 0) {
+        selectCellSize(positions);
+    }
+
+    /*
+     * hash the occupied cells and sort the elements by them
+     */
+    computeKeys(positions);
+    insertKeys();
+    m_sort.sort(positions, m_tempGcell.data(), m_numOccupiedCells, m_neighborhood);
+
+    // update neighborhood
+    m_neighborhood.p_searchCellOffsets      = NULL;
+    m_neighborhood.startCellOffset          = 0;
+    m_neighborhood.numberOfSearchCells      = getGridSearch() * getGridSearch() * getGridSearch();
+    m_neighborhood.searchRadius             = m_searchRadius;
+    neighborhood = m_neighborhood;
+}
+
+
+
+template<class T>
+void HashedNeighborhoodSearch::computeBounds(const T* positions)
+{
+    executeInRanges(m_numElements, [&](int threadIdx, int begin, int end) {
+        glm::vec3 min = glm::vec3(INFINITY);
+        glm::vec3 max = glm::vec3(-INFINITY);
+        for (int i = begin; i < end; i++) {
+            glm::vec3 pos = glm::vec3(positions[i]);
+            min = glm::min(min, pos);
+            max = glm::max(max, pos);
+        }
+        m_threadMin[threadIdx] = min;
+        m_threadMax[threadIdx] = max;
+    });
+
+    m_gridMin = glm::vec3(INFINITY);
+    m_gridMax = glm::vec3(-INFINITY);
+    for (int t = 0; t < m_sort.getNumberOfThreads(); t++) {
+        m_gridMin = glm::min(m_gridMin, m_threadMin[t]);
+        m_gridMax = glm::max(m_gridMax, m_threadMax[t]);
+    }
+    if (m_numElements == 0) {
+        m_gridMin = glm::vec3(0);
+        m_gridMax = glm::vec3(0);
+    }
+}
+
+
+
+template<class T>
+void HashedNeighborhoodSearch::selectCellSize(const T* positions)
+{
+    /*
+     * without search radius the cells follow the mean volume per element
+     */
+    if (m_searchRadius <= 0) {
+        glm::vec3 size = m_gridMax - m_gridMin;
+        float volume = std::max(size.x, 1.f) * std::max(size.y, 1.f) * std::max(size.z, 1.f);
+        m_cellSize = cbrt(volume / std::max(m_numElements, 1));
+        m_gridSearch = 1;
+        return;
+    }
+
+    /*
+     * cells of the search radius require 3x3x3 cells to be searched. When the
+     * occupied cells hold many elements, cells of half the radius are better,
+     * since the 5x5x5 search cells cover only 15.6r^3 instead of 27r^3.
+     * The density is measured on the occupied cells only, so empty space
+     * between spread out proteins does not hide dense packing
+     */
+    m_cellSize = m_searchRadius;
+    computeKeys(positions);
+    insertKeys();
+    float occupancy = (float)m_numElements / (float)std::max(m_numOccupiedCells, 1u);
+    if (occupancy > DENSE_OCCUPANCY) {
+        m_cellSize = 0.5f * m_searchRadius;
+    }
+    m_gridSearch = (int)ceil(m_searchRadius / m_cellSize);
+
+    Logger::instance().print("Hashed neighborhood search uses cell size " + std::to_string(m_cellSize)
+                             + " for " + std::to_string(occupancy) + " elements per occupied cell");
+}
+
+
+
+template<class T>
+void HashedNeighborhoodSearch::computeKeys(const T* positions)
+{
+    executeInRanges(m_numElements, [&](int, int begin, int end) {
+        for (int i = begin; i < end; i++) {
+            m_elementKeys[i] = packKey(cellCoordinates(glm::vec3(positions[i])));
+        }
+    });
+}
+
+
+
+void HashedNeighborhoodSearch::insertKeys()
+{
+    /*
+     * cells are numbered in the order they are first occupied,
+     * which keeps the sorting deterministic
+     */
+    std::fill(m_tableKeys.begin(), m_tableKeys.end(), KEY_EMPTY);
+    m_numOccupiedCells = 0;
+    for (int i = 0; i < m_numElements; i++) {
+        uint64_t key = m_elementKeys[i];
+        if (key == KEY_EMPTY) {
+            m_tempGcell[i] = (uint)GRID_UNDEF;
+            continue;
+        }
+
+        uint slot = hashKey(key);
+        while (m_tableKeys[slot] != KEY_EMPTY && m_tableKeys[slot] != key) {
+            slot = (slot + 1) & m_tableMask;
+        }
+        if (m_tableKeys[slot] == KEY_EMPTY) {
+            m_tableKeys[slot] = key;
+            m_tableCells[slot] = m_numOccupiedCells++;
+        }
+        m_tempGcell[i] = m_tableCells[slot];
+    }
+}
+
+
+
+glm::ivec3 HashedNeighborhoodSearch::cellCoordinates(const glm::vec3& position)
+{
+    glm::vec3 gcf = (position - m_gridMin) / m_cellSize;
+    return glm::ivec3((int)floor(gcf.x), (int)floor(gcf.y), (int)floor(gcf.z));
+}
+
+
+
+uint HashedNeighborhoodSearch::findCell(const glm::ivec3& cell)
+{
+    uint64_t key = packKey(cell);
+    if (key == KEY_EMPTY || m_tableKeys.empty()) return (uint)GRID_UNDEF;
+
+    uint slot = hashKey(key);
+    while (m_tableKeys[slot] != KEY_EMPTY) {
+        if (m_tableKeys[slot] == key) return m_tableCells[slot];
+        slot = (slot + 1) & m_tableMask;
+    }
+    return (uint)GRID_UNDEF;
+}
+
+
+
+void HashedNeighborhoodSearch::findNeighbors(uint elementIdx, std::vector<uint>& neighbors)
+{
+    neighbors.clear();
+    if (elementIdx >= (uint)m_numElements || m_neighborhood.p_grid == NULL) return;
+    uint i = m_neighborhood.p_grid[elementIdx];
+    if (i == (uint)GRID_UNDEF) return;
+
+    /*
+     * look up all cells within the search radius, empty cells are not in the hash
+     */
+    glm::vec3 pos = m_neighborhood.p_sortedPositions[i];
+    glm::ivec3 gc = cellCoordinates(pos);
+    float radius2 = m_searchRadius * m_searchRadius;
+
+    for (int y = gc.y - m_gridSearch; y <= gc.y + m_gridSearch; y++) {
+        for (int z = gc.z - m_gridSearch; z <= gc.z + m_gridSearch; z++) {
+            for (int x = gc.x - m_gridSearch; x <= gc.x + m_gridSearch; x++) {
+                uint currentCell = findCell(glm::ivec3(x, y, z));
+                if (currentCell == (uint)GRID_UNDEF) continue;
+                uint cellStart = m_neighborhood.p_gridCellOffsets[currentCell];
+                uint cellEnd = cellStart + m_neighborhood.p_gridCellCounts[currentCell];
+                for (uint j = cellStart; j < cellEnd; j++) {
+                    if (j == i) continue;
+                    glm::vec3 d = m_neighborhood.p_sortedPositions[j] - pos;
+                    if (d.x*d.x + d.y*d.y + d.z*d.z <= radius2) {
+                        neighbors.push_back(m_neighborhood.p_particleOriginalIndex[j]);
+                    }
+                }
+            }
+        }
+    }
+}
+
+
+
+uint64_t HashedNeighborhoodSearch::packKey(const glm::ivec3& cell)
+{
+    // cells outside of the representable range, e.g. of invalid positions, get no key
+    const int limit = 1 << KEY_BITS;
+    if (cell.x < 0 || cell.x >= limit ||
+        cell.y < 0 || cell.y >= limit ||
+        cell.z < 0 || cell.z >= limit) {
+        return KEY_EMPTY;
+    }
+    return (uint64_t)cell.x | ((uint64_t)cell.y << KEY_BITS) | ((uint64_t)cell.z << (2 * KEY_BITS));
+}
+
+
+
+uint HashedNeighborhoodSearch::hashKey(uint64_t key)
+{
+    // finalizer of splitmix64 to spread neighboring cells over the table
+    key ^= key >> 30;
+    key *= 0xbf58476d1ce4e5b9ULL;
+    key ^= key >> 27;
+    key *= 0x94d049bb133111ebULL;
+    key ^= key >> 31;
+    return (uint)key & m_tableMask;
+}
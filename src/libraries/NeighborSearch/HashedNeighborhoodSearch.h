@@ -0,0 +1,119 @@
+//============================================================================
+// Distributed under the MIT License. Author: Adrian Derstroff
+//============================================================================
+
+#ifndef OPENGL_FRAMEWORK_HASHEDNEIGHBORHOODSEARCH_H
+#define OPENGL_FRAMEWORK_HASHEDNEIGHBORHOODSEARCH_H
+
+#include <vector>
+#include <cstdint>
+#include <functional>
+
+#include "Utils/Logger.h"
+#include "NeighborhoodSearchDefines.h"
+#include "CPUCountingSort.h"
+
+/*
+ * Sparse variant of the CPUNeighborhoodSearch. Instead of a dense grid over
+ * user given bounds and resolution, only the occupied cells are stored in a
+ * spatial hash, so loosely packed scenes with several proteins or large boxes
+ * do not pay for empty cells. The cell size is chosen automatically from the
+ * search radius and the density of the elements on the first run.
+ *
+ * The neighborhood has the same arrays as the one of the CPUNeighborhoodSearch,
+ * but cells are numbered by their order of occupation. Therefore there is no
+ * flattened adjacency mask (p_searchCellOffsets is NULL), neighboring cells are
+ * found with findCell or all neighbors of an element with findNeighbors.
+ */
+class HashedNeighborhoodSearch {
+public:
+    HashedNeighborhoodSearch();
+
+    /*
+     * Getter and setter
+     */
+    int getNumberOfOccupiedCells();
+    float getCellSize();
+    void getGridMinMax(glm::vec3& min, glm::vec3& max);
+    int getGridSearch();
+    float getSearchRadius();
+    int getNumberOfThreads();
+
+    /*
+     * neighbor search, number of threads <= 0 uses all hardware threads
+     */
+    void init(uint numElements, float searchRadius, int numThreads = 0);
+    void update(uint numElements, float searchRadius);
+    void run(const glm::vec3* positions, CPUNeighborhood& neighborhood);
+    void run(const glm::vec4* positions, CPUNeighborhood& neighborhood);
+
+    /*
+     * 3D coordinates of the cell a position is in, relative to the minimum of the last run
+     */
+    glm::ivec3 cellCoordinates(const glm::vec3& position);
+
+    /*
+     * index of the occupied cell with the given coordinates or GRID_UNDEF if it is empty
+     */
+    uint findCell(const glm::ivec3& cell);
+
+    /*
+     * collect the original indices of all elements within the search radius
+     * of the element with the given original index, excluding the element itself.
+     * Only valid after run
+     */
+    void findNeighbors(uint elementIdx, std::vector<uint>& neighbors);
+
+    /*
+     * split [0,count) into one range per thread and process them in parallel
+     */
+    void executeInRanges(int count, std::function<void(int threadIdx, int begin, int end)> function);
+
+
+private:
+    // grid parameters
+    float                   m_searchRadius;
+    float                   m_cellSize;             // zero until chosen on the next run
+    int                     m_gridSearch;           // number of cells to search in every direction
+    glm::vec3               m_gridMin;              // bounds of the elements of the last run
+    glm::vec3               m_gridMax;
+    int                     m_numElements;          // number of particles
+
+    // spatial hash of the occupied cells, open addressing with linear probing
+    std::vector<uint64_t>   m_tableKeys;
+    std::vector<uint>       m_tableCells;
+    uint                    m_tableMask;
+    uint                    m_numOccupiedCells;
+
+    // sorting
+    CPUCountingSort         m_sort;
+    std::vector<uint64_t>   m_elementKeys;          // cell key of every element
+    std::vector<uint>       m_tempGcell;            // occupied cell idx in unsorted order
+    std::vector<glm::vec3>  m_threadMin;            // bounds found by every thread
+    std::vector<glm::vec3>  m_threadMax;
+    CPUNeighborhood         m_neighborhood;         // result of the last run
+
+
+
+    /*
+     * run helper functions
+     */
+    template<class T>
+    void runCPU(const T* positions, CPUNeighborhood& neighborhood);
+    template<class T>
+    void computeBounds(const T* positions);
+    template<class T>
+    void computeKeys(const T* positions);
+    template<class T>
+    void selectCellSize(const T* positions);
+    void insertKeys();
+
+    /*
+     * hash helper functions
+     */
+    uint64_t packKey(const glm::ivec3& cell);
+    uint hashKey(uint64_t key);
+};
+
+
+#endif //OPENGL_FRAMEWORK_HASHEDNEIGHBORHOODSEARCH_H
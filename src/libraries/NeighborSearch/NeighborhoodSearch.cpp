@@ -241,22 +241,22 @@ void NeighborhoodSearch::deallocBlockSumsInt()
 
 void NeighborhoodSearch::setupGrid(glm::fvec3 min, glm::fvec3 max, glm::ivec3 resolution, float searchRadius)
 {
-    // calculate grid parameters
-    m_gridMin = min;
-    m_gridMax = max;
-    m_gridSize = max;
-    m_gridSize -= min;
-    m_gridRes = resolution;
-    glm::vec3 cellSizes = m_gridSize;
-    cellSizes /= m_gridRes;
-    m_cellSize = std::max(cellSizes.x, std::max(cellSizes.y, cellSizes.z));
-    m_gridSize  = m_gridRes; // update grid size to be a multiple of the cell size
-    m_gridSize *= m_cellSize;
-    m_gridMax = m_gridMin + m_gridSize;
-    m_gridDelta = m_gridRes;
-    m_gridDelta /= m_gridSize;
-    m_gridTotal = m_gridRes.x * m_gridRes.y * m_gridRes.z;
-    m_searchRadius = searchRadius;
+    // calculate grid parameters, shared with the cpu neighborhood search
+    SearchGrid grid;
+    grid.setup(min, max, resolution, searchRadius);
+    m_gridMin = grid.min;
+    m_gridMax = grid.max;
+    m_gridSize = grid.size;
+    m_gridRes = grid.res;
+    m_cellSize = grid.cellSize;
+    m_gridDelta = grid.delta;
+    m_gridTotal = grid.total;
+    m_searchRadius = grid.searchRadius;
+    m_maxSearchRadius = grid.maxSearchRadius;
+    m_gridSearch = grid.search;
+    m_gridAdjCnt = grid.adjCnt;
+    m_gridAdjOff = grid.adjOff;
+    memcpy(m_gridAdj, grid.adj, sizeof(m_gridAdj));
 
     // allocate grid
     m_grid = (uint*) malloc(sizeof(uint*)* m_gridTotal);
@@ -264,41 +264,6 @@ void NeighborhoodSearch::setupGrid(glm::fvec3 min, glm::fvec3 max, glm::ivec3 re
     memset(m_grid, (int)GRID_UNDEF, m_gridTotal*sizeof(uint));
     memset(m_gridCnt, (int)GRID_UNDEF, m_gridTotal*sizeof(uint));
 
-    // number of cells to search
-    /*
-     * n = (2r/w)+1,
-     * n: 1D cell search count
-     * r: search radius
-     * w: cell width
-     */
-    m_gridSearch = (int) 2*ceil(searchRadius / m_cellSize) +1;
-    if (m_gridSearch < 3) m_gridSearch = 3;
-    m_gridAdjCnt = m_gridSearch * m_gridSearch * m_gridSearch;
-    if (m_gridSearch > 5) {
-        Logger::instance().print("Warning: Neighbor search is n > 5, n is set to 5 instead", Logger::Mode::WARNING);
-        m_gridSearch = 5;
-    }
-    m_maxSearchRadius = 5/2 * m_cellSize;
-
-    // setup adjacency grid
-    int cell = 0;
-    for (int y = 0; y < m_gridSearch; y++) {
-        for (int z = 0; z < m_gridSearch; z++) {
-            for (int x = 0; x < m_gridSearch; x++) {
-                m_gridAdj[cell++] = (y * m_gridRes.z + z) * m_gridRes.x + x;
-            }
-        }
-    }
-
-    // setup adjacency grid offset for the upper left grid cell of the grid search
-    int totalOffset = ((m_gridSearch*m_gridSearch)-1)/2;
-    int localX = totalOffset % m_gridSearch;
-    int localZ = totalOffset / m_gridSearch;
-    int globalX = localX;
-    int globalY = ((m_gridSearch-1)/2) * (m_gridRes.x * m_gridRes.z);
-    int globalZ = localZ * m_gridRes.x;
-    m_gridAdjOff = globalX + globalY + globalZ;
-
     /*
      * set grid data for gpu
      */
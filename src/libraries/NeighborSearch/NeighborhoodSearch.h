@@ -16,6 +16,7 @@
 #include "AssertData.h"
 #include "Utils/Logger.h"
 #include "NeighborhoodSearchDefines.h"
+#include "SearchGrid.h"
 //#include "../../executables/NeighborSearchTest/SimpleProtein.h"
 
 
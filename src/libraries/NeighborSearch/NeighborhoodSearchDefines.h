@@ -6,6 +6,7 @@
 #define OPENGL_FRAMEWORK_NEIGHBORHOODSEARCHDEFINES_H
 
 // project includes
+#include <GL/glew.h>
 #include <glm/glm.hpp>
 
 
@@ -73,6 +74,28 @@ struct Neighborhood {
     float      searchRadius;            // float    adjusted search radius
 };
 
+/*
+ * Result of the cpu neighborhood search. Same arrays and same usage as the
+ * gpu neighborhood above, just in main memory. The arrays are owned by the
+ * CPUNeighborhoodSearch object and stay valid until its next run or update.
+ * Elements outside of the grid are not sorted in, the sorted arrays are
+ * GRID_UNDEF from numberOfSortedElements on.
+ */
+struct CPUNeighborhood {
+    const glm::vec3* p_sortedPositions;         // vec3     particle positions after the counting sort
+    const uint*      p_particleOriginalIndex;   // uint     particles original index before the counting sort
+    const uint*      p_particleCell;            // uint     cell index the particle is in
+    const uint*      p_particleCellIndex;       // uint     insertion index of the particle inside the cell
+    const uint*      p_grid;                    // uint     index of the particle after sorting
+    const uint*      p_gridCellCounts;          // uint     number of particles that are in the respective cell
+    const uint*      p_gridCellOffsets;         // uint     total offset of the starting point of the respective cell
+    const int*       p_searchCellOffsets;       // int[]    stores the offsets for all cells that have to be searched
+    int              startCellOffset;           // int      offset of the cell with the lowest index within the search cells
+    int              numberOfSearchCells;       // int      number of cells within the search radius
+    float            searchRadius;              // float    adjusted search radius
+    uint             numberOfSortedElements;    // uint     number of particles that are inside the grid
+};
+
 struct Grid {
     glm::vec3  min;
     glm::vec3  delta;
@@ -0,0 +1,81 @@
+//============================================================================
+// Distributed under the MIT License. Author: Adrian Derstroff
+//============================================================================
+
+#include "SearchGrid.h"
+
+void SearchGrid::setup(glm::fvec3 gridMin, glm::fvec3 gridMax, glm::ivec3 resolution, float radius)
+{
+    // calculate grid parameters
+    min = gridMin;
+    max = gridMax;
+    size = gridMax;
+    size -= gridMin;
+    res = resolution;
+    glm::vec3 cellSizes = size;
+    cellSizes /= res;
+    cellSize = std::max(cellSizes.x, std::max(cellSizes.y, cellSizes.z));
+    size  = res; // update grid size to be a multiple of the cell size
+    size *= cellSize;
+    max = min + size;
+    delta = res;
+    delta /= size;
+    total = res.x * res.y * res.z;
+    searchRadius = radius;
+
+    // number of cells to search
+    /*
+     * n = (2r/w)+1,
+     * n: 1D cell search count
+     * r: search radius
+     * w: cell width
+     */
+    search = (int) 2*ceil(radius / cellSize) +1;
+    if (search < 3) search = 3;
+    adjCnt = search * search * search;
+    if (search > 5) {
+        Logger::instance().print("Warning: Neighbor search is n > 5, n is set to 5 instead", Logger::Mode::WARNING);
+        search = 5;
+    }
+    maxSearchRadius = 5/2 * cellSize;
+
+    // setup adjacency grid
+    int cell = 0;
+    for (int y = 0; y < search; y++) {
+        for (int z = 0; z < search; z++) {
+            for (int x = 0; x < search; x++) {
+                adj[cell++] = (y * res.z + z) * res.x + x;
+            }
+        }
+    }
+
+    // setup adjacency grid offset for the upper left grid cell of the grid search
+    int totalOffset = ((search*search)-1)/2;
+    int localX = totalOffset % search;
+    int localZ = totalOffset / search;
+    int globalX = localX;
+    int globalY = ((search-1)/2) * (res.x * res.z);
+    int globalZ = localZ * res.x;
+    adjOff = globalX + globalY + globalZ;
+}
+
+
+
+glm::ivec3 SearchGrid::cellCoordinates(const glm::vec3& position) const
+{
+    glm::vec3 gcf = (position - min) * delta;
+    return glm::ivec3((int)floor(gcf.x), (int)floor(gcf.y), (int)floor(gcf.z));
+}
+
+
+
+uint SearchGrid::cellIndex(const glm::vec3& position) const
+{
+    glm::ivec3 gc = cellCoordinates(position);
+    if (gc.x < 0 || gc.x >= res.x ||
+        gc.y < 0 || gc.y >= res.y ||
+        gc.z < 0 || gc.z >= res.z) {
+        return (uint)GRID_UNDEF;
+    }
+    return (uint)((gc.y * res.z + gc.z) * res.x + gc.x);
+}
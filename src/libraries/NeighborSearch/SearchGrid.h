@@ -0,0 +1,50 @@
+//============================================================================
+// Distributed under the MIT License. Author: Adrian Derstroff
+//============================================================================
+
+#ifndef OPENGL_FRAMEWORK_SEARCHGRID_H
+#define OPENGL_FRAMEWORK_SEARCHGRID_H
+
+#include <math.h>
+#include <algorithm>
+
+#include "Utils/Logger.h"
+#include "NeighborhoodSearchDefines.h"
+
+/*
+ * Parameters of the uniform grid that are shared by the gpu and the cpu
+ * neighborhood search, so both sort the elements into exactly the same cells
+ */
+struct SearchGrid {
+    glm::fvec3  min;
+    glm::fvec3  max;
+    glm::ivec3  res;                // 3D grid resolution
+    glm::fvec3  size;               // 3D grid sizes
+    glm::fvec3  delta;              // delta translate from world space to cell space
+    int         total;              // total number of cells in the grid
+    float       cellSize;
+    float       searchRadius;
+    float       maxSearchRadius;
+    int         search;             // 1D cell search count
+    int         adj[216];           // maximal size of the adjacency mask is 6x6x6
+    int         adjCnt;             // 3D search count =n^3 e.g. 2x2x2=8
+    int         adjOff;             // adjacency mask offset of the upper left cell
+
+    /*
+     * compute all grid parameters from the bounds, the resolution and the search radius
+     */
+    void setup(glm::fvec3 gridMin, glm::fvec3 gridMax, glm::ivec3 resolution, float radius);
+
+    /*
+     * 3D cell coordinates of a position, not clamped to the grid
+     */
+    glm::ivec3 cellCoordinates(const glm::vec3& position) const;
+
+    /*
+     * 1D index of the cell the position is in or GRID_UNDEF if it is outside the grid
+     */
+    uint cellIndex(const glm::vec3& position) const;
+};
+
+
+#endif //OPENGL_FRAMEWORK_SEARCHGRID_H
@@ -0,0 +1,209 @@
+//============================================================================
+// Distributed under the MIT License. Author: Adrian Derstroff
+//============================================================================
+
+#include "VerletList.h"
+
+#include <algorithm>
+
+VerletList::VerletList()
+{
+    m_numElements = 0;
+    m_cutoff = 0;
+    m_skin = 0;
+    m_valid = false;
+    m_maxDisplacement = 0;
+    m_numBuilds = 0;
+}
+
+
+/*
+ * Getter and setter
+ */
+float VerletList::getCutoff()
+{
+    return m_cutoff;
+}
+float VerletList::getSkin()
+{
+    return m_skin;
+}
+float VerletList::getMaxDisplacement()
+{
+    return m_maxDisplacement;
+}
+int VerletList::getNumberOfBuilds()
+{
+    return m_numBuilds;
+}
+uint VerletList::getNumberOfNeighbors(uint elementIdx)
+{
+    return m_neighborOffsets[elementIdx+1] - m_neighborOffsets[elementIdx];
+}
+const uint* VerletList::getNeighbors(uint elementIdx)
+{
+    return m_neighborIndices.data() + m_neighborOffsets[elementIdx];
+}
+const std::vector<uint>& VerletList::getNeighborOffsets()
+{
+    return m_neighborOffsets;
+}
+const std::vector<uint>& VerletList::getNeighborIndices()
+{
+    return m_neighborIndices;
+}
+CPUNeighborhoodSearch& VerletList::getNeighborhoodSearch()
+{
+    return m_search;
+}
+
+
+
+//-----------------------------------------------------//
+//                   INITIALIZATION                    //
+//-----------------------------------------------------//
+void VerletList::init(uint numElements, glm::fvec3 min, glm::fvec3 max, glm::ivec3 resolution, float cutoff, float skin, int numThreads)
+{
+    m_search.init(numElements, min, max, resolution, cutoff + skin, numThreads);
+    m_threadNeighbors.resize(m_search.getNumberOfThreads());
+    m_threadDisplacements.resize(m_search.getNumberOfThreads());
+    resetLists(numElements, cutoff, skin);
+}
+
+
+
+void VerletList::update(uint numElements, glm::fvec3 min, glm::fvec3 max, glm::ivec3 resolution, float cutoff, float skin)
+{
+    m_search.update(numElements, min, max, resolution, cutoff + skin);
+    resetLists(numElements, cutoff, skin);
+}
+
+
+
+void VerletList::resetLists(uint numElements, float cutoff, float skin)
+{
+    m_numElements = numElements;
+    m_cutoff = cutoff;
+    m_skin = skin;
+
+    // empty lists until the first run
+    m_referencePositions.assign(numElements, glm::vec3(0));
+    m_neighborOffsets.assign(numElements+1, 0);
+    m_neighborIndices.clear();
+    invalidate();
+}
+
+
+
+void VerletList::invalidate()
+{
+    m_valid = false;
+}
+
+
+
+
+
+
+//-----------------------------------------------------//
+//                    VERLET LIST                      //
+//-----------------------------------------------------//
+bool VerletList::run(const glm::vec3* positions)
+{
+    return runVerlet(positions);
+}
+bool VerletList::run(const glm::vec4* positions)
+{
+    return runVerlet(positions);
+}
+
+
+
+template<class T>
+bool VerletList::runVerlet(const T* positions)
+{
+    /*
+     * the lists contain every pair within the cutoff as long as
+     * no element moved further than half of the skin, since two
+     * elements can then approach each other by at most the skin
+     */
+    if (m_valid) {
+        m_maxDisplacement = computeMaxDisplacement(positions);
+        if (m_maxDisplacement <= 0.5f * m_skin) {
+            return false;
+        }
+    }
+
+    build(positions);
+    return true;
+}
+
+
+
+template<class T>
+float VerletList::computeMaxDisplacement(const T* positions)
+{
+    m_search.executeInRanges(m_numElements, [&](int threadIdx, int begin, int end) {
+        float maxDisplacement2 = 0;
+        for (int i = begin; i < end; i++) {
+            glm::vec3 d = glm::vec3(positions[i]) - m_referencePositions[i];
+            maxDisplacement2 = std::max(maxDisplacement2, d.x*d.x + d.y*d.y + d.z*d.z);
+        }
+        m_threadDisplacements[threadIdx] = maxDisplacement2;
+    });
+
+    float maxDisplacement2 = 0;
+    for (float displacement2 : m_threadDisplacements) {
+        maxDisplacement2 = std::max(maxDisplacement2, displacement2);
+    }
+    return sqrt(maxDisplacement2);
+}
+
+
+
+template<class T>
+void VerletList::build(const T* positions)
+{
+    /*
+     * sort the elements into the grid with cutoff + skin as search radius
+     */
+    m_search.run(positions, m_neighborhood);
+
+    /*
+     * every thread collects the neighbors of its range of elements
+     * and remembers the count per element for the offsets
+     */
+    m_search.executeInRanges(m_numElements, [&](int threadIdx, int begin, int end) {
+        std::vector<uint>& threadNeighbors = m_threadNeighbors[threadIdx];
+        threadNeighbors.clear();
+        std::vector<uint> found;
+        for (int i = begin; i < end; i++) {
+            m_referencePositions[i] = glm::vec3(positions[i]);
+            m_search.findNeighbors((uint)i, found);
+            m_neighborOffsets[i+1] = (uint)found.size();
+            threadNeighbors.insert(threadNeighbors.end(), found.begin(), found.end());
+        }
+    });
+
+    /*
+     * turn the counts into offsets
+     */
+    m_neighborOffsets[0] = 0;
+    for (int i = 0; i < m_numElements; i++) {
+        m_neighborOffsets[i+1] += m_neighborOffsets[i];
+    }
+    m_neighborIndices.resize(m_neighborOffsets[m_numElements]);
+
+    /*
+     * copy the neighbors of every thread to the offset of its first element,
+     * the ranges are the same as above
+     */
+    m_search.executeInRanges(m_numElements, [&](int threadIdx, int begin, int) {
+        const std::vector<uint>& threadNeighbors = m_threadNeighbors[threadIdx];
+        std::copy(threadNeighbors.begin(), threadNeighbors.end(), m_neighborIndices.begin() + m_neighborOffsets[begin]);
+    });
+
+    m_valid = true;
+    m_maxDisplacement = 0;
+    m_numBuilds++;
+}
@@ -0,0 +1,108 @@
+//============================================================================
+// Distributed under the MIT License. Author: Adrian Derstroff
+//============================================================================
+
+#ifndef OPENGL_FRAMEWORK_VERLETLIST_H
+#define OPENGL_FRAMEWORK_VERLETLIST_H
+
+#include <vector>
+
+#include "NeighborhoodSearchDefines.h"
+#include "CPUNeighborhoodSearch.h"
+
+/*
+ * Verlet neighbor lists built over the cpu neighborhood search grid.
+ * Every element lists all elements within cutoff + skin, so the lists
+ * stay complete as long as no element moved further than half the skin
+ * since the last build. Running the list on a new frame only measures the
+ * displacements and rebuilds if that limit is exceeded, which is rare for
+ * consecutive frames of a simulation.
+ *
+ * Usage:
+ * 1. run the list on the positions of the current frame
+ *      verletList.run(positions);
+ * 2. iterate over the candidates of element i, all given by their original index
+ *      const uint* neighbors = verletList.getNeighbors(i);
+ *      for (uint n = 0; n < verletList.getNumberOfNeighbors(i); n++)
+ *      {
+ *          uint j = neighbors[n];
+ *          ... (compare distance of i and j against the cutoff)
+ *      }
+ * Lists are full, so every pair appears in the lists of both elements.
+ */
+class VerletList {
+public:
+    VerletList();
+
+    /*
+     * Getter and setter
+     */
+    float getCutoff();
+    float getSkin();
+    float getMaxDisplacement();
+    int getNumberOfBuilds();
+    uint getNumberOfNeighbors(uint elementIdx);
+    const uint* getNeighbors(uint elementIdx);
+    const std::vector<uint>& getNeighborOffsets();
+    const std::vector<uint>& getNeighborIndices();
+    CPUNeighborhoodSearch& getNeighborhoodSearch();
+
+    /*
+     * verlet list, the grid has to contain the elements over all frames,
+     * elements outside of it at build time get no neighbors.
+     * Number of threads <= 0 uses all hardware threads
+     */
+    void init(uint numElements, glm::fvec3 min, glm::fvec3 max, glm::ivec3 resolution, float cutoff, float skin, int numThreads = 0);
+    void update(uint numElements, glm::fvec3 min, glm::fvec3 max, glm::ivec3 resolution, float cutoff, float skin);
+
+    /*
+     * bring the lists up to date for the given positions,
+     * returns whether they had to be rebuilt
+     */
+    bool run(const glm::vec3* positions);
+    bool run(const glm::vec4* positions);
+
+    /*
+     * force a rebuild on the next run, e.g. when jumping to an unrelated frame
+     */
+    void invalidate();
+
+
+private:
+    // parameters
+    CPUNeighborhoodSearch       m_search;
+    CPUNeighborhood             m_neighborhood;
+    int                         m_numElements;
+    float                       m_cutoff;
+    float                       m_skin;
+    bool                        m_valid;            // whether the lists were built for the current elements
+    float                       m_maxDisplacement;  // largest displacement since the last build
+    int                         m_numBuilds;
+
+    // lists
+    std::vector<glm::vec3>      m_referencePositions;   // positions at the last build
+    std::vector<uint>           m_neighborOffsets;      // numElements+1 offsets into the neighbor indices
+    std::vector<uint>           m_neighborIndices;      // original indices of the neighbors of all elements
+    std::vector<std::vector<uint> > m_threadNeighbors;  // neighbors found by every thread while building
+    std::vector<float>          m_threadDisplacements;  // largest squared displacement of every thread
+
+
+
+    /*
+     * init helper functions
+     */
+    void resetLists(uint numElements, float cutoff, float skin);
+
+    /*
+     * run helper functions
+     */
+    template<class T>
+    bool runVerlet(const T* positions);
+    template<class T>
+    float computeMaxDisplacement(const T* positions);
+    template<class T>
+    void build(const T* positions);
+};
+
+
+#endif //OPENGL_FRAMEWORK_VERLETLIST_H
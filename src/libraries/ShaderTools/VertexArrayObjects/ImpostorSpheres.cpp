@@ -57,14 +57,23 @@ void ImpostorSpheres::setProteinData(Protein *prot)
 void ImpostorSpheres::copyProteinData()
 {
     num_balls = prot->getAtoms()->size();
+
+    // look up color once per interned string, atoms index it with their element id
+    std::shared_ptr<const StringTable> strings = prot->getStrings();
+    AtomLUT::color other = AtomLUT::cpk_colorcode.find("other")->second;
+    std::vector<glm::vec4> colorOfId(strings->size(), glm::vec4(other.r, other.g, other.b, 1));
+    for( int id = 0; id < strings->size(); id++)
+    {
+        AtomLUT::colorMap::iterator it = AtomLUT::cpk_colorcode.find(strings->get(id));
+        if(it != AtomLUT::cpk_colorcode.end())
+            colorOfId[id] = glm::vec4(it->second.r,it->second.g,it->second.b,1);
+    }
+
+    const std::vector<Protein::AtomRecord>& atomTable = *(prot->getAtomTable());
     for( int i = 0; i < num_balls; i++)
     {
         Atom* a = prot->getAtomAt(i);
-        AtomLUT::colorMap::iterator it = AtomLUT::cpk_colorcode.find(a->getElement());
-        if(it != AtomLUT::cpk_colorcode.end())
-            instance_colors.push_back(glm::vec4(it->second.r,it->second.g,it->second.b,1));
-        else
-            instance_colors.push_back(glm::vec4(AtomLUT::cpk_colorcode.find("other")->second.r,AtomLUT::cpk_colorcode.find("other")->second.g,AtomLUT::cpk_colorcode.find("other")->second.b,1));
+        instance_colors.push_back(colorOfId[atomTable[i].element]);
 
         //instance_positions.push_back(glm::vec4(a->getPosition(),AtomLUT::vdW_radii_picometer.find(a->getElement())->second/100.0));
         instance_positions.push_back(glm::vec4(a->getPosition(),prot->getRadiusAt(i)));
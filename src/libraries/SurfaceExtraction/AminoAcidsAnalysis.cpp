@@ -0,0 +1,145 @@
+//============================================================================
+// Distributed under the MIT License. Author: Raphael Menges
+//============================================================================
+
+#include "AminoAcidsAnalysis.h"
+#include <thread>
+#include <functional>
+#include <algorithm>
+#include <cmath>
+
+// Gaussian kernel for smoothing of average layers delta
+const float gaussian[] = { 0.06136f, 0.24477f, 0.38774f, 0.24477f, 0.06136f };
+
+// Execute function on ranges [min, max[ of count in threads
+static void executeInRanges(int count, int threadCount, std::function<void(int, int)> function)
+{
+    threadCount = std::max(1, std::min(threadCount, count));
+    if(threadCount == 1)
+    {
+        function(0, count);
+        return;
+    }
+
+    // Launch threads
+    std::vector<std::thread> threads;
+    for(int i = 0; i < threadCount; i++)
+    {
+        threads.push_back(std::thread(function, (count * i) / threadCount, (count * (i + 1)) / threadCount));
+    }
+
+    // Join threads
+    for(auto& rThread : threads)
+    {
+        rThread.join();
+    }
+}
+
+void resetAminoAcidsAnalysis(
+    const std::vector<GPUProtein::AminoAcid>& rAminoAcids,
+    int frameCount,
+    std::vector<AminoAcidAnalysis>& rAnalysis)
+{
+    int aminoAcidCount = (int)rAminoAcids.size();
+    int deltaCount = std::max(0, frameCount - 1);
+
+    // Prepare result structure, minus one means no data
+    rAnalysis.clear();
+    rAnalysis.resize(aminoAcidCount);
+    for(int i = 0; i < aminoAcidCount; i++)
+    {
+        AminoAcidAnalysis& rCurrent = rAnalysis.at(i);
+        rCurrent.name = rAminoAcids.at(i).name;
+        rCurrent.startIndex = rAminoAcids.at(i).startIndex;
+        rCurrent.endIndex = rAminoAcids.at(i).endIndex;
+        rCurrent.averageLayers.resize(frameCount, -1.f);
+        rCurrent.inverseAverageLayers.resize(frameCount, -1.f);
+        rCurrent.averageLayersDelta.resize(deltaCount, -1.f);
+        rCurrent.inverseAverageLayersDelta.resize(deltaCount, -1.f);
+    }
+}
+
+void accumulateAminoAcidsLayers(
+    const std::vector<int>& rLayersOfAtoms,
+    int layerCount,
+    int frame,
+    std::vector<AminoAcidAnalysis>& rAnalysis)
+{
+    // Skip frames without extracted layers
+    if(rLayersOfAtoms.empty()) { return; }
+    int maxLayer = layerCount - 1;
+
+    // One pass over the atoms of all amino acids
+    for(AminoAcidAnalysis& rCurrent : rAnalysis)
+    {
+        int sum = 0;
+        for(int atomIndex = rCurrent.startIndex; atomIndex <= rCurrent.endIndex; atomIndex++)
+        {
+            sum += rLayersOfAtoms[atomIndex];
+        }
+        int atomCount = (rCurrent.endIndex - rCurrent.startIndex) + 1;
+
+        // Inverse layer of each atom is maximal layer minus its layer
+        rCurrent.averageLayers.at(frame) = (float)sum / (float)atomCount;
+        rCurrent.inverseAverageLayers.at(frame) = (float)(maxLayer * atomCount - sum) / (float)atomCount;
+    }
+}
+
+void finishAminoAcidsAnalysis(
+    std::vector<AminoAcidAnalysis>& rAnalysis,
+    std::vector<float>& rSmoothedAverageLayersDelta,
+    int threadCount)
+{
+    int aminoAcidCount = (int)rAnalysis.size();
+    int frameCount = rAnalysis.empty() ? 0 : (int)rAnalysis.front().averageLayers.size();
+    int deltaCount = std::max(0, frameCount - 1);
+    if(threadCount <= 0) { threadCount = std::max(1, (int)std::thread::hardware_concurrency()); }
+
+    // Prepare buffer for residue surface proximity rendering
+    rSmoothedAverageLayersDelta.clear();
+    rSmoothedAverageLayersDelta.resize(aminoAcidCount * frameCount, 0.f);
+
+    // Deltas, their accumulation and smoothing, parallel over amino acids
+    executeInRanges(aminoAcidCount, threadCount, [&](int minAminoAcid, int maxAminoAcid)
+    {
+        for(int i = minAminoAcid; i < maxAminoAcid; i++)
+        {
+            AminoAcidAnalysis& rCurrent = rAnalysis.at(i);
+
+            // Average layers delta accumulation (skip pairs where any value is not ok)
+            rCurrent.averageLayersDeltaAccumulation = 0.f;
+            rCurrent.inverseAverageLayersDeltaAccumulation = 0.f;
+            for(int j = 0; j < deltaCount; j++)
+            {
+                if(rCurrent.averageLayers[j] >= 0 && rCurrent.averageLayers[j + 1] >= 0)
+                {
+                    float delta = std::abs(rCurrent.averageLayers[j + 1] - rCurrent.averageLayers[j]);
+                    rCurrent.averageLayersDelta[j] = delta;
+                    rCurrent.averageLayersDeltaAccumulation += delta;
+                }
+                if(rCurrent.inverseAverageLayers[j] >= 0 && rCurrent.inverseAverageLayers[j + 1] >= 0)
+                {
+                    float delta = std::abs(rCurrent.inverseAverageLayers[j + 1] - rCurrent.inverseAverageLayers[j]);
+                    rCurrent.inverseAverageLayersDelta[j] = delta;
+                    rCurrent.inverseAverageLayersDeltaAccumulation += delta;
+                }
+            }
+
+            // Smooth delta (hardcoded for given gaussian kernel, deltas without data are left out)
+            for(int j = 0; j < deltaCount; j++)
+            {
+                float value = 0;
+                for(int k = -2; k <= 2; k++)
+                {
+                    int index = j + k;
+                    if(index < 0 || index >= deltaCount || rCurrent.averageLayersDelta[index] < 0)
+                    {
+                        continue;
+                    }
+                    value += rCurrent.averageLayersDelta[index] * gaussian[k + 2];
+                }
+                rSmoothedAverageLayersDelta[(i * frameCount) + j + 1] = value; // add one because at first frame no delta available
+            }
+        }
+    });
+}
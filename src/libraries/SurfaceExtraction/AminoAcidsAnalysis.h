@@ -0,0 +1,48 @@
+//============================================================================
+// Distributed under the MIT License. Author: Raphael Menges
+//============================================================================
+
+// Analysis of layers of amino acids over computed frames.
+
+#ifndef AMINO_ACIDS_ANALYSIS_H
+#define AMINO_ACIDS_ANALYSIS_H
+
+#include "SurfaceExtraction/GPUProtein.h"
+#include <string>
+#include <vector>
+
+// Result of analysis for one amino acid. Values of minus one mean no data
+struct AminoAcidAnalysis
+{
+    std::string name = "";
+    int startIndex = -1;
+    int endIndex = -1;
+    float averageLayersDeltaAccumulation = -1;
+    float inverseAverageLayersDeltaAccumulation = -1;
+    std::vector<float> averageLayers;
+    std::vector<float> inverseAverageLayers;
+    std::vector<float> averageLayersDelta;
+    std::vector<float> inverseAverageLayersDelta;
+};
+
+// Prepare analysis of amino acids for count of frames. All values are set to no data
+void resetAminoAcidsAnalysis(
+    const std::vector<GPUProtein::AminoAcid>& rAminoAcids,
+    int frameCount,
+    std::vector<AminoAcidAnalysis>& rAnalysis);
+
+// Accumulate layers of atoms of one frame per amino acid. Frame is relative to first analysed frame
+void accumulateAminoAcidsLayers(
+    const std::vector<int>& rLayersOfAtoms,
+    int layerCount,
+    int frame,
+    std::vector<AminoAcidAnalysis>& rAnalysis);
+
+// Compute deltas of accumulated layers. Smoothed average layers delta has count of frames many entries
+// per amino acid, where first one is zero. Thread count of zero means hardware concurrency
+void finishAminoAcidsAnalysis(
+    std::vector<AminoAcidAnalysis>& rAnalysis,
+    std::vector<float>& rSmoothedAverageLayersDelta,
+    int threadCount = 0);
+
+#endif // AMINO_ACIDS_ANALYSIS_H
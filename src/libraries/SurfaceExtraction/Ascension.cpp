@@ -0,0 +1,193 @@
+//============================================================================
+// Distributed under the MIT License. Author: Raphael Menges
+//============================================================================
+
+#include "Ascension.h"
+#include "SurfaceExtraction/GPUSurface.h"
+#include <glm/glm.hpp>
+#include <glm/gtc/constants.hpp>
+#include <thread>
+
+// Below this count of atom frame pairs, threads are not worth their creation
+const int minParallelWorkload = 65536;
+
+Ascension::Ascension(int atomCount, int threadCount)
+{
+    mAtomCount = atomCount;
+    mThreadCount = threadCount > 0 ? threadCount : glm::max(1, (int)std::thread::hardware_concurrency());
+    mWordsPerFrame = (atomCount + 31) / 32;
+    setFrameCounts(100.f, 100.f, 100.f, 100.f);
+}
+
+Ascension::~Ascension()
+{
+    // Nothing to do
+}
+
+void Ascension::setFrameCounts(
+    float upToHotFrameCount,
+    float downToHotFrameCount,
+    float upToColdFrameCount,
+    float downToColdFrameCount)
+{
+    float pi = glm::pi<float>();
+    mUpToHot = pi / upToHotFrameCount;
+    mDownToHot = pi / downToHotFrameCount;
+    mUpToCold = pi / upToColdFrameCount;
+    mDownToCold = pi / downToColdFrameCount;
+}
+
+void Ascension::clear()
+{
+    mFrameCount = 0;
+    mComputedFrameCount = 0;
+    mSurfaceBits.clear();
+    mValues.clear();
+}
+
+void Ascension::appendFrame(GPUSurface const * pGPUSurface)
+{
+    appendFrame(pGPUSurface->getSurfaceIndices(0));
+}
+
+void Ascension::appendFrame(const std::vector<GLuint>& rSurfaceIndices)
+{
+    // Set bits of surface atoms
+    mSurfaceBits.resize((mFrameCount + 1) * mWordsPerFrame, 0);
+    GLuint* pBits = mSurfaceBits.data() + (mFrameCount * mWordsPerFrame);
+    for(GLuint index : rSurfaceIndices)
+    {
+        pBits[index / 32] |= (1u << (index % 32));
+    }
+    mFrameCount++;
+}
+
+void Ascension::recompute()
+{
+    computeValues(0);
+}
+
+const std::vector<float>& Ascension::getValues()
+{
+    // Compute values of frames appended since last call at once
+    if(mComputedFrameCount < mFrameCount)
+    {
+        computeValues(mComputedFrameCount);
+    }
+    return mValues;
+}
+
+void Ascension::computeValues(int startFrame)
+{
+    mValues.resize(mFrameCount * mAtomCount);
+    mComputedFrameCount = mFrameCount;
+    if(startFrame >= mFrameCount) { return; }
+
+    // Each atom is independent from the others, only its previous frame is necessary
+    auto compute = [this, startFrame](int minAtom, int maxAtom)
+    {
+        float pi = glm::pi<float>();
+        for(int frame = startFrame; frame < mFrameCount; frame++)
+        {
+            const GLuint* pBits = mSurfaceBits.data() + (frame * mWordsPerFrame);
+            float* pValues = mValues.data() + (frame * mAtomCount);
+            const float* pPreviousValues = pValues - mAtomCount;
+            for(int a = minAtom; a < maxAtom; a++)
+            {
+                bool surface = (pBits[a / 32] >> (a % 32)) & 1u;
+
+                // Value which will be filled
+                float value = 0;
+
+                // Check for first frame
+                if(frame == 0)
+                {
+                    // Value for first frame of ascension (either at surface or not)
+                    value = surface ? pi : 0.f;
+                }
+                else
+                {
+                    // Fetch value of previous frame for this atom
+                    float previousValue = pPreviousValues[a];
+
+                    // Decide what to happen with ascension value
+                    if(surface) // surface
+                    {
+                        // Decide whether increase or decrease
+                        if(previousValue == pi)
+                        {
+                            // Already hot, stay that way
+                            value = pi;
+                        }
+                        else if(previousValue < pi)
+                        {
+                            // Getting hotter, coming from cold
+                            value = glm::min(pi, previousValue + mUpToHot);
+                        }
+                        else
+                        {
+                            // Getting hotter again, was already on its way to becoming cold
+                            value = glm::max(pi, previousValue - mDownToHot);
+                        }
+                    }
+                    else // internal
+                    {
+                        // Decide whether increase or decrease
+                        if(previousValue == 0)
+                        {
+                            // Already cold, stay that way
+                            value = 0.f;
+                        }
+                        else if(previousValue < pi)
+                        {
+                            // A throwback on the way of getting hot
+                            value = glm::max(0.f, previousValue - mDownToCold);
+                        }
+                        else
+                        {
+                            // Was hot and getting cold again
+                            value = glm::mod(
+                                        glm::min(
+                                            2.f * pi,
+                                            previousValue + mUpToCold),
+                                        2.f * pi);
+                        }
+                    }
+                }
+
+                // Save calculated value for that atom on that frame
+                pValues[a] = value;
+            }
+        }
+    };
+
+    // Decide about count of threads
+    int threadCount = mThreadCount;
+    if((mFrameCount - startFrame) * mAtomCount < minParallelWorkload) { threadCount = 1; }
+
+    if(threadCount == 1)
+    {
+        compute(0, mAtomCount);
+    }
+    else
+    {
+        // Launch threads on ranges of atoms which are aligned to bitset words
+        std::vector<std::thread> threads;
+        int wordsPerThread = (mWordsPerFrame + threadCount - 1) / threadCount;
+        for(int i = 0; i < threadCount; i++)
+        {
+            int minAtom = glm::min(mAtomCount, i * wordsPerThread * 32);
+            int maxAtom = glm::min(mAtomCount, (i + 1) * wordsPerThread * 32);
+            if(minAtom < maxAtom)
+            {
+                threads.push_back(std::thread(compute, minAtom, maxAtom));
+            }
+        }
+
+        // Join threads
+        for(auto& rThread : threads)
+        {
+            rThread.join();
+        }
+    }
+}
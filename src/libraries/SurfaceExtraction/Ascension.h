@@ -0,0 +1,85 @@
+//============================================================================
+// Distributed under the MIT License. Author: Raphael Menges
+//============================================================================
+
+// Ascension of atoms, computed from per frame surface bitsets. Frames can be appended incrementally
+// and their values are computed in one batch when fetched.
+
+#ifndef ASCENSION_H
+#define ASCENSION_H
+
+#include <GL/glew.h>
+#include <vector>
+
+// Forward declaration
+class GPUSurface;
+
+class Ascension
+{
+public:
+
+    // Constructor. Thread count of zero means hardware concurrency
+    Ascension(int atomCount, int threadCount = 0);
+
+    // Destructor
+    virtual ~Ascension();
+
+    // Set count of frames for the transitions. Only affects values of frames appended afterwards, call recompute to update all
+    void setFrameCounts(
+        float upToHotFrameCount,
+        float downToHotFrameCount,
+        float upToColdFrameCount,
+        float downToColdFrameCount);
+
+    // Remove all frames
+    void clear();
+
+    // Append frame by its surface. Reads surface indices of layer zero once from GPU
+    void appendFrame(GPUSurface const * pGPUSurface);
+
+    // Append frame by its surface indices. Values are computed for all pending frames at once when fetched
+    void appendFrame(const std::vector<GLuint>& rSurfaceIndices);
+
+    // Recompute values of all frames from stored surface bitsets (e.g. after changing frame counts)
+    void recompute();
+
+    // Get linear ascension values for all frames and all atoms. Values have range [0..2Pi]
+    const std::vector<float>& getValues();
+
+    // Get count of appended frames
+    int getFrameCount() const { return mFrameCount; }
+
+private:
+
+    // Compute values of frames starting at given frame. Parallel over atoms
+    void computeValues(int startFrame);
+
+    // Count of atoms
+    int mAtomCount;
+
+    // Count of threads used for computation
+    int mThreadCount;
+
+    // Count of unsigned integers necessary for bitset of one frame
+    int mWordsPerFrame;
+
+    // Count of appended frames
+    int mFrameCount = 0;
+
+    // Count of frames with computed values
+    int mComputedFrameCount = 0;
+
+    // Surface bitsets of all frames, frame-major
+    std::vector<GLuint> mSurfaceBits;
+
+    // Ascension values of all frames, frame-major
+    std::vector<float> mValues;
+
+    // Steps for each frame
+    float mUpToHot;
+    float mDownToHot;
+    float mUpToCold;
+    float mDownToCold;
+};
+
+#endif // ASCENSION_H
@@ -32,19 +32,36 @@ public:
     // Fill
     void fill(const std::vector<T>& rData, GLenum access)
     {
-        mSize = rData.size();
+        fill(rData.data(), rData.size(), access);
+    }
+
+    // Fill with size many elements from memory. Without data, buffer is only allocated
+    void fill(const T* pData, int size, GLenum access)
+    {
+        mSize = size;
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, mBuffer);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(T) * mSize, size > 0 ? pData : 0, access);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    }
+
+    // Update part of already filled buffer, starting at given element
+    void update(const std::vector<T>& rData, int offset = 0)
+    {
+        update(rData.data(), rData.size(), offset);
+    }
+
+    // Update part of already filled buffer with size many elements from memory, starting at given element
+    void update(const T* pData, int size, int offset = 0)
+    {
+        if(size <= 0) { return; }
         glBindBuffer(GL_SHADER_STORAGE_BUFFER, mBuffer);
-        if(!rData.empty())
-        {
-            glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(rData.at(0)) * mSize, rData.data(), access);
-        }
-        else
-        {
-            glBufferData(GL_SHADER_STORAGE_BUFFER, 0, 0, access);
-        }
+        glBufferSubData(GL_SHADER_STORAGE_BUFFER, sizeof(T) * offset, sizeof(T) * size, pData);
         glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
     }
 
+    // Get count of elements in buffer
+    int getSize() const { return mSize; }
+
     // Bind
     void bind(GLuint slot) const
     {
@@ -69,7 +86,7 @@ private:
     GLuint mBuffer;
 
     // Size of buffer
-    int mSize;
+    int mSize = 0;
 };
 
 #endif // GPU_BUFFER_H
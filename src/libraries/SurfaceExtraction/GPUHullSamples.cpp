@@ -113,6 +113,7 @@ void GPUHullSamples::compute(
 
         // Update values
         mupComputeProgram->update("frame", i + mStartFrame); // frame in global terms
+        mupComputeProgram->update("trajectoryWindowStart", mpGPUProtein->updateWindow(i + mStartFrame, i + mStartFrame));
         mupComputeProgram->update("localFrame", i);
         mupComputeProgram->update("inputAtomCount", pGPUSurfaces->at(i)->getCountOfSurfaceAtoms(0)); // count of input atoms
 
@@ -175,6 +176,7 @@ void GPUHullSamples::drawSamples(
         mupShaderProgram->update("clippingPlane", clippingPlane);
         mupShaderProgram->update("sampleCount", mSampleCount);
         mupShaderProgram->update("frame", frame),
+        mupShaderProgram->update("trajectoryWindowStart", mpGPUProtein->updateWindow(frame, frame));
         mupShaderProgram->update("atomCount", mAtomCount);
         mupShaderProgram->update("integerCountPerSample", mIntegerCountPerSample);
         mupShaderProgram->update("localFrame", frame - mStartFrame);
@@ -231,6 +233,24 @@ int GPUHullSamples::getSurfaceSampleCount(int frame, GLuint atomIndex) const
     return getSurfaceSampleCount(frame, atomSet);
 }
 
+std::vector<int> GPUHullSamples::getSurfaceSampleCounts(GLuint atomIndex) const
+{
+    // Result
+    std::vector<int> surfaceSampleCounts(mLocalFrameCount, 0);
+
+    // Go over samples of that atom and read the bits of all frames
+    for(int j = 0; j < mSampleCount; j++)
+    {
+        int offset = (atomIndex * mSampleCount * mIntegerCountPerSample) + (j * mIntegerCountPerSample);
+        for(int localFrame = 0; localFrame < mLocalFrameCount; localFrame++)
+        {
+            surfaceSampleCounts[localFrame] += (mClassification.at(offset + (localFrame / 32)) >> (localFrame % 32)) & 1;
+        }
+    }
+
+    return surfaceSampleCounts;
+}
+
 int GPUHullSamples::getSurfaceSampleCount(int frame) const
 {
     return mSurfaceSampleCount.at(frame - mStartFrame);
@@ -63,6 +63,9 @@ public:
     // Get count of surface samples of one atom
     int getSurfaceSampleCount(int frame, GLuint atomIndex) const;
 
+    // Get count of surface samples of one atom for all processed frames
+    std::vector<int> getSurfaceSampleCounts(GLuint atomIndex) const;
+
     // Get count of surface samples in one specific frame
     int getSurfaceSampleCount(int frame) const;
 
@@ -5,82 +5,211 @@
 #include "GPUProtein.h"
 #include "Molecule/MDtrajLoader/Data/Protein.h"
 #include "Molecule/MDtrajLoader/Data/AtomLUT.h"
+#include "Molecule/NativeLoader/FrameCache.h"
+#include "Molecule/NativeLoader/TrajectoryProvider.h"
+#include "Utils/Logger.h"
+#include <algorithm>
+#include <cstdint>
 
 // TODO: Testing
 #include <iostream>
 
-GPUProtein::GPUProtein(Protein * const pProtein)
+// Provider which gives frames of other provider with atoms in order of GPU protein
+class OrderedTrajectoryProvider : public TrajectoryProvider
 {
-    // Create structures for CPU
-    int atomCount  = pProtein->getAtoms()->size();
-    int frameCount = pProtein->getAtomAt(0)->getCountOfFrames(); // TODO: what if no atoms in protein?
-    mspRadii = std::shared_ptr<std::vector<float> >(new std::vector<float>);
-    mspRadii->reserve(atomCount);
+public:
 
-    // Already size trajectory vector
-    mspTrajectory = std::shared_ptr<
-            std::vector<
-                std::vector<glm::vec3> > >(
-                    new std::vector<std::vector<glm::vec3> >);
-    mspTrajectory->resize(frameCount);
-    for(int i = 0; i < frameCount; i++)
+    OrderedTrajectoryProvider(std::shared_ptr<const TrajectoryProvider> spProvider, const std::vector<int>& rOriginalIndices)
+        : mspProvider(spProvider), mOriginalIndices(rOriginalIndices) {}
+    int getAtomCount() const { return mspProvider->getAtomCount(); }
+    int getFrameCount() const { return mspProvider->getFrameCount(); }
+    bool readFrame(int frame, glm::vec3* pPositions) const
     {
-        mspTrajectory->at(i).resize(atomCount);
+        // Read frame in order of provider, then gather atoms
+        static thread_local std::vector<glm::vec3> positions;
+        positions.resize(mspProvider->getAtomCount());
+        if(!mspProvider->readFrame(frame, positions.data())) { return false; }
+        for(int i = 0; i < (int)mOriginalIndices.size(); i++)
+        {
+            pPositions[i] = positions[mOriginalIndices[i]];
+        }
+        return true;
     }
 
+private:
+
+    std::shared_ptr<const TrajectoryProvider> mspProvider;
+    std::vector<int> mOriginalIndices;
+};
+
+// Spread lower ten bits of value, so there are two zero bits between each of them
+static uint32_t spreadBits(uint32_t value)
+{
+    value &= 0x3ff;
+    value = (value | (value << 16)) & 0x030000ff;
+    value = (value | (value << 8)) & 0x0300f00f;
+    value = (value | (value << 4)) & 0x030c30c3;
+    value = (value | (value << 2)) & 0x09249249;
+    return value;
+}
+
+GPUProtein::GPUProtein(Protein * const pProtein, AtomOrder atomOrder)
+{
+    // Create structures for CPU. Trajectory is shared with protein and only copied when atoms are reordered
+    initFromProtein(pProtein, atomOrder);
+    mspTrajectory = orderTrajectory(pProtein);
+    int atomCount  = pProtein->getAtoms()->size();
+    int frameCount = mspTrajectory->getFrameCount();
+    mFrameCount = frameCount;
+
     // Reserve space in other vectors (which are all assumed to be empty)
     mCentersOfMass.reserve(frameCount);
-    mElementNames.reserve(atomCount);
-    mAminoAcidsNames.reserve(atomCount);
 
-    // Fill radii, elements and aminoacids on CPU
-    mMinCoordinates = glm::vec3(
-        std::numeric_limits<float>::max(),
-        std::numeric_limits<float>::max(),
-        std::numeric_limits<float>::max());
-    mMaxCoordinates = glm::vec3(
-        std::numeric_limits<float>::min(),
-        std::numeric_limits<float>::min(),
-        std::numeric_limits<float>::min());
-    for(int i = 0; i < atomCount; i++) // go over atoms
+    // Compute centers on CPU
+    for(int i = 0; i < frameCount; i++) // go over frames
     {
-        // Collect radius
-        mspRadii->push_back(pProtein->getRadiusAt(i));
+        glm::vec3 accPosition(0, 0, 0);
+        for(const glm::vec3& rPosition : mspTrajectory->getFrame(i)) // go over atoms
+        {
+            // Accumulate position
+            accPosition += rPosition;
+        }
 
-        // Element
-        mElementNames.push_back(pProtein->getAtomAt(i)->getElement());
+        // Save center
+        mCentersOfMass.push_back(accPosition / (float)atomCount);
+    }
+    mCentersOfMassComputed.resize(frameCount, true);
 
-        // Aminoacid
-        mAminoAcidsNames.push_back(pProtein->getAtomAt(i)->getAmino());
+    // Init SSBOs
+    mDecodedFrameCount = frameCount;
+    mAvailableFrameCount = frameCount;
+    initSSBOs(atomCount, frameCount);
+}
+
+GPUProtein::GPUProtein(
+    Protein * const pProtein,
+    std::shared_ptr<const TrajectoryProvider> spTrajectoryProvider,
+    int cachedFrameCount,
+    int windowFrameCount,
+    AtomOrder atomOrder)
+{
+    // Create structures for CPU. First frame is kept in memory, shared with protein unless atoms are reordered
+    initFromProtein(pProtein, atomOrder);
+    mspTrajectory = orderTrajectory(pProtein);
+    int atomCount  = pProtein->getAtoms()->size();
+
+    // Further frames are read through cache
+    mFrameCount = 1;
+    if(spTrajectoryProvider->getAtomCount() == atomCount)
+    {
+        mupFrameCache = std::unique_ptr<FrameCache>(new FrameCache(orderProvider(spTrajectoryProvider), cachedFrameCount));
+        mFrameCount += spTrajectoryProvider->getFrameCount();
+    }
+    else
+    {
+        Logger::instance().print("Atom count of trajectory does not fit to protein, only first frame is used", Logger::Mode::ERROR);
+    }
+
+    // Centers of mass are computed when requested
+    mCentersOfMass.resize(mFrameCount);
+    mCentersOfMassComputed.resize(mFrameCount, false);
+
+    // Init SSBOs with window at first frame
+    mDecodedFrameCount = mFrameCount;
+    mAvailableFrameCount = mFrameCount;
+    mWindowFrameCount = glm::max(1, windowFrameCount);
+    initSSBOs(atomCount, mFrameCount);
+    updateWindow(0, 0);
+}
 
-        // Update min / max coordinate values
-        glm::vec3 position = pProtein->getAtomAt(i)->getPosition();
-        mMinCoordinates.x = mMinCoordinates.x > position.x ? position.x : mMinCoordinates.x;
-        mMinCoordinates.y = mMinCoordinates.y > position.y ? position.y : mMinCoordinates.y;
-        mMinCoordinates.z = mMinCoordinates.z > position.z ? position.z : mMinCoordinates.z;
-        mMaxCoordinates.x = mMaxCoordinates.x < position.x ? position.x : mMaxCoordinates.x;
-        mMaxCoordinates.y = mMaxCoordinates.y < position.y ? position.y : mMaxCoordinates.y;
-        mMaxCoordinates.z = mMaxCoordinates.z < position.z ? position.z : mMaxCoordinates.z;
+GPUProtein::GPUProtein(
+    Protein * const pProtein,
+    std::shared_ptr<const TrajectoryProvider> spTrajectoryProvider,
+    AtomOrder atomOrder)
+{
+    // Create structures for CPU. Frames of protein are available at once
+    initFromProtein(pProtein, atomOrder);
+    std::shared_ptr<Trajectory> spTrajectory = orderTrajectory(pProtein);
+    mspTrajectory = spTrajectory;
+    int atomCount  = pProtein->getAtoms()->size();
+    int proteinFrameCount = spTrajectory->getFrameCount();
+
+    // Memory of all frames is allocated up front, so frames never move while background thread fills them
+    mFrameCount = proteinFrameCount;
+    if(spTrajectoryProvider->getAtomCount() == atomCount)
+    {
+        spTrajectoryProvider = orderProvider(spTrajectoryProvider);
+        spTrajectory->addFrames(spTrajectoryProvider->getFrameCount());
+        mFrameCount += spTrajectoryProvider->getFrameCount();
+    }
+    else
+    {
+        Logger::instance().print("Atom count of trajectory does not fit to protein, only frames of protein are used", Logger::Mode::ERROR);
     }
 
-    // Fill trajectory on CPU
-    for(int i = 0; i < frameCount; i++) // go over frames
+    // Centers of mass are computed when requested
+    mCentersOfMass.resize(mFrameCount);
+    mCentersOfMassComputed.resize(mFrameCount, false);
+
+    // Init SSBOs, which only get frames of protein for now
+    mDecodedFrameCount = proteinFrameCount;
+    mAvailableFrameCount = proteinFrameCount;
+    initSSBOs(atomCount, mFrameCount);
+
+    // Decode further frames on background thread. Each frame is published by increasing the count of decoded frames
+    if(mFrameCount > proteinFrameCount)
     {
-        glm::vec3 accPosition(0, 0, 0);
-        for(int j = 0; j < atomCount; j++) // go over atoms
+        mLoading = true;
+        mLoadingThread = std::thread([this, spTrajectory, spTrajectoryProvider, proteinFrameCount]()
         {
-            // Position of that atom in that frame
-            glm::vec3 position = pProtein->getAtoms()->at(j)->getPositionAtFrame(i);
+            for(int i = 0; i < spTrajectoryProvider->getFrameCount() && !mStopLoading; i++)
+            {
+                if(!spTrajectoryProvider->readFrame(i, spTrajectory->getFrameData(proteinFrameCount + i)))
+                {
+                    Logger::instance().print("Could not load frame " + std::to_string(i) + " of trajectory, further frames are skipped", Logger::Mode::ERROR);
+                    break;
+                }
+                mDecodedFrameCount.store(proteinFrameCount + i + 1, std::memory_order_release);
+            }
+            mLoading = false;
+        });
+    }
+}
 
-            // Collect trajectory (already correctly sized)
-            mspTrajectory->at(i).at(j) = position;
+void GPUProtein::initFromProtein(Protein * const pProtein, AtomOrder atomOrder)
+{
+    // Create structures for CPU
+    int atomCount  = pProtein->getAtoms()->size();
+    mspRadii = std::shared_ptr<std::vector<float> >(new std::vector<float>);
+    mspRadii->reserve(atomCount);
 
-            // Accumulate position
-            accPosition += position;
-        }
+    // Reserve space in other vectors (which are all assumed to be empty)
+    mElementIds.reserve(atomCount);
+    mAminoAcidIds.reserve(atomCount);
 
-        // Save center
-        mCentersOfMass.push_back(accPosition / atomCount);
+    // Elements and amino acids are ids into string table shared with protein
+    mspStrings = pProtein->getStrings();
+    const std::vector<Protein::AtomRecord>& rAtomTable = *(pProtein->getAtomTable());
+
+    // Update min / max coordinate values, going over each coordinate of the first frame at once
+    mMinCoordinates = glm::vec3(
+        std::numeric_limits<float>::max(),
+        std::numeric_limits<float>::max(),
+        std::numeric_limits<float>::max());
+    mMaxCoordinates = glm::vec3(
+        std::numeric_limits<float>::min(),
+        std::numeric_limits<float>::min(),
+        std::numeric_limits<float>::min());
+    Trajectory::FrameSpan firstFrame = pProtein->getTrajectory()->getFrame(0);
+    for(int component = 0; component < 3; component++)
+    {
+        Trajectory::ComponentView coordinates = firstFrame.getComponent(component);
+        for(int i = 0; i < coordinates.size(); i++)
+        {
+            float value = coordinates[i];
+            mMinCoordinates[component] = mMinCoordinates[component] > value ? value : mMinCoordinates[component];
+            mMaxCoordinates[component] = mMaxCoordinates[component] < value ? value : mMaxCoordinates[component];
+        }
     }
 
     // Extract amino acids (here should be const pointers :( )
@@ -102,8 +231,124 @@ GPUProtein::GPUProtein(Protein * const pProtein)
         mAminoAcids.push_back(AminoAcid(name, minIndex, maxIndex));
     }
 
-    // Init SSBOs
-    initSSBOs(atomCount, frameCount);
+    // Order atoms, which also moves ranges of amino acids
+    initAtomOrder(atomOrder, firstFrame);
+
+    // Fill radii, elements and aminoacids on CPU in order of atoms
+    for(int i = 0; i < atomCount; i++) // go over atoms
+    {
+        int originalIndex = mOriginalIndices[i];
+
+        // Collect radius
+        mspRadii->push_back(pProtein->getRadiusAt(originalIndex));
+
+        // Element
+        mElementIds.push_back(rAtomTable.at(originalIndex).element);
+
+        // Aminoacid
+        mAminoAcidIds.push_back(rAtomTable.at(originalIndex).amino);
+    }
+}
+
+void GPUProtein::initAtomOrder(AtomOrder atomOrder, const Trajectory::FrameSpan& rPositions)
+{
+    // Start with order of file
+    int atomCount = rPositions.size();
+    mAtomOrder = AtomOrder::ORIGINAL;
+    mOriginalIndices.resize(atomCount);
+    for(int i = 0; i < atomCount; i++) { mOriginalIndices[i] = i; }
+    mInternalIndices = mOriginalIndices;
+    if(atomOrder == AtomOrder::ORIGINAL || atomCount == 0) { return; }
+
+    // Residues are runs of atoms belonging to the same amino acid, atoms without amino acid are runs on their own
+    std::vector<int> aminoAcidOfAtom(atomCount, -1);
+    for(int i = 0; i < (int)mAminoAcids.size(); i++)
+    {
+        for(int j = mAminoAcids[i].startIndex; j <= mAminoAcids[i].endIndex; j++) { aminoAcidOfAtom[j] = i; }
+    }
+    std::vector<int> runStarts;
+    for(int i = 0; i < atomCount; i++)
+    {
+        if(i == 0 || aminoAcidOfAtom[i] < 0 || aminoAcidOfAtom[i] != aminoAcidOfAtom[i - 1]) { runStarts.push_back(i); }
+    }
+    runStarts.push_back(atomCount);
+
+    // Z-order code of center of each run, quantized to ten bits per axis within bounding box
+    int runCount = (int)runStarts.size() - 1;
+    glm::vec3 extent = glm::max(mMaxCoordinates - mMinCoordinates, glm::vec3(0.0001f));
+    std::vector<std::pair<uint32_t, int> > runCodes(runCount);
+    for(int run = 0; run < runCount; run++)
+    {
+        glm::vec3 center(0, 0, 0);
+        for(int i = runStarts[run]; i < runStarts[run + 1]; i++) { center += rPositions[i]; }
+        center /= (float)(runStarts[run + 1] - runStarts[run]);
+        glm::vec3 cell = glm::clamp((center - mMinCoordinates) / extent, glm::vec3(0.f), glm::vec3(1.f)) * 1023.f;
+        uint32_t code = spreadBits((uint32_t)cell.x) | (spreadBits((uint32_t)cell.y) << 1) | (spreadBits((uint32_t)cell.z) << 2);
+        runCodes[run] = std::make_pair(code, run);
+    }
+
+    // Runs along the curve, runs with same code keep order of file
+    std::sort(runCodes.begin(), runCodes.end());
+    std::vector<int> originalIndices;
+    originalIndices.reserve(atomCount);
+    for(const auto& rRunCode : runCodes)
+    {
+        for(int i = runStarts[rRunCode.second]; i < runStarts[rRunCode.second + 1]; i++) { originalIndices.push_back(i); }
+    }
+    std::vector<int> internalIndices(atomCount);
+    for(int i = 0; i < atomCount; i++) { internalIndices[originalIndices[i]] = i; }
+
+    // Analysis needs contiguous ranges of amino acids, which only break when their ranges overlap
+    for(const AminoAcid& rAminoAcid : mAminoAcids)
+    {
+        for(int j = rAminoAcid.startIndex; j <= rAminoAcid.endIndex; j++)
+        {
+            if(internalIndices[j] != internalIndices[rAminoAcid.startIndex] + (j - rAminoAcid.startIndex))
+            {
+                Logger::instance().print("Amino acids overlap, atoms keep order of file", Logger::Mode::WARNING);
+                return;
+            }
+        }
+    }
+
+    // Use spatial order
+    for(AminoAcid& rAminoAcid : mAminoAcids)
+    {
+        if(rAminoAcid.startIndex > rAminoAcid.endIndex) { continue; }
+        rAminoAcid.endIndex = internalIndices[rAminoAcid.endIndex];
+        rAminoAcid.startIndex = internalIndices[rAminoAcid.startIndex];
+    }
+    mOriginalIndices.swap(originalIndices);
+    mInternalIndices.swap(internalIndices);
+    mAtomOrder = AtomOrder::SPATIAL;
+}
+
+std::shared_ptr<Trajectory> GPUProtein::orderTrajectory(Protein * const pProtein) const
+{
+    // Trajectory of protein is shared as long as order of file is kept
+    std::shared_ptr<Trajectory> spTrajectory = pProtein->getTrajectory();
+    if(mAtomOrder == AtomOrder::ORIGINAL) { return spTrajectory; }
+
+    // Gather positions of atoms per frame
+    int atomCount = spTrajectory->getAtomCount();
+    int frameCount = spTrajectory->getFrameCount();
+    std::shared_ptr<Trajectory> spOrderedTrajectory(new Trajectory(atomCount));
+    glm::vec3* pPositions = spOrderedTrajectory->addFrames(frameCount);
+    for(int frame = 0; frame < frameCount; frame++)
+    {
+        const glm::vec3* pFramePositions = spTrajectory->getFrameData(frame);
+        for(int i = 0; i < atomCount; i++)
+        {
+            pPositions[(size_t)frame * atomCount + i] = pFramePositions[mOriginalIndices[i]];
+        }
+    }
+    return spOrderedTrajectory;
+}
+
+std::shared_ptr<const TrajectoryProvider> GPUProtein::orderProvider(std::shared_ptr<const TrajectoryProvider> spTrajectoryProvider) const
+{
+    if(mAtomOrder == AtomOrder::ORIGINAL) { return spTrajectoryProvider; }
+    return std::shared_ptr<const TrajectoryProvider>(new OrderedTrajectoryProvider(spTrajectoryProvider, mOriginalIndices));
 }
 
 GPUProtein::GPUProtein(const std::vector<glm::vec4>& rAtoms)
@@ -112,32 +357,43 @@ GPUProtein::GPUProtein(const std::vector<glm::vec4>& rAtoms)
     int atomCount  = rAtoms.size();
     mspRadii = std::shared_ptr<std::vector<float> >(new std::vector<float>);
     mspRadii->resize(atomCount);
-    mspTrajectory = std::shared_ptr<
-            std::vector<
-                std::vector<glm::vec3> > >(
-                    new std::vector<std::vector<glm::vec3> >);
-    mspTrajectory->resize(1);
-    mspTrajectory->at(0).resize(atomCount);
+    std::shared_ptr<Trajectory> spTrajectory(new Trajectory(atomCount));
+    glm::vec3* pPositions = spTrajectory->addFrames(1);
+    mFrameCount = 1;
 
     // Fill structures for CPU
+    glm::vec3 accPosition(0, 0, 0);
     for(int i = 0; i < atomCount; i++)
     {
         // Collect radius
         mspRadii->at(i) = rAtoms.at(i).w;
 
         // Collect trajectory
-        mspTrajectory->at(0).at(i) = glm::vec3(rAtoms.at(i).x, rAtoms.at(i).y, rAtoms.at(i).z);
+        pPositions[i] = glm::vec3(rAtoms.at(i).x, rAtoms.at(i).y, rAtoms.at(i).z);
+        accPosition += pPositions[i];
     }
+    mspTrajectory = spTrajectory;
+
+    // Atoms keep their order
+    initAtomOrder(AtomOrder::ORIGINAL, spTrajectory->getFrame(0));
 
     // TODO: Elements and aminoacids are not filled here
 
+    // Center of the single frame
+    mCentersOfMass.push_back(atomCount > 0 ? accPosition / (float)atomCount : accPosition);
+    mCentersOfMassComputed.push_back(true);
+
     // Init SSBOs
-    initSSBOs(atomCount, 0);
+    mDecodedFrameCount = mFrameCount;
+    mAvailableFrameCount = mFrameCount;
+    initSSBOs(atomCount, mFrameCount);
 }
 
 GPUProtein::~GPUProtein()
 {
-    // Nothing to do
+    // Stop progressive loading, trajectory must not be written anymore
+    mStopLoading = true;
+    if(mLoadingThread.joinable()) { mLoadingThread.join(); }
 }
 
 void GPUProtein::bind(GLuint radiiSlot, GLuint trajectorySlot) const
@@ -171,45 +427,136 @@ std::shared_ptr<const std::vector<float> > GPUProtein::getRadii() const
     return mspRadii;
 }
 
-std::shared_ptr<const std::vector<std::vector<glm::vec3> > > GPUProtein::getTrajectory() const
+std::shared_ptr<const Trajectory> GPUProtein::getTrajectory() const
 {
+    if(isStreamed()) { return std::shared_ptr<const Trajectory>(); }
     return mspTrajectory;
 }
 
-void GPUProtein::initSSBOs(int atomCount, int frameCount)
+Trajectory::FrameSpan GPUProtein::getFrame(int frame) const
 {
-    // For copying it to OpenGL, store it linear
-    std::vector<glm::vec3> linearTrajectory;
-    linearTrajectory.reserve(frameCount * atomCount);
-    for(int i = 0; i < frameCount; i++)
+    // Frame inside of trajectory in memory, first frame of streamed trajectory comes from protein
+    if(!isStreamed() || frame == 0)
     {
-        linearTrajectory.insert(linearTrajectory.end(), mspTrajectory->at(i).begin(), mspTrajectory->at(i).end());
+        if(frame >= mDecodedFrameCount.load(std::memory_order_acquire)) { return Trajectory::FrameSpan(); }
+        return Trajectory::getFrame(mspTrajectory, frame);
     }
 
-    // Create structures of radii and trajectory on GPU
-    mRadiiBuffer.fill(*mspRadii.get(), GL_STATIC_DRAW);
-    mTrajectoryBuffer.fill(linearTrajectory, GL_STATIC_DRAW);
+    // Streamed frames, span shares ownership with frame in cache
+    std::shared_ptr<const std::vector<glm::vec3> > spFrame = mupFrameCache->getFrame(frame - 1);
+    if(!spFrame) { return Trajectory::FrameSpan(); }
+    return Trajectory::FrameSpan(spFrame->data(), (int)spFrame->size(), spFrame);
+}
+
+int GPUProtein::updateWindow(int minFrame, int maxFrame) const
+{
+    // Complete trajectory is on GPU, apart from frames which were loaded progressively since last call
+    if(!isStreamed())
+    {
+        uploadDecodedFrames();
+        return 0;
+    }
+
+    // Check whether frames are already in window
+    minFrame = glm::clamp(minFrame, 0, mFrameCount - 1);
+    maxFrame = glm::clamp(maxFrame, minFrame, mFrameCount - 1);
+    if(minFrame >= mWindowStartFrame && maxFrame < mWindowEndFrame) { return mWindowStartFrame; }
+
+    // Center new window around requested frames
+    int windowFrameCount = glm::min(mFrameCount, glm::max(mWindowFrameCount, maxFrame - minFrame + 1));
+    int startFrame = glm::clamp(((minFrame + maxFrame) / 2) - (windowFrameCount / 2), 0, mFrameCount - windowFrameCount);
+
+    // Allocate buffer for window if size changed
+    int atomCount = getAtomCount();
+    if(mTrajectoryBuffer.getSize() != windowFrameCount * atomCount)
+    {
+        mTrajectoryBuffer.fill(NULL, windowFrameCount * atomCount, GL_DYNAMIC_DRAW);
+    }
+
+    // Upload frames of window directly from memory of frames (frames which could not be read keep old content)
+    for(int i = startFrame; i < startFrame + windowFrameCount; i++)
+    {
+        Trajectory::FrameSpan frame = getFrame(i);
+        mTrajectoryBuffer.update(frame.data(), frame.size(), (i - startFrame) * atomCount);
+    }
+    mWindowStartFrame = startFrame;
+    mWindowEndFrame = startFrame + windowFrameCount;
+    return mWindowStartFrame;
+}
 
-    // Get atom lookup
-    AtomLUT lut;
+glm::vec3 GPUProtein::getCenterOfMass(int frame) const
+{
+    std::lock_guard<std::mutex> lock(mCentersOfMassMutex);
+    if(!mCentersOfMassComputed.at(frame))
+    {
+        glm::vec3 accPosition(0, 0, 0);
+        Trajectory::FrameSpan positions = getFrame(frame);
+        for(const glm::vec3& rPosition : positions) { accPosition += rPosition; }
+        accPosition /= (float)glm::max(1, positions.size());
+        mCentersOfMass.at(frame) = accPosition;
+        mCentersOfMassComputed.at(frame) = !positions.empty(); // frames not yet loaded are computed again later
+    }
+    return mCentersOfMass.at(frame);
+}
+
+void GPUProtein::uploadDecodedFrames() const
+{
+    // Frames up to count of decoded frames are completely written by background thread
+    int decodedFrameCount = mDecodedFrameCount.load(std::memory_order_acquire);
+    if(decodedFrameCount <= mAvailableFrameCount) { return; }
+    int atomCount = getAtomCount();
+    mTrajectoryBuffer.update(
+        mspTrajectory->getFrameData(mAvailableFrameCount),
+        (decodedFrameCount - mAvailableFrameCount) * atomCount,
+        mAvailableFrameCount * atomCount);
+    mAvailableFrameCount = decodedFrameCount;
+}
+
+void GPUProtein::initSSBOs(int atomCount, int frameCount)
+{
+    // Create structures of radii and trajectory on GPU. Trajectory is already linear in memory and uploaded
+    // without copy (streamed trajectory is uploaded per window)
+    mRadiiBuffer.fill(*mspRadii.get(), GL_STATIC_DRAW);
+    if(!isStreamed() && mAvailableFrameCount == frameCount)
+    {
+        mTrajectoryBuffer.fill(mspTrajectory->getData(), frameCount * atomCount, GL_STATIC_DRAW);
+    }
+    else if(!isStreamed())
+    {
+        // Progressively loaded frames are uploaded once decoded
+        mTrajectoryBuffer.fill(NULL, frameCount * atomCount, GL_DYNAMIC_DRAW);
+        mTrajectoryBuffer.update(mspTrajectory->getData(), mAvailableFrameCount * atomCount);
+    }
+    mWindowStartFrame = 0;
+    mWindowEndFrame = isStreamed() ? 0 : frameCount;
+
+    // Look up colors once per distinct string, so colors of atoms are found by indexing with their ids
+    int stringCount = mspStrings ? mspStrings->size() : 0;
+    std::vector<glm::vec3> elementColorOfId(stringCount);
+    std::vector<glm::vec3> aminoAcidColorOfId(stringCount);
+    for(int i = 0; i < stringCount; i++)
+    {
+        auto it = AtomLUT::cpk_colorcode.find(mspStrings->get(i));
+        if(it != AtomLUT::cpk_colorcode.end()) { elementColorOfId.at(i) = glm::vec3(it->second.r, it->second.g, it->second.b); }
+        auto color = AtomLUT::fetchAminoColor(mspStrings->get(i));
+        aminoAcidColorOfId.at(i) = glm::vec3(color.r, color.g, color.b);
+    }
 
     // Create structure for coloring according to element on GPU
     std::vector<glm::vec3> elementColors;
-    elementColors.reserve(atomCount);
-    for(int i = 0; i < atomCount; i++)
+    elementColors.reserve(mElementIds.size());
+    for(StringTable::Id id : mElementIds)
     {
-        auto color = lut.cpk_colorcode[mElementNames.at(i)];
-        elementColors.push_back(glm::vec3(color.r, color.g, color.b));
+        elementColors.push_back(elementColorOfId[id]);
     }
     mColorsElementBuffer.fill(elementColors, GL_STATIC_DRAW);
 
     // Create structure for coloring according to aminoacid on GPU
     std::vector<glm::vec3> aminoacidColors;
-    aminoacidColors.reserve(atomCount);
-    for(int i = 0; i < atomCount; i++)
+    aminoacidColors.reserve(mAminoAcidIds.size());
+    for(StringTable::Id id : mAminoAcidIds)
     {
-        auto color = lut.fetchAminoColor(mAminoAcidsNames.at(i));
-        aminoacidColors.push_back(glm::vec3(color.r, color.g, color.b));
+        aminoacidColors.push_back(aminoAcidColorOfId[id]);
     }
     mColorsAminoacidBuffer.fill(aminoacidColors, GL_STATIC_DRAW);
 
@@ -2,19 +2,31 @@
 // Distributed under the MIT License. Author: Raphael Menges
 //============================================================================
 
-// Protein on GPU.
+// Protein on GPU. Trajectory is either completely held in memory, shared with
+// the protein it was loaded into, or streamed from a trajectory provider through
+// a frame cache. In the latter case, only a window of frames is uploaded to the GPU.
+// Trajectory in memory may also be loaded progressively, then frames are decoded on
+// a background thread and become available one after another.
 
 #ifndef GPU_PROTEIN_H
 #define GPU_PROTEIN_H
 
 #include "SurfaceExtraction/GPUBuffer.h"
+#include "Molecule/MDtrajLoader/Data/Trajectory.h"
+#include "Molecule/MDtrajLoader/Data/StringTable.h"
 #include <GL/glew.h>
 #include <glm/glm.hpp>
 #include <vector>
+#include <string>
 #include <memory>
+#include <mutex>
+#include <atomic>
+#include <thread>
 
 // Forward declaration
 class Protein;
+class TrajectoryProvider;
+class FrameCache;
 
 class GPUProtein
 {
@@ -35,10 +47,30 @@ public:
         int endIndex;
     };
 
-    // Constructors
-    GPUProtein(Protein * const pProtein);
+    // Order of atoms. Spatial order sorts residues along a Z-order curve over their centers in first frame, so atoms
+    // close in space are close in memory. Atoms within a residue and ranges of amino acids stay contiguous
+    enum class AtomOrder { ORIGINAL, SPATIAL };
+
+    // Constructors. Atoms are in given order for all methods and SSBOs, map indices to protein with getOriginalIndex
+    GPUProtein(Protein * const pProtein, AtomOrder atomOrder = AtomOrder::ORIGINAL);
     GPUProtein(const std::vector<glm::vec4>& rAtoms); // vec3 center + float radius
 
+    // Constructor for streamed trajectory. First frame is taken from protein, further frames from provider.
+    // Cached frame count limits frames in memory, window frame count limits frames on GPU
+    GPUProtein(
+        Protein * const pProtein,
+        std::shared_ptr<const TrajectoryProvider> spTrajectoryProvider,
+        int cachedFrameCount,
+        int windowFrameCount,
+        AtomOrder atomOrder = AtomOrder::ORIGINAL);
+
+    // Constructor for progressively loaded trajectory. Frames of protein are available at once, frames of provider
+    // are decoded on a background thread and appended to trajectory in memory, which is shared with protein
+    GPUProtein(
+        Protein * const pProtein,
+        std::shared_ptr<const TrajectoryProvider> spTrajectoryProvider,
+        AtomOrder atomOrder = AtomOrder::ORIGINAL);
+
     // Destructor
     virtual ~GPUProtein();
 
@@ -60,23 +92,52 @@ public:
     // Get count of atoms in protein
     int getAtomCount() const { return mspRadii->size(); }
 
-    // Get count of frames available in trajectory
-    int getFrameCount() const { return mspTrajectory->size(); }
+    // Get order of atoms, which is original one if spatial order would break ranges of amino acids
+    AtomOrder getAtomOrder() const { return mAtomOrder; }
+
+    // Get index of atom in protein, as in loaded files
+    int getOriginalIndex(int atomIndex) const { return mOriginalIndices.at(atomIndex); }
+
+    // Get index of atom in GPU protein from its index in protein
+    int getInternalIndex(int originalIndex) const { return mInternalIndices.at(originalIndex); }
+
+    // Get count of frames available in trajectory. While loading progressively, it only counts decoded frames which
+    // were uploaded by updateWindow, so it grows with calls to that method
+    int getFrameCount() const { return mAvailableFrameCount; }
+
+    // Get count of frames in trajectory, including frames which are not yet loaded
+    int getTotalFrameCount() const { return mFrameCount; }
+
+    // Get whether frames are still loaded progressively
+    bool isLoading() const { return mLoading || mAvailableFrameCount < mDecodedFrameCount; }
+
+    // Get whether trajectory is streamed instead of completely held in memory
+    bool isStreamed() const { return mupFrameCache != NULL; }
 
     // Get shared pointer to atom radii
     std::shared_ptr<const std::vector<float> > getRadii() const;
 
-    // Get shared pointer to trajectory (position per atom per frame)
-    std::shared_ptr<const std::vector<std::vector<glm::vec3> > > getTrajectory() const;
+    // Get shared pointer to trajectory (position per atom per frame). Empty when trajectory is streamed, use getFrame then.
+    // While loading progressively, only frames below frame count are filled
+    std::shared_ptr<const Trajectory> getTrajectory() const;
+
+    // Get positions of atoms at frame. Span shares ownership of positions. Streamed frames are read through frame
+    // cache, span is empty if frame could not be read or is not yet loaded. Can be called from multiple threads
+    Trajectory::FrameSpan getFrame(int frame) const;
+
+    // Make sure that frames [minFrame, maxFrame] are in trajectory SSBO. Returns first frame in SSBO, which must be given
+    // to shaders as uniform "trajectoryWindowStart". Without streaming, all frames are in SSBO and zero is returned.
+    // Frames which were loaded progressively since last call are uploaded here and become available
+    int updateWindow(int minFrame, int maxFrame) const;
 
     // Get center of protein at specific frame
-    glm::vec3 getCenterOfMass(int frame) const { return mCentersOfMass.at(frame); }
+    glm::vec3 getCenterOfMass(int frame) const;
 
     // Get element
-    std::string getElementName(int atomIndex) const { return mElementNames.at(atomIndex); }
+    std::string getElementName(int atomIndex) const { return mspStrings->get(mElementIds.at(atomIndex)); }
 
     // Get amino acid
-    std::string getAminoAcidName(int atomIndex) const { return mAminoAcidsNames.at(atomIndex); }
+    std::string getAminoAcidName(int atomIndex) const { return mspStrings->get(mAminoAcidIds.at(atomIndex)); }
 
     // Get minimum initial coordinates
     glm::vec3 getMinCoordinates() const { return mMinCoordinates; }
@@ -89,29 +150,75 @@ public:
 
 private:
 
+    // Initialize structures from protein except trajectory
+    void initFromProtein(Protein * const pProtein, AtomOrder atomOrder);
+
+    // Initialize order of atoms from positions, needs ranges of amino acids in order of protein
+    void initAtomOrder(AtomOrder atomOrder, const Trajectory::FrameSpan& rPositions);
+
+    // Get trajectory of protein in order of atoms, which is copied when atoms are reordered
+    std::shared_ptr<Trajectory> orderTrajectory(Protein * const pProtein) const;
+
+    // Get provider of frames in order of atoms
+    std::shared_ptr<const TrajectoryProvider> orderProvider(std::shared_ptr<const TrajectoryProvider> spTrajectoryProvider) const;
+
     // Initialize SSBOs
     void initSSBOs(int atomCount, int frameCount);
 
+    // Upload frames which were decoded by background thread since last call
+    void uploadDecodedFrames() const;
+
     // Vector of radii
     std::shared_ptr<std::vector<float> > mspRadii;
 
-    // Vector of trajectory (outer is for frames, inner for atoms in each frame)
-    std::shared_ptr<std::vector<std::vector<glm::vec3> > > mspTrajectory;
+    // Order of atoms, with index in protein per atom and the inverse permutation
+    AtomOrder mAtomOrder = AtomOrder::ORIGINAL;
+    std::vector<int> mOriginalIndices;
+    std::vector<int> mInternalIndices;
+
+    // Trajectory, shared with protein. When streamed, it holds only the first frame
+    std::shared_ptr<const Trajectory> mspTrajectory;
+
+    // Count of frames
+    int mFrameCount = 0;
+
+    // Count of frames which are in memory and on GPU. Only smaller than frame count while loading progressively
+    mutable int mAvailableFrameCount = 0;
+
+    // Count of frames in memory, increased by background thread after each decoded frame
+    std::atomic<int> mDecodedFrameCount{0};
+
+    // Background thread of progressive loading, which stops early when flag is set
+    std::thread mLoadingThread;
+    std::atomic<bool> mLoading{false};
+    std::atomic<bool> mStopLoading{false};
+
+    // Cache of frames after first one when streamed
+    std::unique_ptr<FrameCache> mupFrameCache;
 
     // SSBO of radii
     GPUBuffer<float> mRadiiBuffer;
 
-    // SSBO of trajectory
-    GPUBuffer<glm::vec3> mTrajectoryBuffer;
+    // SSBO of trajectory. When streamed, it holds window of frames, which changes with requested frames
+    mutable GPUBuffer<glm::vec3> mTrajectoryBuffer;
+    int mWindowFrameCount = 0;
+    mutable int mWindowStartFrame = 0;
+    mutable int mWindowEndFrame = -1; // exclusive
+
+    // Vector which holds the center of mass for each frame (ok, mass is not yet taken into account).
+    // When streamed, centers are computed on first request
+    mutable std::vector<glm::vec3> mCentersOfMass;
+    mutable std::vector<bool> mCentersOfMassComputed;
+    mutable std::mutex mCentersOfMassMutex;
 
-    // Vector which holds the center of mass for each frame (ok, mass is not yet taken into account)
-    std::vector<glm::vec3> mCentersOfMass;
+    // Strings of elements and aminoacids, shared with protein
+    std::shared_ptr<const StringTable> mspStrings;
 
-    // Strings which hold element of atoms
-    std::vector<std::string> mElementNames;
+    // Ids of element of atoms
+    std::vector<StringTable::Id> mElementIds;
 
-    // Strings which hold aminoacid of atoms
-    std::vector<std::string> mAminoAcidsNames;
+    // Ids of aminoacid of atoms
+    std::vector<StringTable::Id> mAminoAcidIds;
 
     // SSBO with colors for atoms according to element
     GPUBuffer<glm::vec3> mColorsElementBuffer;
@@ -74,6 +74,25 @@ int GPUSurface::getLayerOfAtom(GLuint index) const
     return -1;
 }
 
+std::vector<int> GPUSurface::getLayersOfAtoms() const
+{
+    // Initial input indices contain all atoms
+    std::vector<int> layers(mupInitialInputIndices->getSize(), -1);
+
+    // Go through surface layers
+    for(int i = 0; i < mSurfaceIndices.size(); i++)
+    {
+        auto indices = mSurfaceIndices.at(i)->read(mSurfaceCounts.at(i));
+        for(GLuint index : indices)
+        {
+            // Keep first layer found like getLayerOfAtom does
+            if(layers.at(index) < 0) { layers.at(index) = i; }
+        }
+    }
+
+    return layers;
+}
+
 int GPUSurface::addLayer(int reservedSize)
 {
     mInternalIndices.push_back(std::unique_ptr<GPUTextureBuffer>(new GPUTextureBuffer(reservedSize)));
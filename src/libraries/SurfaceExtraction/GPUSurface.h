@@ -53,6 +53,9 @@ public:
     // Get layer of atom. Returns -1 if not found in any computed layer
     int getLayerOfAtom(GLuint index) const;
 
+    // Get layers of all atoms, reading each layer only once. Entry is -1 if atom not found in any computed layer
+    std::vector<int> getLayersOfAtoms() const;
+
     // Get whether layers were extracted
     bool layersExtracted() const { return mLayerExtracted; }
 
@@ -47,6 +47,10 @@ std::unique_ptr<GPUSurface> GPUSurfaceExtraction::calculateSurface(
         // Start measuring time
         double time = glfwGetTime();
 
+        // Positions of atoms at frame, read by all threads
+        Trajectory::FrameSpan positions = pGPUProtein->getFrame(frame);
+        const Trajectory::FrameSpan& rPositions = positions;
+
         // Create vector for indices
         std::vector<unsigned int> inputIndices; // read by all threads
         std::vector<unsigned int> internalIndices; // combined vectors of all threads
@@ -86,7 +90,7 @@ std::unique_ptr<GPUSurface> GPUSurfaceExtraction::calculateSurface(
                 int count = inputCount / CPUThreadCount;
                 int offset = count * i;
                 threads.push_back(
-                    std::thread([inputCount, probeRadius, frame, &pGPUProtein]( // decide what to capture
+                    std::thread([inputCount, probeRadius, &rPositions, &pGPUProtein]( // decide what to capture
                         int minIndex,
                         int maxIndex,
                         const std::vector<unsigned int>& rInputIndices,
@@ -102,7 +106,7 @@ std::unique_ptr<GPUSurface> GPUSurfaceExtraction::calculateSurface(
                         {
                             threadCPUSurfaceExtraction.execute(
                                 pGPUProtein,
-                                frame,
+                                rPositions,
                                 a,
                                 inputCount,
                                 probeRadius,
@@ -160,8 +164,9 @@ std::unique_ptr<GPUSurface> GPUSurfaceExtraction::calculateSurface(
         // Probe radius
         mupComputeProgram->update("probeRadius", probeRadius);
 
-        // Current frame
+        // Current frame and first frame of trajectory on GPU, which must contain current one
         mupComputeProgram->update("frame", frame);
+        mupComputeProgram->update("trajectoryWindowStart", pGPUProtein->updateWindow(frame, frame));
 
         // Atom count
         mupComputeProgram->update("atomCount", pGPUProtein->getAtomCount());
@@ -242,7 +247,7 @@ std::unique_ptr<GPUSurface> GPUSurfaceExtraction::calculateSurface(
 // ## Execution function
 void GPUSurfaceExtraction::CPUSurfaceExtraction::execute(
     GPUProtein const * pGPUProtein,
-    int frame,
+    const Trajectory::FrameSpan& rPositions,
     int executionIndex,
     int inputCount,
     float probeRadius,
@@ -275,7 +280,7 @@ void GPUSurfaceExtraction::CPUSurfaceExtraction::execute(
     bool endpointSurvivesCut = false;
 
     // Own center
-    glm::vec3 atomCenter = pGPUProtein->getTrajectory()->at(frame).at(atomIndex);
+    glm::vec3 atomCenter = rPositions.at(atomIndex);
     /* if(mLogging) { std::cout << "Atom center: " << atomCenter.x << ", " << atomCenter.y << ", " << atomCenter.z << std::endl; } */
 
     // Own extended radius
@@ -296,7 +301,7 @@ void GPUSurfaceExtraction::CPUSurfaceExtraction::execute(
         // ### OTHER'S VALUES ###
 
         // Get values from other atom
-        glm::vec3 otherAtomCenter = pGPUProtein->getTrajectory()->at(frame).at(otherAtomIndex);
+        glm::vec3 otherAtomCenter = rPositions.at(otherAtomIndex);
         float otherAtomExtRadius = pGPUProtein->getRadii()->at(otherAtomIndex) + probeRadius;
 
         // ### INTERSECTION TEST ###
@@ -43,7 +43,7 @@ private:
 
         void execute(
             GPUProtein const * pGPUProtein,
-            int frame,
+            const Trajectory::FrameSpan& rPositions, // positions of atoms at frame
             int executionIndex,
             int inputCount,
             float probeRadius,
@@ -0,0 +1,169 @@
+//============================================================================
+// Distributed under the MIT License. Author: Raphael Menges
+//============================================================================
+
+#include "GroupAnalysis.h"
+#include "SurfaceExtraction/GPUHullSamples.h"
+#include <glm/gtc/constants.hpp>
+
+GroupAnalysis::GroupAnalysis()
+{
+    // Nothing to do
+}
+
+GroupAnalysis::~GroupAnalysis()
+{
+    // Nothing to do
+}
+
+void GroupAnalysis::reset(
+    std::vector<std::vector<int> > const * pLayersOfAtoms,
+    GPUHullSamples const * pHullSamples,
+    std::shared_ptr<const std::vector<float> > spRadii,
+    float probeRadius)
+{
+    mpLayersOfAtoms = pLayersOfAtoms;
+    mpHullSamples = pHullSamples;
+    mspRadii = spRadii;
+    mProbeRadius = probeRadius;
+    mFrameCount = (int)pLayersOfAtoms->size();
+    clear();
+}
+
+bool GroupAnalysis::add(GLuint atomIndex)
+{
+    if(contains(atomIndex)) { return false; }
+    mGroupBits.at(atomIndex / 32) |= (1u << (atomIndex % 32));
+    mAtomCount++;
+    accumulate(atomIndex, 1);
+    return true;
+}
+
+bool GroupAnalysis::remove(GLuint atomIndex)
+{
+    if(!contains(atomIndex)) { return false; }
+    mGroupBits.at(atomIndex / 32) &= ~(1u << (atomIndex % 32));
+    mAtomCount--;
+    accumulate(atomIndex, -1);
+    return true;
+}
+
+void GroupAnalysis::clear()
+{
+    mAtomCount = 0;
+    mGroupBits.assign(mspRadii ? (mspRadii->size() + 31) / 32 : 0, 0);
+    mLayerSums.assign(mFrameCount, 0);
+    mSurfaceSampleSums.assign(mFrameCount, 0);
+    mSurfaceAreaSums.assign(mFrameCount, 0.0);
+
+    // Histograms have one entry per layer plus one for atoms not found in any layer
+    mLayerHistograms.clear();
+    mLayerHistograms.resize(mFrameCount);
+    for(int frame = 0; frame < mFrameCount; frame++)
+    {
+        const std::vector<int>& rLayers = mpLayersOfAtoms->at(frame);
+        int maxLayer = -1;
+        for(int layer : rLayers) { maxLayer = glm::max(maxLayer, layer); }
+        mLayerHistograms.at(frame).assign(maxLayer + 2, 0);
+    }
+}
+
+bool GroupAnalysis::contains(GLuint atomIndex) const
+{
+    return (mGroupBits.at(atomIndex / 32) >> (atomIndex % 32)) & 1u;
+}
+
+std::vector<float> GroupAnalysis::getMinLayers() const
+{
+    std::vector<float> minLayers(mFrameCount, -1.f); // minus one means no data
+    if(mAtomCount == 0) { return minLayers; }
+    for(int frame = 0; frame < mFrameCount; frame++)
+    {
+        // Do it only when layers were extracted for this frame
+        if(mpLayersOfAtoms->at(frame).empty()) { continue; }
+
+        // First filled entry of histogram is min layer (which means the one closest or at surface)
+        const std::vector<int>& rHistogram = mLayerHistograms.at(frame);
+        for(int i = 0; i < (int)rHistogram.size(); i++)
+        {
+            if(rHistogram.at(i) > 0)
+            {
+                minLayers.at(frame) = (float)(i - 1);
+                break;
+            }
+        }
+    }
+    return minLayers;
+}
+
+std::vector<float> GroupAnalysis::getAvgLayers() const
+{
+    std::vector<float> avgLayers(mFrameCount, -1.f); // minus one means no data
+    if(mAtomCount == 0) { return avgLayers; }
+    for(int frame = 0; frame < mFrameCount; frame++)
+    {
+        // Do it only when layers were extracted for this frame
+        if(mpLayersOfAtoms->at(frame).empty()) { continue; }
+        avgLayers.at(frame) = (float)mLayerSums.at(frame) / (float)mAtomCount;
+    }
+    return avgLayers;
+}
+
+std::vector<float> GroupAnalysis::getSurfaceAmount() const
+{
+    std::vector<float> surfaceAmount(mFrameCount, -1.f); // minus one means no data
+    if(mAtomCount == 0) { return surfaceAmount; }
+    float sampleCount = (float)mpHullSamples->getSampleCount(mAtomCount);
+    for(int frame = 0; frame < mFrameCount; frame++)
+    {
+        surfaceAmount.at(frame) = (float)mSurfaceSampleSums.at(frame) / sampleCount;
+    }
+    return surfaceAmount;
+}
+
+std::vector<float> GroupAnalysis::getSurfaceArea() const
+{
+    std::vector<float> surfaceArea(mFrameCount, -1.f); // minus one means no data
+    if(mAtomCount == 0) { return surfaceArea; }
+    for(int frame = 0; frame < mFrameCount; frame++)
+    {
+        surfaceArea.at(frame) = (float)mSurfaceAreaSums.at(frame);
+    }
+    return surfaceArea;
+}
+
+float GroupAnalysis::getAvgLayersDeltaAccumulation() const
+{
+    std::vector<float> avgLayers = getAvgLayers();
+    float accumulation = 0.f;
+    for(int i = 0; i < (int)avgLayers.size() - 1; i++)
+    {
+        accumulation += glm::abs(avgLayers.at(i + 1) - avgLayers.at(i));
+    }
+    return accumulation;
+}
+
+void GroupAnalysis::accumulate(GLuint atomIndex, int sign)
+{
+    // Surface area of atom's extended hull, weighted by amount of surface samples later
+    float extendedRadius = mspRadii->at(atomIndex) + mProbeRadius;
+    double sampleArea = (4.0 * glm::pi<double>() * extendedRadius * extendedRadius) / (double)mpHullSamples->getSampleCount();
+
+    // Count of surface samples of that atom in all frames
+    std::vector<int> surfaceSampleCounts = mpHullSamples->getSurfaceSampleCounts(atomIndex);
+
+    // Update running sums of each frame
+    for(int frame = 0; frame < mFrameCount; frame++)
+    {
+        const std::vector<int>& rLayers = mpLayersOfAtoms->at(frame);
+        if(!rLayers.empty())
+        {
+            int layer = rLayers.at(atomIndex);
+            mLayerSums.at(frame) += sign * layer;
+            mLayerHistograms.at(frame).at(layer + 1) += sign;
+        }
+        int surfaceSampleCount = frame < (int)surfaceSampleCounts.size() ? surfaceSampleCounts.at(frame) : 0;
+        mSurfaceSampleSums.at(frame) += sign * surfaceSampleCount;
+        mSurfaceAreaSums.at(frame) += sign * sampleArea * surfaceSampleCount;
+    }
+}
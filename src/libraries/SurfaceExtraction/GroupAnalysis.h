@@ -0,0 +1,89 @@
+//============================================================================
+// Distributed under the MIT License. Author: Raphael Menges
+//============================================================================
+
+// Analysis of an atom group over computed frames. Keeps running sums per frame,
+// so adding or removing a single atom only touches each frame once.
+
+#ifndef GROUP_ANALYSIS_H
+#define GROUP_ANALYSIS_H
+
+#include <GL/glew.h>
+#include <vector>
+#include <memory>
+
+// Forward declaration
+class GPUHullSamples;
+
+class GroupAnalysis
+{
+public:
+
+    // Constructor
+    GroupAnalysis();
+
+    // Destructor
+    virtual ~GroupAnalysis();
+
+    // Reset for new computed frames and empty the group. Layers of frames without extracted layers are empty.
+    // Pointed data must stay alive as long as the group is edited
+    void reset(
+        std::vector<std::vector<int> > const * pLayersOfAtoms,
+        GPUHullSamples const * pHullSamples,
+        std::shared_ptr<const std::vector<float> > spRadii,
+        float probeRadius);
+
+    // Add atom to group. Returns false if already in group
+    bool add(GLuint atomIndex);
+
+    // Remove atom from group. Returns false if not in group
+    bool remove(GLuint atomIndex);
+
+    // Remove all atoms from group
+    void clear();
+
+    // Check whether atom is in group
+    bool contains(GLuint atomIndex) const;
+
+    // Get count of atoms in group
+    int getAtomCount() const { return mAtomCount; }
+
+    // Get values per computed frame. Minus one means no data
+    std::vector<float> getMinLayers() const;
+    std::vector<float> getAvgLayers() const;
+    std::vector<float> getSurfaceAmount() const;
+    std::vector<float> getSurfaceArea() const;
+
+    // Get accumulated absolute delta of average layers over frames
+    float getAvgLayersDeltaAccumulation() const;
+
+private:
+
+    // Add or remove contribution of atom to running sums
+    void accumulate(GLuint atomIndex, int sign);
+
+    // Count of computed frames
+    int mFrameCount = 0;
+
+    // Count of atoms in group
+    int mAtomCount = 0;
+
+    // Bitset of atoms in group
+    std::vector<GLuint> mGroupBits;
+
+    // Running sums per frame
+    std::vector<int> mLayerSums;
+    std::vector<int> mSurfaceSampleSums;
+    std::vector<double> mSurfaceAreaSums; // double to avoid drift when adding and removing
+
+    // Count of group atoms per layer for each frame (first entry counts atoms not found in any layer)
+    std::vector<std::vector<int> > mLayerHistograms;
+
+    // Data of computed frames
+    std::vector<std::vector<int> > const * mpLayersOfAtoms = NULL;
+    GPUHullSamples const * mpHullSamples = NULL;
+    std::shared_ptr<const std::vector<float> > mspRadii;
+    float mProbeRadius = 0.f;
+};
+
+#endif // GROUP_ANALYSIS_H
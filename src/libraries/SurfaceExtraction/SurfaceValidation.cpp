@@ -54,39 +54,89 @@ void SurfaceValidation::validate(
     unsigned int sampleSeed,
     int samplesPerAtomCount,
     std::string& rInformation,
-    std::vector<GLuint> rMaybeIncorrectSurfaceAtomIndices)
+    std::vector<GLuint>& rMaybeIncorrectSurfaceAtomIndices)
 {
     // Clear references
     rInformation.clear();
     rMaybeIncorrectSurfaceAtomIndices.clear();
 
-    // Read data back from OpenGL buffers
-    std::vector<GLuint> inputIndices = pGPUSurface->getInputIndices(layer);
-    std::vector<GLuint> internalIndices = pGPUSurface->getInternalIndices(layer);
-    std::vector<GLuint> surfaceIndices = pGPUSurface->getSurfaceIndices(layer);
-
-    // Seed
-    std::srand(sampleSeed);
-
     // Vectors of samples
     std::vector<glm::vec3> internalSamples;
     std::vector<glm::vec3> surfaceSamples;
 
     // Count cases of failure
     int internalSampleFailures = 0;
-    int surfaceAtomsFailures = 0;
 
-    // Get shared pointer to radii and trajectory
-    auto spRadii = pGPUProtein->getRadii();
-    auto spTrajectory = pGPUProtein->getTrajectory();
+    // Do validation on data read back from OpenGL buffers
+    int unclassifiedAtom = validateClassification(
+        *(pGPUProtein->getRadii()),
+        pGPUProtein->getFrame(frame),
+        pGPUSurface->getInputIndices(layer),
+        pGPUSurface->getInternalIndices(layer),
+        pGPUSurface->getSurfaceIndices(layer),
+        probeRadius,
+        sampleSeed,
+        samplesPerAtomCount,
+        internalSampleFailures,
+        rMaybeIncorrectSurfaceAtomIndices,
+        &internalSamples,
+        &surfaceSamples);
+
+    if(unclassifiedAtom >= 0)
+    {
+        rInformation =
+            "Atom "
+            + std::to_string(unclassifiedAtom)
+            + " neither classified as internal nor as surface.\nSurface extraction algorithm has failed.";
+        return;
+    }
+
+    // Fill vertex buffer with vertices
+    glBindBuffer(GL_ARRAY_BUFFER, mInternalVBO);
+    glBufferData(GL_ARRAY_BUFFER, internalSamples.size() * sizeof(glm::vec3), internalSamples.data(), GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    glBindBuffer(GL_ARRAY_BUFFER, mSurfaceVBO);
+    glBufferData(GL_ARRAY_BUFFER, surfaceSamples.size() * sizeof(glm::vec3), surfaceSamples.data(), GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    // Remember about complete count of samples for drawing
+    mInternalSampleCount = internalSamples.size();
+    mSurfaceSampleCount = surfaceSamples.size();
+
+    // Draw output of test to GUI
+    rInformation = "Wrong classification as internal for " + std::to_string(internalSampleFailures) + " samples.\n";
+    rInformation += "Maybe wrong classification as surface for " + std::to_string(rMaybeIncorrectSurfaceAtomIndices.size()) + " atoms.";
+}
+
+int SurfaceValidation::validateClassification(
+    const std::vector<float>& rRadii,
+    const Trajectory::FrameSpan& rPositions,
+    const std::vector<GLuint>& rInputIndices,
+    const std::vector<GLuint>& rInternalIndices,
+    const std::vector<GLuint>& rSurfaceIndices,
+    float probeRadius,
+    unsigned int sampleSeed,
+    int samplesPerAtomCount,
+    int& rInternalSampleFailures,
+    std::vector<GLuint>& rMaybeIncorrectSurfaceAtomIndices,
+    std::vector<glm::vec3>* pInternalSamples,
+    std::vector<glm::vec3>* pSurfaceSamples)
+{
+    // Clear references
+    rInternalSampleFailures = 0;
+    rMaybeIncorrectSurfaceAtomIndices.clear();
+
+    // Seed
+    std::srand(sampleSeed);
 
     // Go over atoms (using indices from input indices buffer)
-    for(unsigned int i : inputIndices) // using results from algorithm here. Not so good for independent test but necessary for validating layers
+    for(unsigned int i : rInputIndices) // using results from algorithm here. Not so good for independent test but necessary for validating layers
     {
         // Check, whether atom is internal or surface (would be faster to iterate over those structures, but this way the test is more testier)
         bool found = false;
         bool internalAtom = false;
-        for(auto& rIndex : internalIndices)
+        for(auto& rIndex : rInternalIndices)
         {
             if(rIndex == i)
             {
@@ -97,7 +147,7 @@ void SurfaceValidation::validate(
         }
         if(!found)
         {
-            for(auto& rIndex : surfaceIndices)
+            for(auto& rIndex : rSurfaceIndices)
             {
                 if(rIndex == i)
                 {
@@ -109,16 +159,12 @@ void SurfaceValidation::validate(
         }
         if(!found)
         {
-            rInformation =
-                "Atom "
-                + std::to_string(i)
-                + " neither classified as internal nor as surface.\nSurface extraction algorithm has failed.";
-            return;
+            return (int)i;
         }
 
         // Get position and radius for that atom
-        glm::vec3 atomCenter = spTrajectory->at(frame).at(i);
-        float atomExtRadius = spRadii->at(i) + probeRadius;
+        glm::vec3 atomCenter = rPositions.at(i);
+        float atomExtRadius = rRadii.at(i) + probeRadius;
 
         // Count samples which are classified as internal for that atom
         int atomInternalSampleCount = 0;
@@ -141,14 +187,14 @@ void SurfaceValidation::validate(
 
             // Go over all atoms and test, whether sample is inside in at least one
             bool inside = false;
-            for(unsigned int k : inputIndices)
+            for(unsigned int k : rInputIndices)
             {
                 // Test not against atom that generated sample
                 if(k == i) { continue; };
 
                 // Actual test
-                glm::vec3 otherAtomCenter = spTrajectory->at(frame).at(k);
-                float otherAtomRadius = spRadii->at(k) + probeRadius;
+                glm::vec3 otherAtomCenter = rPositions.at(k);
+                float otherAtomRadius = rRadii.at(k) + probeRadius;
                 if(glm::distance(samplePosition, otherAtomCenter) <= (otherAtomRadius))
                 {
                     inside = true;
@@ -163,7 +209,7 @@ void SurfaceValidation::validate(
                 atomInternalSampleCount++;
 
                 // Push back to vector
-                internalSamples.push_back(samplePosition);
+                if(pInternalSamples != NULL) { pInternalSamples->push_back(samplePosition); }
             }
             else
             {
@@ -171,11 +217,11 @@ void SurfaceValidation::validate(
                 if(internalAtom)
                 {
                     // Sample is not inside any other atom's extended hull but should be
-                    internalSampleFailures++;
+                    rInternalSampleFailures++;
                 }
 
                 // Push back to vector
-                surfaceSamples.push_back(samplePosition);
+                if(pSurfaceSamples != NULL) { pSurfaceSamples->push_back(samplePosition); }
             }
         }
 
@@ -183,26 +229,10 @@ void SurfaceValidation::validate(
         if((atomInternalSampleCount == samplesPerAtomCount) && !internalAtom)
         {
             rMaybeIncorrectSurfaceAtomIndices.push_back(i);
-            surfaceAtomsFailures++;
         }
     }
 
-    // Fill vertex buffer with vertices
-    glBindBuffer(GL_ARRAY_BUFFER, mInternalVBO);
-    glBufferData(GL_ARRAY_BUFFER, internalSamples.size() * sizeof(glm::vec3), internalSamples.data(), GL_DYNAMIC_DRAW);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-
-    glBindBuffer(GL_ARRAY_BUFFER, mSurfaceVBO);
-    glBufferData(GL_ARRAY_BUFFER, surfaceSamples.size() * sizeof(glm::vec3), surfaceSamples.data(), GL_DYNAMIC_DRAW);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-
-    // Remember about complete count of samples for drawing
-    mInternalSampleCount = internalSamples.size();
-    mSurfaceSampleCount = surfaceSamples.size();
-
-    // Draw output of test to GUI
-    rInformation = "Wrong classification as internal for " + std::to_string(internalSampleFailures) + " samples.\n";
-    rInformation += "Maybe wrong classification as surface for " + std::to_string(surfaceAtomsFailures) + " atoms.";
+    return -1;
 }
 
 void SurfaceValidation::drawSamples(
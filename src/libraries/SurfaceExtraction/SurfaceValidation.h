@@ -8,9 +8,12 @@
 #define SURFACE_EXTRACTION_H
 
 #include "ShaderTools/ShaderProgram.h"
+#include "Molecule/MDtrajLoader/Data/Trajectory.h"
 #include <GL/glew.h>
 #include <glm/glm.hpp>
 #include <memory>
+#include <vector>
+#include <string>
 
 // Forward declaration
 class GPUProtein;
@@ -36,7 +39,24 @@ public:
         unsigned int sampleSeed,
         int samplesPerAtomCount,
         std::string& rInformation,
-        std::vector<GLuint> rMaybeIncorrectSurfaceAtomIndices);
+        std::vector<GLuint>& rMaybeIncorrectSurfaceAtomIndices);
+
+    // Sample based check of a classification without any OpenGL calls, usable for headless testing.
+    // Positions are the ones of the validated frame. Returns index of first input atom which is neither
+    // classified as internal nor as surface or -1 if all are classified. Sample vectors are only filled when given
+    static int validateClassification(
+        const std::vector<float>& rRadii,
+        const Trajectory::FrameSpan& rPositions,
+        const std::vector<GLuint>& rInputIndices,
+        const std::vector<GLuint>& rInternalIndices,
+        const std::vector<GLuint>& rSurfaceIndices,
+        float probeRadius,
+        unsigned int sampleSeed,
+        int samplesPerAtomCount,
+        int& rInternalSampleFailures,
+        std::vector<GLuint>& rMaybeIncorrectSurfaceAtomIndices,
+        std::vector<glm::vec3>* pInternalSamples = NULL,
+        std::vector<glm::vec3>* pSurfaceSamples = NULL);
 
     // Draw sample points (internal sample means sample that was cut away by atom)
     void drawSamples(
@@ -44,6 +44,7 @@ uniform vec3 hotColor;
 uniform vec3 coldColor;
 uniform vec3 internalColor;
 uniform int frame;
+uniform int trajectoryWindowStart = 0; // first frame of trajectory on GPU
 uniform int atomCount;
 uniform int smoothAnimationRadius;
 uniform float smoothAnimationMaxDeviation;
@@ -64,7 +65,7 @@ void accumulateCenter(
     inout int accCount)
 {
     // Extract center at that frame
-    Position position = trajectory[(accFrame*atomCount) + atomIndex];
+    Position position = trajectory[((accFrame - trajectoryWindowStart)*atomCount) + atomIndex];
     vec3 center = vec3(position.x, position.y, position.z);
 
     // Check whether center is not too far away
@@ -81,7 +82,7 @@ void main()
 {
     // Extract center at frame which is given. Unlike hull shader, here are atom indices directly given by vertex id
     atomIndex = int(gl_VertexID); // write it to global variable
-    Position position = trajectory[(frame*atomCount) + atomIndex];
+    Position position = trajectory[((frame - trajectoryWindowStart)*atomCount) + atomIndex];
     centerAtFrame = vec3(position.x, position.y, position.z); // write it to global variable
 
     // Calculate loop bounds for smoothing
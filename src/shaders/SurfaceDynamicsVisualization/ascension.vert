@@ -41,6 +41,7 @@ layout(std430, binding = 5) restrict readonly buffer AscensionBuffer
 uniform float probeRadius;
 uniform int selectedIndex = 0;
 uniform int frame;
+uniform int trajectoryWindowStart = 0; // first frame of trajectory on GPU
 uniform int atomCount;
 uniform int smoothAnimationRadius;
 uniform float smoothAnimationMaxDeviation;
@@ -61,7 +62,7 @@ void accumulateCenter(
     inout int accCount)
 {
     // Extract center at that frame
-    Position position = trajectory[(accFrame*atomCount) + atomIndex];
+    Position position = trajectory[((accFrame - trajectoryWindowStart)*atomCount) + atomIndex];
     vec3 center = vec3(position.x, position.y, position.z);
 
     // Check whether center is not too far away
@@ -78,7 +79,7 @@ void main()
 {
     // Extract center at frame which is given. Unlike hull shader, here are atom indices directly given by vertex id
     atomIndex = int(gl_VertexID); // write it to global variable
-    Position position = trajectory[(frame*atomCount) + atomIndex];
+    Position position = trajectory[((frame - trajectoryWindowStart)*atomCount) + atomIndex];
     centerAtFrame = vec3(position.x, position.y, position.z); // write it to global variable
 
     // Calculate loop bounds for smoothing
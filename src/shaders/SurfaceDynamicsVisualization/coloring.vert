@@ -52,6 +52,7 @@ layout(binding = 7, r32ui) readonly restrict uniform uimageBuffer Indices;
 uniform float probeRadius;
 uniform int selectedIndex = 0;
 uniform int frame;
+uniform int trajectoryWindowStart = 0; // first frame of trajectory on GPU
 uniform int atomCount;
 uniform int smoothAnimationRadius;
 uniform float smoothAnimationMaxDeviation;
@@ -71,7 +72,7 @@ void accumulateCenter(
     inout int accCount)
 {
     // Extract center at that frame
-    Position position = trajectory[(accFrame*atomCount) + atomIndex];
+    Position position = trajectory[((accFrame - trajectoryWindowStart)*atomCount) + atomIndex];
     vec3 center = vec3(position.x, position.y, position.z);
 
     // Check whether center is not too far away
@@ -88,7 +89,7 @@ void main()
 {
     // Extract center at frame which is given
     atomIndex = int(imageLoad(Indices, int(gl_VertexID)).x); // write it to global variable
-    Position position = trajectory[(frame*atomCount) + atomIndex];
+    Position position = trajectory[((frame - trajectoryWindowStart)*atomCount) + atomIndex];
     centerAtFrame = vec3(position.x, position.y, position.z); // write it to global variable
 
     // Calculate loop bounds for smoothing
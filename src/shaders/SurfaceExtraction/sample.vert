@@ -31,6 +31,7 @@ layout(binding = 3, r32ui) restrict readonly uniform uimageBuffer Classification
 // ## Uniforms
 uniform int sampleCount;
 uniform int frame;
+uniform int trajectoryWindowStart = 0; // first frame of trajectory on GPU
 uniform int atomCount;
 uniform int integerCountPerSample;
 uniform int localFrame;
@@ -47,7 +48,7 @@ void main()
     int sampleIndex = int(gl_VertexID) - (atomIndex * sampleCount);
 
     // Calculate position
-    Position atomPosition = trajectory[(frame*atomCount) + atomIndex];
+    Position atomPosition = trajectory[((frame - trajectoryWindowStart)*atomCount) + atomIndex];
     Position relativeSamplePosition = relativePosition[(atomIndex * sampleCount) + sampleIndex];
     gl_Position = vec4(
         atomPosition.x + relativeSamplePosition.x,